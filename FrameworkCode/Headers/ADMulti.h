@@ -2,8 +2,39 @@
 #define ADMULTI
 // ADMulti.h
 // Setup up ADC0 to convert up to 4 channels using SS2
+// or any of AIN0-11 on any sequencer of ADC0 & ADC1
 
 #include <stdint.h>
+#include <stdbool.h>
+
+// values for the ADC0 sample averaging control register (2^n conversions)
+typedef enum
+{
+  ADC_HW_AVG_OFF = 0,
+  ADC_HW_AVG_2X,
+  ADC_HW_AVG_4X,
+  ADC_HW_AVG_8X,
+  ADC_HW_AVG_16X,
+  ADC_HW_AVG_32X,
+  ADC_HW_AVG_64X
+}ADC_HWAverage_t;
+
+// the two A/D modules on the TM4C123
+typedef enum
+{
+  ADC_MODULE_0 = 0,
+  ADC_MODULE_1,
+  ADC_NUM_MODULES
+}ADC_Module_t;
+
+// values for the ADCPC sample rate field
+typedef enum
+{
+  ADC_RATE_125K = 0x1,
+  ADC_RATE_250K = 0x3,
+  ADC_RATE_500K = 0x5,
+  ADC_RATE_1M   = 0x7
+}ADC_SampleRate_t;
 
 // initialize the A/D converter to convert on 1-4 channels
 void ADC_MultiInit(uint8_t HowMany);
@@ -17,4 +48,43 @@ void ADC_MultiInit(uint8_t HowMany);
 // lowest numbered converted channel is in data[0]
 
 void ADC_MultiRead(uint32_t data[4]);
+
+// set the hardware averaging applied to every conversion
+void ADC_MultiSetHWAverage(ADC_HWAverage_t HowMany);
+
+// put a list of AIN channels (0-11) on one sequencer of one module
+bool ADC_ConfigSequence(ADC_Module_t Module, uint8_t Sequencer,
+                        const uint8_t Channels[], uint8_t HowMany);
+
+// software trigger one sequencer and busy-wait for its results
+bool ADC_ReadSequence(ADC_Module_t Module, uint8_t Sequencer, uint32_t data[]);
+
+// trigger a sequencer on each module with one GSYNC so they sample together
+bool ADC_ReadSimultaneous(uint8_t Seq0, uint32_t data0[],
+                          uint8_t Seq1, uint32_t data1[]);
+
+// set the maximum conversion rate of a module
+void ADC_SetSampleRate(ADC_Module_t Module, ADC_SampleRate_t Rate);
+
+// called from the comparator interrupt when the watched input leaves its
+// band, WentHigh says which way it went
+typedef void ADC_WatchFunc_t(bool WentHigh);
+
+// watch one AIN channel (0-11) with the digital comparators of ADC1
+bool ADC_WatchInit(uint8_t Channel, ADC_HWAverage_t HowMany,
+                   ADC_WatchFunc_t *pFunc);
+
+// arm the watch to trip once, at Center + Band or Center - Band
+void ADC_WatchSetBand(uint16_t Center, uint16_t Band);
+
+// how many times the watch has tripped, for checking event rates
+uint32_t ADC_WatchGetTrips(void);
+
+// ADC1 sequence 0 interrupt, the comparators report through it
+void ADCWatchHandler(void);
+
+#ifdef ES_HOST_BUILD
+// the host model of the comparators, see ADMultiHost.c, is fed from here
+void ADC_WatchHostSample(uint16_t Sample);
+#endif
 #endif
@@ -0,0 +1,22 @@
+/****************************************************************************
+
+Header file for the shared debounce engine
+based on the Gen 2 Events and Service Framework
+****************************************************************************/
+
+#ifndef Debounce_H
+#define Debounce_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// time between samples; an input must read the same for 4 samples in a row
+// (40mS at 10mS) before its new state is believed
+#define DB_SAMPLE_MS 10
+
+//Public Function Prototypes
+void DB_Init(void);
+bool CheckDebouncedInputs(void);
+void DB_InputsChanged(uint8_t Port, uint8_t Changed, uint8_t Snapshot);
+
+#endif /* Debounce_H */
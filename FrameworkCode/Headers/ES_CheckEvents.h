@@ -9,6 +9,8 @@
  History
  When           Who     What/Why
  -------------- ---     --------
+ 10/19/26 14:00 ston     added the checker statistics
+ 10/19/26 13:00 ston     added the input scan functions
  08/05/13 15:19 jec      modifications to suit new portable type definitions
  01/15/12 12:00 jec      new header for local types
  10/16/11 17:17 jec      started coding
@@ -23,6 +25,22 @@ typedef bool CheckFunc (void);
 
 typedef CheckFunc (*pCheckFunc);
 
+// called from the input scan with the bits of Port that changed (within
+// the handler's mask) and the new value of the whole port
+typedef void ScanHandler_t (uint8_t Port, uint8_t Changed, uint8_t Snapshot);
+
+// per checker counts kept by the checker scheduler
+typedef struct
+{
+  uint32_t Calls;   // times the checker was run
+  uint32_t Hits;    // times it returned true
+}ES_CheckerStats_t;
+
 bool ES_CheckUserEvents(void);
+bool ES_GetCheckerStats(uint8_t Which, ES_CheckerStats_t *pStats);
+uint32_t ES_GetCheckerBudgetOverruns(void);
+void ES_InitInputScan(void);
+uint8_t ES_GetInputSnapshot(uint8_t Port);
+uint32_t ES_GetInputPortBase(uint8_t Port);
 
 #endif  // ES_CheckEvents_H
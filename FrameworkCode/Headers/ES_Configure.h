@@ -9,6 +9,30 @@
  History
  When           Who     What/Why
  -------------- ---     --------
+ 10/20/26 18:00  ston    the liveness limits are listed with the budgets
+ 10/20/26 16:00  ston    the timers name their services by the symbolic
+                         service numbers
+ 10/20/26 15:00  ston    GameManager & EnergyProduction queues sized to
+                         their EventFlow.py bounds
+ 10/20/26 09:00  ston    ES_MULTI_INSTANCE needs the host build
+ 10/19/26 23:59  ston    added the flight recorder switch
+ 10/19/26 23:58  ston    added the run budgets for the liveness monitor
+ 10/19/26 23:56  ston    added the urgent & background event levels
+ 10/19/26 23:52  ston    CheckSolarPanelPosition left the event checkers, the
+                         ADC1 comparators watch the panel instead
+ 10/19/26 23:50  ston    added the SmokeTowerIR service & its events, PA2 is
+                         no longer debounced so port A left the input scan
+ 10/19/26 23:45  ston    added the short timer pool size
+ 10/19/26 22:00  ston    timers name the service they post to by number
+                         instead of its post function
+ 10/19/26 18:00  ston    added the optional batch dispatch size
+ 10/19/26 17:00  ston    added the optional framework instances
+ 10/19/26 15:00  ston    added the optional preemption threshold & latency
+                         statistics
+ 10/19/26 14:00  ston    added the event checker periods & budget
+ 10/19/26 13:00  ston    added the input scan port & change handler lists
+ 10/19/26 12:00  ston    ButtonDebounce service & its timers replaced by the
+                         shared Debounce module's event checker
  11/12/18 10:01  ston    Added in 1 service (MeatSwitch) and 1 SM (SolarPanel)
                          and respective events
  12/19/16 20:19  jec     removed EVENT_CHECK_HEADER definition. This goes with
@@ -50,7 +74,13 @@
 // the name of the run function
 #define SERV_0_RUN RunGameManager
 // How big should this services Queue be?
-#define SERV_0_QUEUE_SIZE 5
+// Tools/EventFlow.py bounds it at 20: the three game services, the input
+// checkers and three timers post to it, and as the lowest priority it
+// runs last. Its USERMVT_DETECTEDs go to the background queue, see
+// ES_BACKGROUND_QUEUE_SIZE
+#define SERV_0_QUEUE_SIZE 20
+// the service's number, for routing the timers below
+#define GAME_MANAGER_SERVICE 0
 
 /****************************************************************************/
 // The following sections are used to define the parameters for each of the
@@ -66,7 +96,12 @@
 // the name of the run function
 #define SERV_1_RUN RunEnergyProductionSM
 // How big should this services Queue be?
-#define SERV_1_QUEUE_SIZE 3
+// Tools/EventFlow.py bounds it at 6: three periodic timers, the smoke
+// tower and GameManager. The panel watch's ES_SOLARPOS_CHANGE is
+// background
+#define SERV_1_QUEUE_SIZE 6
+// the service's number, for routing the timers below
+#define ENERGY_PRODUCTION_SERVICE 1
 #endif
 
 /****************************************************************************/
@@ -80,6 +115,8 @@
 #define SERV_2_RUN RunVotingGame
 // How big should this services Queue be?
 #define SERV_2_QUEUE_SIZE 5
+// the service's number, for routing the timers below
+#define VOTING_GAME_SERVICE 2
 #endif
 
 /****************************************************************************/
@@ -93,32 +130,38 @@
 #define SERV_3_RUN RunMeatSwitchDebounceSM
 // How big should this services Queue be?
 #define SERV_3_QUEUE_SIZE 5
+// the service's number, for routing the timers below
+#define MEAT_SWITCH_SERVICE 3
 #endif
 
 /****************************************************************************/
 // These are the definitions for Service 4
 #if NUM_SERVICES > 4
 // the header file with the public function prototypes
-#define SERV_4_HEADER "ButtonDebounce.h"
+#define SERV_4_HEADER "SunMovement.h"
 // the name of the Init function
-#define SERV_4_INIT InitButtonDebounce
+#define SERV_4_INIT InitSunMovement
 // the name of the run function
-#define SERV_4_RUN RunButtonDebounce
+#define SERV_4_RUN RunSunMovement
 // How big should this services Queue be?
 #define SERV_4_QUEUE_SIZE 5
+// the service's number, for routing the timers below
+#define SUN_MOVEMENT_SERVICE 4
 #endif
 
 /****************************************************************************/
 // These are the definitions for Service 5
 #if NUM_SERVICES > 5
 // the header file with the public function prototypes
-#define SERV_5_HEADER "SunMovement.h"
+#define SERV_5_HEADER "SmokeTowerIR.h"
 // the name of the Init function
-#define SERV_5_INIT InitSunMovement
+#define SERV_5_INIT InitSmokeTowerIR
 // the name of the run function
-#define SERV_5_RUN RunSunMovement
+#define SERV_5_RUN RunSmokeTowerIR
 // How big should this services Queue be?
-#define SERV_5_QUEUE_SIZE 5
+#define SERV_5_QUEUE_SIZE 3
+// the service's number, for routing the timers below
+#define SMOKE_TOWER_SERVICE 5
 #endif
 
 /****************************************************************************/
@@ -275,8 +318,6 @@ typedef enum
   VOTED_YES,
   VOTED_NO,
   SWITCH_HIT,
-  BUTTON_DOWN,
-  BUTTON_UP,
   DB_MEAT_SWITCH_DOWN,
   DB_MEAT_SWITCH_UP,
   ES_TOWER_PLUGGED,
@@ -284,6 +325,8 @@ typedef enum
   ES_AUDIO_END,
   ES_SOLARPOS_CHANGE,
   ES_MOVE_SUN,
+  ES_IR_EDGES,              /* the PA2 interrupt has stamped edges */
+  NUM_ES_EVENTS             /* keep last, sizes the ES_StateTable cells */
 } ES_EventType_t;
 
 
@@ -319,35 +362,128 @@ typedef enum
 
 /****************************************************************************/
 // This is the list of event checking functions
-#define EVENT_CHECK_LIST CheckLEAFInsertion, CheckButtonPress, Check4Keystroke, CheckMeatSwitchEvents, CheckSolarPanelPosition, CheckSmokeTowerEvents
+#define EVENT_CHECK_LIST CheckDebouncedInputs, Check4Keystroke
+// How often each checker above is run, in timer ticks and in the same order.
+// 0 runs it on every pass. Leave undefined to run every checker every pass
+#define EVENT_CHECK_PERIODS 0, 10
+// Optional limit, in uS, on the time one pass spends in the checkers. The
+// checkers it does not get to go first on the next pass
+#define EVENT_CHECK_BUDGET_US 200
+
+/****************************************************************************/
+// Services numbered at or above ES_PREEMPT_THRESHOLD are run from the PendSV
+// exception as soon as an event is posted to them, preempting the run
+// function of any lower numbered service, rather than waiting for ES_Run to
+// get back round. Their run functions must not share data with the lower
+// services except through posts or EnterCritical/ExitCritical. Leave
+// undefined to run every service from ES_Run. 4 would preempt for
+// SunMovement's profile ticks
+//#define ES_PREEMPT_THRESHOLD 4
+// Uncomment to keep the worst post to run function latency of each service,
+// see ES_GetWorstLatency
+// and the longest the timer tick has taken, see ES_Timer_GetWorstTickUS
+//#define ES_LATENCY_STATS
+
+/****************************************************************************/
+// Optional: ES_Run runs up to this many events from the same queue before
+// it processes the pending ints and searches Ready again. It still stops
+// early for a post to a higher priority service. Timer ticks are handled
+// between batches, so keep it small enough that a batch fits in a tick.
+// Leave undefined to handle one event at a time
+//#define ES_BATCH_DISPATCH_SIZE 4
+
+/****************************************************************************/
+// Liveness monitor, Tiva only: the longest each service's run function may
+// take, in timer ticks, in service order. The tick interrupt checks the
+// running services against these and feeds the watchdog only while every one
+// is within its budget. A service that overruns has the service & event
+// saved in a crash record, see ES_GetCrashRecord, and the watchdog resets
+// the exhibit. 0 gives a service no budget of its own, it then only has to
+// return within the watchdog's 100mS. Comment out to turn it off.
+// The watchdog is also only fed while ES_Run keeps going round, so a hang
+// in an event checker resets the exhibit too, without a crash record. A
+// service that is starved by busier higher priority ones is not acted on,
+// see ES_LivenessLastProgress
+#define ES_RUN_BUDGET_LIST 50, 50, 20, 20, 10, 10
+
+/****************************************************************************/
+// Flight recorder, Tiva only: ES_Run logs the last 256 dispatches, with the
+// state each service was left in, in RAM that survives a soft reset. See
+// ES_FlightRecorderDump & Tools/FlightLog.py. Comment out to turn it off
+#define ES_RECORD_DISPATCHES
+
 /****************************************************************************/
-// These are the definitions for the post functions to be executed when the
-// corresponding timer expires. All 16 must be defined. If you are not using
-// a timer, then you should use TIMER_UNUSED
+// Each service also gets an urgent and a background queue beside its normal
+// one. Events of the types in the urgent list go to the urgent queue, and
+// are run before anything in the normal queue; those in the background list
+// wait until the normal queue is empty. Everything else is normal. Comment
+// out both lists to give each service the one queue
+#define ES_URGENT_EVENT_LIST RESET_ALL_GAMES, LEAF_REMOVED
+#define ES_BACKGROUND_EVENT_LIST USERMVT_DETECTED, ES_SOLARPOS_CHANGE
+// the size of every service's urgent & background queues. Tools/EventFlow.py
+// bounds each level of each service: the urgent ones at 2, and
+// GameManager's background queue at 20, for the USERMVT_DETECTED every game
+// posts to it
+#define ES_URGENT_QUEUE_SIZE 2
+#define ES_BACKGROUND_QUEUE_SIZE 20
+
+/****************************************************************************/
+// Host builds only (needs ES_HOST_BUILD, and ES_HostPort.c in place of
+// ES_Port.c): keep the framework's queues, Ready bits & timers, and each
+// service's ES_SERVICE_DATA, per instance, so one process can run many
+// exhibits. See ES_CreateInstance & ES_SelectInstance. ES_HostRunInstances
+// steps the instances in turn with ES_RunStep, ES_HostRun is not
+// available. The event checkers and the hardware libraries are still
+// shared by every instance
+//#define ES_MULTI_INSTANCE
+
+/****************************************************************************/
+// These ports are read once at the top of every ES_CheckUserEvents pass,
+// before any of the event checkers run. Checkers use the snapshot, from
+// ES_GetInputSnapshot(SCAN_PORT_x), instead of reading the port themselves.
+// Comment out INPUT_SCAN_PORT_LIST to turn the input scan off
+#define INPUT_SCAN_PORT_LIST GPIO_PORTB_BASE, GPIO_PORTD_BASE, GPIO_PORTF_BASE
+// the index of each port in the list above
+#define SCAN_PORT_B 0
+#define SCAN_PORT_D 1
+#define SCAN_PORT_F 2
+#define NUM_SCAN_PORTS 3
+// Change handlers, { port, bit mask, handler }. A handler is called from the
+// scan with the bits under its mask that differ from the last snapshot.
+// Debounce keeps its own pin masks, so it takes every bit of its ports
+#define INPUT_SCAN_HANDLER_LIST \
+  { SCAN_PORT_B, 0xFF, DB_InputsChanged }, \
+  { SCAN_PORT_D, 0xFF, DB_InputsChanged }
+/****************************************************************************/
+// These are the services, by number, whose queues get the ES_TIMEOUT when
+// the corresponding timer expires. All 16 must be defined. If you are not
+// using a timer, then you should use TIMER_UNUSED. Use the service numbers
+// defined with the services above, so the timers follow a service that is
+// moved to another number, and naming one that is not configured is an error
 // Unlike services, any combination of timers may be used and there is no
 // priority in servicing them
-#define TIMER_UNUSED ((pPostFunc)0)
-#define TIMER0_RESP_FUNC PostGameManager
-#define TIMER1_RESP_FUNC PostGameManager
-#define TIMER2_RESP_FUNC PostGameManager
-#define TIMER3_RESP_FUNC PostVotingGame
-#define TIMER4_RESP_FUNC PostButtonDebounce
-#define TIMER5_RESP_FUNC PostButtonDebounce
-#define TIMER6_RESP_FUNC PostButtonDebounce
-#define TIMER7_RESP_FUNC PostMeatSwitchDebounce
-#define TIMER8_RESP_FUNC PostEnergyProduction
-#define TIMER9_RESP_FUNC PostEnergyProduction
-#define TIMER10_RESP_FUNC PostEnergyProduction
-#define TIMER11_RESP_FUNC TIMER_UNUSED
-#define TIMER12_RESP_FUNC TIMER_UNUSED
-#define TIMER13_RESP_FUNC TIMER_UNUSED
-#define TIMER14_RESP_FUNC TIMER_UNUSED
-#define TIMER15_RESP_FUNC TIMER_UNUSED
+#define TIMER_UNUSED MAX_NUM_SERVICES
+#define TIMER0_SERVICE GAME_MANAGER_SERVICE
+#define TIMER1_SERVICE GAME_MANAGER_SERVICE
+#define TIMER2_SERVICE GAME_MANAGER_SERVICE
+#define TIMER3_SERVICE VOTING_GAME_SERVICE
+#define TIMER4_SERVICE TIMER_UNUSED
+#define TIMER5_SERVICE TIMER_UNUSED
+#define TIMER6_SERVICE TIMER_UNUSED
+#define TIMER7_SERVICE TIMER_UNUSED
+#define TIMER8_SERVICE ENERGY_PRODUCTION_SERVICE
+#define TIMER9_SERVICE ENERGY_PRODUCTION_SERVICE
+#define TIMER10_SERVICE ENERGY_PRODUCTION_SERVICE
+#define TIMER11_SERVICE TIMER_UNUSED
+#define TIMER12_SERVICE TIMER_UNUSED
+#define TIMER13_SERVICE TIMER_UNUSED
+#define TIMER14_SERVICE TIMER_UNUSED
+#define TIMER15_SERVICE TIMER_UNUSED
 
 /****************************************************************************/
 // Give the timer numbers symbolc names to make it easier to move them
 // to different timers if the need arises. Keep these definitions close to the
-// definitions for the response functions to make it easier to check that
+// definitions for the timer services to make it easier to check that
 // the timer number matches where the timer event will be routed
 // These symbolic names should be changed to be relevant to your application
 
@@ -355,12 +491,18 @@ typedef enum
 #define USER_INPUT_TIMER 1
 #define GAME_END_TIMER 2
 #define VOTE_TIMER 3
-#define BUTTON_TIMER 4
-#define DEBOUNCE_TIMER 7
 #define SUN_POSITION_TIMER 8
 #define COAL_ACTIVE_TIMER 9
 #define SOLAR_ACTIVE_TIMER 10
 
+/****************************************************************************/
+// The number of uS timers in the ES_ShortTimerPool, numbered from 0. Each
+// one can post its ES_SHORT_TIMEOUT to any service
+#define SHORT_TIMER_POOL_SIZE 16
+
+// pool timer numbers, like the timer names above
+#define SMOKE_TOWER_IR_TIMER 0
+
 /**************************************************************************/
 // uncomment this ine to get some basic framework operation debugging on
 // PF1 & PF2
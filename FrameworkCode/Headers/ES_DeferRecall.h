@@ -26,7 +26,7 @@
 
 /****************************************************************************
  Function
-   ES_DeferEvent  (wrapper for ES_EnQueueLIFO)
+   ES_DeferEvent  (wrapper for ES_EnQueueFIFO)
    this is a straight re-naming to aid readability
  Parameters
    ES_Event * pBlock : pointer to the block of memory in use as the Queue
@@ -34,9 +34,24 @@
  Returns
    bool : true if the add was successful, false if not
  Description
-   if it will fit, adds Event2Add to the Queue
+   if it will fit, adds Event2Add to the end of the Queue, so the events
+   are recalled in the order they were deferred. A failed add is counted,
+   see ES_DeferOverflows
  ***************************************************************************/
-#define ES_DeferEvent(a, b) ES_EnQueueLIFO(a, b)
+#define ES_DeferEvent(a, b) ES_EnQueueFIFO(a, b)
+
+/****************************************************************************
+ Function
+   ES_DeferOverflows  (wrapper for ES_QueueOverflows)
+   this is a straight re-naming to aid readability
+ Parameters
+   ES_Event * pBlock : pointer to the block of memory in use as the Queue
+ Returns
+   uint8_t : the number of events that did not fit, up to 255
+ Description
+   for sizing the deferral queue
+ ***************************************************************************/
+#define ES_DeferOverflows(a) ES_QueueOverflows(a)
 
 /****************************************************************************
  Function
@@ -48,14 +63,36 @@
  Returns
      bool true if an event was recalled, false if no event was left in queue
  Description
-     pulls an event off the deferral queue if one is available. It there was
-     something in the queue, then it posts it LIFO fashion to the queue
-     indicated by WhichService
+     moves the deferred events to the front of the queue indicated by
+     WhichService, ahead of anything already posted to it, in the order
+     they were deferred
  Notes
-     None.
+     any that do not fit in the service's queue stay deferred. With the
+     queue levels each goes to the front of its own level's queue
  Author
      J. Edward Carryer, 11/20/13 16:49
 ****************************************************************************/
 bool ES_RecallEvents(uint8_t WhichService, ES_Event_t *pBlock);
 
+/****************************************************************************
+ Function
+     ES_RecallEventsOfType
+ Parameters
+      uint8_t WhichService, number of the service to post Recalled event to
+      ES_Event * pBlock, pointer to the block of memory that implements the
+        Defer/Recall queue
+      ES_EventType_t WhichType, the type of event to recall
+ Returns
+     bool true if an event was recalled, false if none of that type was left
+ Description
+     as ES_RecallEvents, but only for events of WhichType, the others stay
+     deferred in their order
+ Notes
+     None.
+ Author
+     Sander Tonkens, 10/19/26, 23:54
+****************************************************************************/
+bool ES_RecallEventsOfType(uint8_t WhichService, ES_Event_t *pBlock,
+    ES_EventType_t WhichType);
+
 #endif
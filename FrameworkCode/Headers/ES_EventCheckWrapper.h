@@ -9,6 +9,7 @@
  History
  When           Who     What/Why
  -------------- ---     --------
+ 10/19/26 12:00 ston     Debounce replaces the ButtonDebounce checkers
  12/19/16 20:12 jec      Started coding
 *****************************************************************************/
 
@@ -17,7 +18,7 @@
 
 // This is the header for the event checkers for the template project
 #include "GameManager.h"
-#include "ButtonDebounce.h"
+#include "Debounce.h"
 #include "EventCheckers.h"
 #include "VotingGame.h"
 #include "MeatSwitchDebounce.h"
@@ -0,0 +1,45 @@
+// header file for the ES_FlightRecorder library, a circular log of the last
+// ES_FLIGHT_RECORDER_SIZE events dispatched by ES_Run, kept through a reset
+
+#ifndef ES_FlightRecorder_H
+#define ES_FlightRecorder_H
+#include <stdint.h>
+#include <stdbool.h>
+#include "ES_Configure.h"
+#include "ES_Events.h"
+
+// the recorder is only there on the Tiva, with ES_RECORD_DISPATCHES
+// configured
+#if defined(ES_RECORD_DISPATCHES) && !defined(ES_HOST_BUILD)
+#define ES_FLIGHT_RECORDER
+
+// the log is indexed by a uint8_t that wraps, so this can not be changed
+#define ES_FLIGHT_RECORDER_SIZE 256
+
+// Service of the record written at start up after a reset, and State of a
+// record whose service did not call ES_FlightRecordState
+#define ES_RECORD_RESET 0xFF
+#define ES_NO_STATE 0xFF
+
+// one dispatch, 8 bytes
+typedef struct
+{
+  uint16_t  Tick;       // _HW_GetTickCount when it was dispatched
+  uint16_t  EventParam;
+  uint8_t   Service;    // the service it was dispatched to
+  uint8_t   EventType;
+  uint8_t   State;      // the service's state after the run function
+  uint8_t   Error;      // true if the run function returned an error
+}ES_FlightRecord_t;
+
+void ES_FlightRecorderInit(void);
+uint16_t ES_FlightRecordStart(uint8_t WhichService, ES_Event_t ThisEvent);
+void ES_FlightRecordEnd(uint16_t Outer, bool Error);
+void ES_FlightRecordState(uint8_t State);
+void ES_FlightRecorderDump(void);
+#else
+// so the services can note their state whether or not there is a recorder
+#define ES_FlightRecordState(State)
+#endif
+
+#endif //ES_FlightRecorder_H
@@ -8,6 +8,20 @@
  History
  When           Who     What/Why
  -------------- ---     --------
+ 10/21/26 17:00 ston     ES_SERVICE_DATA goes through ES_GetServiceData,
+                         the executor's header comes after the instances
+ 10/21/26 12:00 ston     ES_RunPreemptive & ES_GetWorstLatency are only
+                         declared when their options are on
+ 10/20/26 14:30 ston     the dispatch functions are only declared in the host
+                         build, where they are defined
+ 10/20/26 10:00 ston     added ES_PORT_DATA_SLOT
+ 10/19/26 23:59 ston     include ES_FlightRecorder.h
+ 10/19/26 23:58 ston     include ES_Liveness.h
+ 10/19/26 23:54 ston     added ES_SpliceToService
+ 10/19/26 22:00 ston     added ES_EnQueueToService & ES_MarkServicesReady
+ 10/19/26 17:00 ston     added ES_RunStep and the framework instances
+ 10/19/26 16:00 ston     added the host executor's dispatch functions
+ 10/19/26 15:00 ston     added ES_RunPreemptive & ES_GetWorstLatency
  11/02/13 17:06 jec      added ES_PostToServiceLIFO prototype
  08/05/13 15:00 jec      added #include for ES_Port.h to get portability stuff
  10/17/06 07:41 jec      started coding
@@ -28,6 +42,8 @@
 #include "ES_PostList.h"
 #include "ES_General.h"
 #include "ES_Timers.h"
+#include "ES_Liveness.h"
+#include "ES_FlightRecorder.h"
 
 typedef enum
 {
@@ -41,8 +57,55 @@ typedef enum
 
 ES_Return_t ES_Initialize(TimerRate_t NewRate);
 ES_Return_t ES_Run(void);
+ES_Return_t ES_RunStep(void);
 bool ES_PostAll(ES_Event_t ThisEvent);
 bool ES_PostToService(uint8_t WhichService, ES_Event_t ThisEvent);
 bool ES_PostToServiceLIFO(uint8_t WhichService, ES_Event_t TheEvent);
+bool ES_EnQueueToService(uint8_t WhichService, ES_Event_t TheEvent);
+void ES_MarkServicesReady(uint16_t ServiceMask);
+uint8_t ES_SpliceToService(uint8_t WhichService, ES_Event_t *pFrom,
+    ES_EventType_t Match);
+#ifdef ES_PREEMPT_THRESHOLD
+void ES_RunPreemptive(void);
+#endif
+#ifdef ES_LATENCY_STATS
+uint32_t ES_GetWorstLatency(uint8_t WhichService);
+#endif
+
+#ifdef ES_HOST_BUILD
+// for the host executor only
+bool ES_DispatchService(uint8_t WhichService);
+bool ES_ServiceHasEvents(uint8_t WhichService);
+#endif
+
+#ifdef ES_MULTI_INSTANCE
+#include <stddef.h>
+// the per instance data slots: one for each service, then the timers', then
+// the host port's count of the ticks the instance has had
+#define ES_TIMER_DATA_SLOT NUM_SERVICES
+#define ES_PORT_DATA_SLOT (NUM_SERVICES + 1)
+#define ES_NUM_DATA_SLOTS (NUM_SERVICES + 2)
+
+typedef struct ES_Instance_s ES_Instance_t;
+
+ES_Instance_t *ES_CreateInstance(void);
+void ES_DestroyInstance(ES_Instance_t *pInstance);
+void ES_SelectInstance(ES_Instance_t *pInstance);
+void *ES_GetInstanceData(uint8_t Slot, size_t Size);
+void *ES_GetServiceData(uint8_t Slot, size_t Size);
+
+// A service keeps its module variables in a struct and reaches them
+// through this: the current instance's copy with ES_MULTI_INSTANCE, or the
+// single static copy, Single, without it. It is never NULL, a service
+// that runs with no instance selected, or no memory, stops the process
+#define ES_SERVICE_DATA(Type, Service, Single) \
+  ((Type *)ES_GetServiceData((Service), sizeof(Type)))
+#else
+#define ES_SERVICE_DATA(Type, Service, Single) (&(Single))
+#endif
+
+#ifdef ES_HOST_BUILD
+#include "ES_HostExecutor.h"
+#endif
 
 #endif   // ES_Framework_H
@@ -0,0 +1,103 @@
+/****************************************************************************
+ Module
+     ES_HSM.h
+ Description
+     header file for the table driven hierarchical state machine engine, a
+     replacement for the recursive TopHSMTemplate / HSMTemplate pattern
+ Notes
+     A machine is a const array of ES_HSMState_t, one per state, indexed by
+     the state's number. Each state names its parent (ES_HSM_NO_STATE for a
+     top level state), the initial child it drills into (ES_HSM_NO_STATE for
+     a leaf), whether it returns to its last active child instead (shallow
+     history), and its entry, exit and event handler functions, any of which
+     can be NULL.
+
+     A handler returns ES_HSM_HANDLED to consume the event, ES_HSM_UNHANDLED
+     to pass it on to its parent, or the number of the state to go to. The
+     event goes to the active leaf first, then up through its ancestors.
+
+     A transition exits from the active leaf up to, not including, the least
+     common ancestor of the handling state and the target, then enters down
+     to the target and on through initial (or history) children to a leaf.
+     A transition to the handling state itself, or to one of its ancestors,
+     exits and re-enters that state. The ancestors are precomputed by
+     ES_HSMInit and no function recurses, so a transition costs one call per
+     state exited or entered and at most ES_HSM_MAX_DEPTH bytes of stack.
+
+     Entry and exit functions must not dispatch to their own machine, post
+     to the service instead.
+
+     static const ES_HSMState_t Washer[] = {
+       //  Parent           Initial child    History  Entry    Exit  Handler
+       [Off]     = { ES_HSM_NO_STATE, ES_HSM_NO_STATE, false, NULL, NULL,
+                     DuringOff },
+       [Running] = { ES_HSM_NO_STATE, Filling,         true,  NULL, NULL,
+                     DuringRunning },
+       [Filling] = { Running,         ES_HSM_NO_STATE, false, OpenValve,
+                     CloseValve, DuringFilling },
+       ...
+     };
+     ES_HSM_DEFINE(WasherSM, Washer, Off);
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/19/26 21:00 ston     started coding
+*****************************************************************************/
+
+#ifndef ES_HSM_H
+#define ES_HSM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ES_Configure.h"
+#include "ES_Events.h"
+
+// the deepest nesting of states, from a top level state down to a leaf
+#ifndef ES_HSM_MAX_DEPTH
+#define ES_HSM_MAX_DEPTH 8
+#endif
+
+// state numbers run from 0, these are never state numbers
+#define ES_HSM_NO_STATE   0xFF
+#define ES_HSM_UNHANDLED  0xFF
+#define ES_HSM_HANDLED    0xFE
+
+typedef void ES_HSMAction_t(ES_Event_t ThisEvent);
+typedef uint8_t ES_HSMHandler_t(ES_Event_t ThisEvent);
+
+typedef struct
+{
+  uint8_t         Parent;        // ES_HSM_NO_STATE at the top level
+  uint8_t         InitialChild;  // ES_HSM_NO_STATE for a leaf
+  bool            HasHistory;    // re-enter the last active child
+  ES_HSMAction_t  *pEntry;
+  ES_HSMAction_t  *pExit;
+  ES_HSMHandler_t *pHandler;
+} ES_HSMState_t;
+
+typedef struct
+{
+  const ES_HSMState_t *pStates;
+  uint8_t             NumStates;
+  uint8_t             InitialState;  // top level state entered by ES_HSMStart
+  uint8_t             *pLCA;         // [NumStates][NumStates], by ES_HSMInit
+  uint8_t             *pHistory;     // last active child of each state
+  uint8_t             Current;       // the active leaf
+} ES_HSM_t;
+
+// defines a static ES_HSM_t called Machine, with its own working storage,
+// for the state array States starting in top level state Initial
+#define ES_HSM_DEFINE(Machine, States, Initial)                             \
+  static uint8_t Machine##_LCA[sizeof(States) / sizeof(States[0])]          \
+                              [sizeof(States) / sizeof(States[0])];         \
+  static uint8_t Machine##_History[sizeof(States) / sizeof(States[0])];     \
+  static ES_HSM_t Machine =                                                 \
+  { States, sizeof(States) / sizeof(States[0]), Initial,                    \
+    &Machine##_LCA[0][0], Machine##_History, ES_HSM_NO_STATE }
+
+bool ES_HSMInit(ES_HSM_t *pMachine);
+void ES_HSMStart(ES_HSM_t *pMachine, ES_Event_t ThisEvent);
+bool ES_HSMDispatch(ES_HSM_t *pMachine, ES_Event_t ThisEvent);
+bool ES_HSMIsIn(const ES_HSM_t *pMachine, uint8_t WhichState);
+
+#endif   // ES_HSM_H
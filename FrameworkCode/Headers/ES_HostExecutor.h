@@ -0,0 +1,38 @@
+/****************************************************************************
+ Module
+     ES_HostExecutor.h
+ Description
+     header file for the host only, multi-threaded replacement for ES_Run
+ Notes
+     only used when ES_HOST_BUILD is defined
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/21/26 17:00 ston     ES_HostRunInstances, the ES_Run for ES_MULTI_INSTANCE
+ 10/20/26 09:00 ston     no executor with ES_MULTI_INSTANCE
+ 10/19/26 16:00 ston     started coding
+*****************************************************************************/
+
+#ifndef ES_HostExecutor_H
+#define ES_HostExecutor_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// the most worker threads ES_HostRun will start
+#define ES_HOST_MAX_WORKERS 64
+
+// not with ES_MULTI_INSTANCE, ES_HostRunInstances steps the instances
+// with ES_RunStep instead
+#ifndef ES_MULTI_INSTANCE
+ES_Return_t ES_HostRun(uint8_t HowMany);
+void ES_HostStop(void);
+void ES_HostServiceReady(uint8_t WhichService);
+#else
+ES_Return_t ES_HostRunInstances(ES_Instance_t * const *ppInstances,
+    uint8_t HowMany, TimerRate_t Rate, uint32_t ForMS);
+#endif
+void ES_HostEnterCritical(void);
+void ES_HostExitCritical(void);
+
+#endif   // ES_HostExecutor_H
@@ -0,0 +1,36 @@
+// header file for the ES_Liveness library, which checks each service's run
+// function against its budget from the tick interrupt and feeds the watchdog
+
+#ifndef ES_Liveness_H
+#define ES_Liveness_H
+#include <stdint.h>
+#include <stdbool.h>
+#include "ES_Configure.h"
+#include "ES_Events.h"
+
+// the monitor is only there on the Tiva, with ES_RUN_BUDGET_LIST configured
+#if defined(ES_RUN_BUDGET_LIST) && !defined(ES_HOST_BUILD)
+#define ES_LIVENESS
+
+// what is saved when a run function overruns its budget. Times are in timer
+// ticks, from _HW_GetTickCount, so they wrap every 65536 ticks
+typedef struct
+{
+  uint32_t    Magic;                      // set last, marks a valid record
+  uint8_t     Service;                    // the service that overran
+  ES_Event_t  Event;                      // the event it was running
+  uint16_t    Tick;                       // when the overrun was caught
+  uint16_t    RunTicks;                   // how long it had been running
+  uint16_t    LastProgress[NUM_SERVICES]; // when each last finished a run
+}ES_CrashRecord_t;
+
+void ES_LivenessStart(void);
+void ES_LivenessEnter(uint8_t WhichService, ES_Event_t ThisEvent);
+void ES_LivenessLeave(uint8_t WhichService);
+void ES_LivenessTick(uint16_t Now);
+void ES_LivenessCheckIn(void);
+uint16_t ES_LivenessLastProgress(uint8_t WhichService);
+bool ES_GetCrashRecord(ES_CrashRecord_t *pRecord);
+#endif
+
+#endif //ES_Liveness_H
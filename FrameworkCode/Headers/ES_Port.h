@@ -9,6 +9,13 @@
  History
  When           Who     What/Why
  -------------- ---     --------
+ 10/20/26 17:00 ston    added ES_CLOCK_HZ, the one definition of the clock
+ 10/19/26 23:58 ston    added ES_NOINIT for data that survives a reset
+ 10/19/26 23:30 ston    added the 64 bit uS clock prototypes
+ 10/19/26 16:00 ston    critical regions are a mutex in the host build
+ 10/19/26 15:00 ston    critical regions become a BASEPRI priority ceiling
+                        when preemptive services are configured
+ 10/19/26 14:00 ston    added the cycle stamp prototypes
  10/26/17 18:39 jec     moves definition of ALL_BITS to here
  10/14/15 21:50 jec     added prototype for ES_Timer_GetTime
  01/18/15 13:24 jec     clean up and adapt to use TI driver lib functions
@@ -30,6 +37,7 @@
 #include "bitdefs.h"        /* generic bit defs (BIT0HI, BIT0LO,...) */
 #include "Bin_Const.h"      /* macros to specify binary constants in C */
 #include "ES_Types.h"
+#include "ES_Configure.h"   // for ES_PREEMPT_THRESHOLD
 
 // macro to control the use of C99 data types (or simulations in case you don't
 // have a C99 compiler).
@@ -62,14 +70,43 @@ extern uint32_t _PRIMASK_temp;
 uint32_t CPUgetPRIMASK_cpsid(void);
 void CPUsetPRIMASK(uint32_t newPRIMASK);
 
+#if defined(ES_HOST_BUILD)
+// on the host the services run on several threads, so a critical region is
+// a lock shared by all of them, see ES_HostExecutor.c
+void ES_HostEnterCritical(void);
+void ES_HostExitCritical(void);
+#define EnterCritical() { ES_HostEnterCritical(); }
+#define ExitCritical() { ES_HostExitCritical(); }
+#elif !defined(ES_PREEMPT_THRESHOLD)
 #define EnterCritical() { _PRIMASK_temp = CPUgetPRIMASK_cpsid(); }
 #define ExitCritical() { CPUsetPRIMASK(_PRIMASK_temp); }
+#else
+// With preemptive services the critical regions are a priority ceiling
+// rather than all interrupts off: BASEPRI only holds off the interrupts at
+// ES_KERNEL_IRQ_PRIORITY or below (SysTick, the short timers, PendSV), so
+// interrupts above it keep their latency. Any interrupt that calls into the
+// framework must be set to ES_KERNEL_IRQ_PRIORITY or lower.
+// Priorities are in the top 3 bits, 0x00 is the most urgent
+#include "driverlib/cpu.h"
+#define ES_KERNEL_IRQ_PRIORITY 0x20
+#define ES_PENDSV_PRIORITY 0xE0
+#define EnterCritical() { _PRIMASK_temp = CPUbasepriGet(); \
+                          CPUbasepriSet(ES_KERNEL_IRQ_PRIORITY); }
+#define ExitCritical() { CPUbasepriSet(_PRIMASK_temp); }
+#endif
+
+// the CPU clock that main sets up with SysCtlClockSet (PLL, divided by 5).
+// Every cycle count in the framework, the tick rates below included, is
+// worked out from this one, so a change of clock only needs changing here
+#define ES_CLOCK_HZ 40000000UL
+#define ES_CYCLES_PER_US (ES_CLOCK_HZ / 1000000UL)
+#define ES_CYCLES_PER_MS (ES_CLOCK_HZ / 1000UL)
 
 /* Rate constants for programming the SysTick Period to generate tick interrupts.
-   These assume an 40MHz configuration, they are the values to be used to program
-   the SysTick Reload Value (STRELOAD) register. STRELOAD is 24-bits wide and so
-   the highest value is 0xFFFFFF (16,777,216) which equates to
-   16777216*1000/40000000 = 419.4 mS.
+   They are the values to be used to program the SysTick Reload Value
+   (STRELOAD) register, worked out from ES_CLOCK_HZ. STRELOAD is 24-bits wide
+   and so the highest value is 0xFFFFFF (16,777,216) which, at 40MHz,
+   equates to 16777216*1000/40000000 = 419.4 mS.
    They are all listed as -1 because the actual cycle time includes 1 cycle to
    reset from the max count back to zero, so, for example, to achieve a 4000
    count cycle time, you load the register with 4000-1
@@ -77,16 +114,16 @@ void CPUsetPRIMASK(uint32_t newPRIMASK);
 typedef enum
 {
   ES_Timer_RATE_OFF   = (0),
-  ES_Timer_RATE_100uS = 4000 - 1,
-  ES_Timer_RATE_500uS = 20000 - 1,
-  ES_Timer_RATE_1mS   = 40000 - 1,
-  ES_Timer_RATE_2mS   = 80000 - 1,
-  ES_Timer_RATE_4mS   = 160000 - 1,
-  ES_Timer_RATE_5mS   = 200000 - 1,
-  ES_Timer_RATE_8mS   = 320000 - 1,
-  ES_Timer_RATE_10mS  = 400000 - 1,
-  ES_Timer_RATE_16mS  = 640000 - 1,
-  ES_Timer_RATE_32mS  = 1280000 - 1
+  ES_Timer_RATE_100uS = (ES_CYCLES_PER_US * 100) - 1,
+  ES_Timer_RATE_500uS = (ES_CYCLES_PER_US * 500) - 1,
+  ES_Timer_RATE_1mS   = (ES_CYCLES_PER_MS * 1) - 1,
+  ES_Timer_RATE_2mS   = (ES_CYCLES_PER_MS * 2) - 1,
+  ES_Timer_RATE_4mS   = (ES_CYCLES_PER_MS * 4) - 1,
+  ES_Timer_RATE_5mS   = (ES_CYCLES_PER_MS * 5) - 1,
+  ES_Timer_RATE_8mS   = (ES_CYCLES_PER_MS * 8) - 1,
+  ES_Timer_RATE_10mS  = (ES_CYCLES_PER_MS * 10) - 1,
+  ES_Timer_RATE_16mS  = (ES_CYCLES_PER_MS * 16) - 1,
+  ES_Timer_RATE_32mS  = (ES_CYCLES_PER_MS * 32) - 1
 }TimerRate_t;
 
 // map the generic functions for testing the serial port to actual functions
@@ -99,6 +136,12 @@ typedef enum
 void _HW_Timer_Init(TimerRate_t Rate);
 bool _HW_Process_Pending_Ints(void);
 uint16_t _HW_GetTickCount(void);
+uint32_t _HW_GetCycleStamp(void);
+uint32_t _HW_USSince(uint32_t Stamp);
+uint64_t _HW_GetTimeUS(void);
+uint32_t _HW_USToTicks(uint32_t US);
+void _HW_PendPreempt(void);
+bool _HW_InPreemptContext(void);
 void ConsoleInit(void);
 // and the one Framework function that we define here
 uint16_t ES_Timer_GetTime(void);
@@ -106,6 +149,16 @@ uint16_t ES_Timer_GetTime(void);
 // define the constant necessary to get at all of the bits of a port register
 #define ALL_BITS (0xff << 2)
 
+// for variables that must keep their value through a reset, such as a crash
+// record. They go in the .noinit section, which LaunchPad.sct puts in an
+// UNINIT region, so the startup code neither zeroes nor initializes them.
+// Check them for a valid pattern before use
+#if defined(ES_HOST_BUILD)
+#define ES_NOINIT
+#else
+#define ES_NOINIT __attribute__((section(".noinit"), zero_init))
+#endif
+
 // prototypes for debugging port functions
 #ifdef _INCLUDE_BASIC_FRAMEWORK_DEBUG_
 void _HW_DebugLines_Init(void);
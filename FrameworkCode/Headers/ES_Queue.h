@@ -9,6 +9,8 @@
  History
  When           Who     What/Why
  -------------- ---     --------
+ 10/21/26 11:00 ston     added ES_SpliceQueueClass
+ 10/19/26 23:54 ston     added ES_SpliceQueue & ES_QueueOverflows
  08/05/13 15:19 jec      modifications to suit new portable type definitions
  01/15/12 09:36 jec      converted to use new types from ES_Types.h
  10/17/11 07:49 jec      new header to match the rest of the framework
@@ -28,6 +30,11 @@ bool ES_EnQueueLIFO(ES_Event_t *pBlock, ES_Event_t Event2Add);
 uint8_t ES_DeQueue(ES_Event_t *pBlock, ES_Event_t *pReturnEvent);
 //void EF_FlushQueue( unsigned char * pBlock );
 bool ES_IsQueueEmpty(ES_Event_t *pBlock);
+uint8_t ES_SpliceQueue(ES_Event_t *pTo, ES_Event_t *pFrom,
+    ES_EventType_t Match);
+uint8_t ES_SpliceQueueClass(ES_Event_t *pTo, ES_Event_t *pFrom,
+    uint8_t const *pClassOf, uint8_t Class);
+uint8_t ES_QueueOverflows(ES_Event_t *pBlock);
 
 #endif /*ES_Queue_H */
 
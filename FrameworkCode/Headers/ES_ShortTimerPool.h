@@ -0,0 +1,26 @@
+// header file for the ES_ShortTimerPool library, many uS timeouts sharing
+// one free running hardware timer
+
+#ifndef ES_ShortTimerPool_H
+#define ES_ShortTimerPool_H
+#include <stdint.h>
+#include <stdbool.h>
+#include "ES_Configure.h"
+#include "ES_Port.h"
+
+// the free running count, from ES_ShortTimerPoolNow, runs at the CPU clock
+#define SHORT_TIMER_POOL_CYCLES_PER_US ES_CYCLES_PER_US
+
+// the longest timeout, in uS, about half of the counter's wrap time
+#define SHORT_TIMER_POOL_MAX_US 50000000UL
+
+void ES_ShortTimerPoolInit(void);
+bool ES_ShortTimerPoolStart(uint8_t Num, uint8_t WhichService, uint32_t US);
+bool ES_ShortTimerPoolStop(uint8_t Num);
+bool ES_ShortTimerPoolIsArmed(uint8_t Num);
+uint32_t ES_ShortTimerPoolNow(void);
+uint32_t ES_ShortTimerPoolWorstISR(uint8_t NumArmed);
+
+void ShortTimerPoolHandler(void);
+
+#endif //ES_ShortTimerPool_H
@@ -0,0 +1,85 @@
+/****************************************************************************
+ Module
+     ES_StateTable.h
+ Description
+     header file for table driven flat state machines. The transitions are
+     written once as an X-macro list and expanded at compile time into the
+     transition rows and a dense [state][event] index into them
+ Notes
+     A transition list is a macro taking two macro names, ROW and ELSE, and
+     invoking them once per transition:
+
+       ROW (Name, State, Event, Guard, Action, NextState)
+       ELSE(Name, State, Event, Guard, Action, NextState)
+
+     Name must be unique in the module (it becomes an enum constant), Guard
+     is a bool function of the event or NULL for always, Action is a void
+     function of the event or NULL for none. Each (State, Event) pair gets
+     exactly one ROW, followed directly by any ELSE rows for that same pair;
+     the guards are tried in that order and the first one that passes fires.
+     A pair listed twice under ROW silently keeps the later one, gcc flags it
+     with -Woverride-init. A table holds at most 254 rows.
+
+     #define ENERGY_ROWS(ROW, ELSE) \
+       ROW (Init2Standby, InitState, ES_INIT,    NULL,   NULL,   Standby) \
+       ROW (SunTick,      Running,   ES_TIMEOUT, IsSun,  MoveSun, Running) \
+       ELSE(CoalTick,     Running,   ES_TIMEOUT, IsCoal, TempUp,  Running)
+     ES_STATE_TABLE(EnergyTable, ENERGY_ROWS, NUM_ENERGY_STATES);
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/19/26 20:00 ston     started coding
+*****************************************************************************/
+
+#ifndef ES_StateTable_H
+#define ES_StateTable_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ES_Configure.h"
+#include "ES_Events.h"
+
+typedef bool ES_Guard_t(ES_Event_t ThisEvent);
+typedef void ES_Action_t(ES_Event_t ThisEvent);
+
+typedef struct
+{
+  ES_Guard_t  *pGuard;      // NULL to always take this row
+  ES_Action_t *pAction;     // NULL for no action
+  uint8_t     NextState;
+  bool        IsElse;       // tried only when the row before it was not taken
+} ES_StateRow_t;
+
+typedef struct
+{
+  const ES_StateRow_t *pRows;
+  const uint8_t       *pCells;   // [NumStates][NUM_ES_EVENTS], row + 1, 0 = none
+  uint8_t             NumRows;
+  uint8_t             NumStates;
+} ES_StateTable_t;
+
+// the expansions of a transition list, used by ES_STATE_TABLE
+#define ES_ROW_INDEX(Name, State, Event, Guard, Action, Next) Name,
+#define ES_ROW_DATA(Name, State, Event, Guard, Action, Next) \
+  { Guard, Action, Next, false },
+#define ES_ELSE_DATA(Name, State, Event, Guard, Action, Next) \
+  { Guard, Action, Next, true },
+#define ES_ROW_CELL(Name, State, Event, Guard, Action, Next) \
+  [State][Event] = Name + 1,
+#define ES_NO_CELL(Name, State, Event, Guard, Action, Next)
+
+// defines a static const ES_StateTable_t called Table from the transition
+// list Rows, for a machine with NumStates states numbered from 0
+#define ES_STATE_TABLE(Table, Rows, NumStates)                              \
+  enum { Rows(ES_ROW_INDEX, ES_ROW_INDEX) Table##_NUM_ROWS };               \
+  static const ES_StateRow_t Table##_Rows[] =                               \
+  { Rows(ES_ROW_DATA, ES_ELSE_DATA) };                                      \
+  static const uint8_t Table##_Cells[NumStates][NUM_ES_EVENTS] =            \
+  { Rows(ES_ROW_CELL, ES_NO_CELL) };                                        \
+  static const ES_StateTable_t Table =                                      \
+  { Table##_Rows, &Table##_Cells[0][0], Table##_NUM_ROWS, NumStates }
+
+bool ES_StateTableDispatch(const ES_StateTable_t *pTable, uint8_t *pState,
+    ES_Event_t ThisEvent);
+
+#endif   // ES_StateTable_H
@@ -14,6 +14,9 @@
  History
  When           Who	What/Why
  -------------- ---	--------
+ 10/19/26 23:30 ston timer times are 32 bits, added the uS clock prototypes
+ 10/19/26 23:00 ston added the periodic timer prototypes
+ 10/19/26 22:00 ston added prototype for ES_Timer_GetWorstTickUS
  10/13/15 20:48 jec  removed prototype for IsTimerActive, I had removed the code
                      a couple of years ago
  08/13/13 12:03 jec  added prototype for ES_Timer_Tick_Resp as part of
@@ -44,11 +47,17 @@ typedef enum
 
 void ES_Timer_Init(TimerRate_t Rate);
 void ES_Timer_Tick_Resp(void);
-ES_TimerReturn_t ES_Timer_InitTimer(uint8_t Num, uint16_t NewTime);
-ES_TimerReturn_t ES_Timer_SetTimer(uint8_t Num, uint16_t NewTime);
+ES_TimerReturn_t ES_Timer_InitTimer(uint8_t Num, uint32_t NewTime);
+ES_TimerReturn_t ES_Timer_SetTimer(uint8_t Num, uint32_t NewTime);
 ES_TimerReturn_t ES_Timer_StartTimer(uint8_t Num);
 ES_TimerReturn_t ES_Timer_StopTimer(uint8_t Num);
+ES_TimerReturn_t ES_Timer_InitPeriodic(uint8_t Num, uint32_t Period);
+uint16_t ES_Timer_GetOverruns(uint8_t Num);
+void ES_Timer_TimeoutTaken(uint8_t Num);
 uint16_t ES_Timer_GetTime(void);
+uint64_t ES_Timer_GetTimeUS(void);
+uint32_t ES_Timer_USToTicks(uint32_t US);
+uint32_t ES_Timer_GetWorstTickUS(void);
 
 #endif   /* ES_Timers_H */
 /*------------------------------ End of file ------------------------------*/
@@ -13,13 +13,14 @@ based on the Gen 2 Events and Service Framework
 #include "ES_Events.h"
 
 //TypeDefs  for the states
-typedef enum {InitEnergyGame, EnergyStandBy, CoalPowered, SolarPowered} EnergyGameState;
+typedef enum {InitEnergyGame, EnergyStandBy, CoalPowered, SolarPowered,
+              NUM_ENERGY_STATES} EnergyGameState;
 
 //Public Function Prototypes
 bool InitEnergyProduction(uint8_t Priority);
 bool PostEnergyProduction(ES_Event_t ThisEvent);
 ES_Event_t RunEnergyProductionSM(ES_Event_t ThisEvent);
-bool CheckSolarPanelPosition(void);
-bool CheckSmokeTowerEvents(void);
+void SetPanelEndStops(uint16_t AtSunrise, uint16_t AtSunset);
+uint16_t MeasurePanelEndStop(bool AtSunset);
 
 #endif /* EnergyProduction_H */
@@ -24,7 +24,6 @@ bool InitGameManager(uint8_t Priority);
 bool PostGameManager(ES_Event_t ThisEvent);
 ES_Event_t RunGameManager(ES_Event_t ThisEvent);
 
-bool CheckLEAFInsertion(void);
 
 
 #endif
@@ -12,13 +12,10 @@ based on the Gen 2 Events and Service Framework
 #include "ES_Types.h"
 #include "ES_Events.h"
 
-typedef enum {Debouncing, Ready2Sample} MeatSwitchDebounceState;
-
 typedef enum {InitMeatGame, MeatStandBy, MeatActive} MeatGameState;
 //Public Function Prototypes
 bool InitMeatSwitchDebounce(uint8_t Priority);
 bool PostMeatSwitchDebounce(ES_Event_t ThisEvent);
-bool CheckMeatSwitchEvents(void);
 ES_Event_t RunMeatSwitchDebounceSM(ES_Event_t ThisEvent);
 
 #endif /* MeatSwitchDebounce_H */
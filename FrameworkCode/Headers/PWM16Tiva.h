@@ -12,10 +12,13 @@
  History
  When           Who     What/Why
  -------------- ---     --------
+ 10/19/26       ston    added uS & servo angle functions
+ 10/19/26       ston    added the staged (batched) update functions
  06/08/17       jec     re-named to match 16 channel version at Rev2
  11/11/15       jec     converted from PWM8Tiva.h
 *****************************************************************************/
 #include <stdint.h>
+#include <stdbool.h>
 
 bool PWM_TIVA_Init(uint8_t HowMany);
 bool PWM_TIVA_SetDuty( uint8_t dutyCycle, uint8_t channel);
@@ -23,4 +26,19 @@ bool PWM_TIVA_SetPeriod( uint16_t reqPeriod, uint8_t group);
 bool PWM_TIVA_SetFreq( uint16_t reqFreq, uint8_t group);
 bool PWM_TIVA_SetPulseWidth( uint16_t NewPW, uint8_t channel);
 
+// batched updates: stage any number of changes, then commit them all
+// with one synchronized update. Commit returns the register write count
+void PWM_TIVA_BeginUpdate( void);
+bool PWM_TIVA_StageDuty( uint8_t dutyCycle, uint8_t channel);
+bool PWM_TIVA_StagePeriod( uint16_t reqPeriod, uint8_t group);
+uint8_t PWM_TIVA_CommitUpdate( void);
+
+// servo oriented functions: times in uS, angles in 0.1 degree units
+bool PWM_TIVA_SetPeriodUS( uint32_t reqPeriodUS, uint8_t group);
+bool PWM_TIVA_SetPulseWidthUS( uint16_t NewPWUS, uint8_t channel);
+bool PWM_TIVA_SetServoRange( uint8_t channel, uint16_t MinPWUS,
+                             uint16_t MaxPWUS, uint16_t RangeTenths);
+bool PWM_TIVA_SetServoAngle( uint16_t AngleTenths, uint8_t channel);
+bool PWM_TIVA_StageServoAngle( uint16_t AngleTenths, uint8_t channel);
+
 #endif //_PWM16_TIVA_H
@@ -0,0 +1,30 @@
+/****************************************************************************
+
+Header file for the smoke tower IR decoder
+based on the Gen 2 Events and Service Framework
+****************************************************************************/
+
+#ifndef SmokeTowerIR_H
+#define SmokeTowerIR_H
+
+//Event definitions
+#include "ES_Configure.h"
+#include "ES_Types.h"
+#include "ES_Events.h"
+
+// A decoded Morse letter is a leading 1 followed by one bit per element,
+// 0 for a dot and 1 for a dash, so 'A' (.-) is 0b101. SmokeTowerIRToChar
+// turns it back into a letter or digit, QuerySmokeTowerLetter gives the
+// last one the tower sent
+
+//Public Function Prototypes
+bool InitSmokeTowerIR(uint8_t Priority);
+bool PostSmokeTowerIR(ES_Event_t ThisEvent);
+ES_Event_t RunSmokeTowerIR(ES_Event_t ThisEvent);
+char SmokeTowerIRToChar(uint16_t Symbol);
+bool QuerySmokeTowerPlugged(void);
+char QuerySmokeTowerLetter(void);
+
+void SmokeTowerIRHandler(void);
+
+#endif /* SmokeTowerIR_H */
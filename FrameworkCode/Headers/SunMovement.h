@@ -12,9 +12,17 @@ based on the Gen 2 Events and Service Framework
 #include "ES_Types.h"
 #include "ES_Events.h"
 
+// the arc the sun covers, in 0.1 degree units, and the steps in one day
+#define SUN_ARC_TENTHS 1800
+#define SUN_STEPS_PER_DAY 12
+#define SUN_STEP_TENTHS (SUN_ARC_TENTHS / SUN_STEPS_PER_DAY)
+
 //Public Function Prototypes
 bool InitSunMovement(uint8_t Priority);
 bool PostSunMovement(ES_Event_t ThisEvent);
 ES_Event_t RunSunMovement(ES_Event_t ThisEvent);
+void SetSunProfileLimits(uint16_t MaxVel, uint16_t MaxAccel);
+void SetSunTarget(uint16_t Target);
+uint16_t QuerySunPosition(void);
 
 #endif /* SunMovement_H */
@@ -15,7 +15,10 @@ extern "C" {
 #include <stdio.h>
 #include <stdint.h>
 #include <stdlib.h>
+// the host build's console is plain stdio, see ES_HostPort.c
+#ifndef ES_HOST_BUILD
 #include "utils/uartstdio.h"
+#endif
 
 //#if defined(ccs)
 //#define printf	UARTprintf
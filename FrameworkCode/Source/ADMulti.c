@@ -7,7 +7,8 @@
 
  Description
    This file implements a set of functions to initialize and read up to 4 
-   A/D channels on the Tiva
+   A/D channels on the Tiva. A second, general set of functions can put any
+   of the 12 analog inputs on any of the 4 sequencers of either A/D module.
 
  Notes
   I started with ADCSWTrigger.c from Valvano's book for the basic operation
@@ -19,25 +20,69 @@
  History
  When           Who     What/Why
  -------------- ---     --------
+ 10/21/26 17:10 ston    dropped the software filter and band check, nothing
+                        has used them since the comparator watch
+ 10/19/26 23:52 ston    added the band watch on the ADC1 digital comparators
+ 10/19/26 13:05 ston    added channel map and sequence functions for all 12
+                        inputs on both modules, with synchronized sampling
+ 10/19/26 09:12 ston    added the per-channel filter stage: hardware
+                        averaging, fixed-point IIR/moving average and
+                        hysteresis band change detection
  08/22/17 17:39 jec     started the cleanup and prep to make this the
                         standard A/D libary for ME218
 ****************************************************************************/
 
 /*----------------------------- Include Files -----------------------------*/
 #include <stdint.h>
+#include <stddef.h>
+#include "inc/hw_adc.h"
 #include "inc/hw_gpio.h"
 #include "inc/hw_types.h"
 #include "inc/hw_memmap.h"
 #include "inc/hw_sysctl.h"
 #include "inc/tm4c123gh6pm.h"
+#include "inc/hw_ints.h"
+#include "driverlib/interrupt.h"
 
 #include "ADMulti.h"
+#include "BITDEFS.H"
+#include "ES_Configure.h"
+#include "ES_Port.h"
 
 /*----------------------------- Module Defines ----------------------------*/
-// None
+// maximum number of channels that ADC_MultiInit can set up
+#define MAX_NUM_CHANNELS 4
+// number of analog inputs and sequencers on the TM4C123
+#define NUM_AIN 12
+#define NUM_SEQUENCERS 4
+// distance between the register blocks of two successive sequencers
+#define SEQ_STRIDE (ADC_O_SSMUX1 - ADC_O_SSMUX0)
+// step fields are 4 bits wide in SSMUXn and SSCTLn
+#define BITS_PER_STEP 4
+#define SSCTL_END_IE (ADC_SSCTL0_END0 | ADC_SSCTL0_IE0)
+// sample rate field of ADCPC: 250K samples/sec (as used by ADC_MultiInit)
+#define ADC_PC_250K 0x3
+// the band watch: ADC1 SS0 converting the input continuously, step 0 into
+// the comparator for the bottom of the band and step 1 into the one for
+// the top
+#define WATCH_SEQ 0
+#define WATCH_LOW_DC 0
+#define WATCH_HIGH_DC 1
+#define WATCH_DC_BITS (ADC_DCISC_DCINT0 | ADC_DCISC_DCINT1)
+#define DC_STRIDE (ADC_O_DCCTL1 - ADC_O_DCCTL0)
+#define ADC_MAX_COUNT 0xFFF
+
+// which pin each analog input lives on
+typedef struct
+{
+  uint32_t PortBase;          // GPIO port base address
+  uint8_t PinMask;            // bit for the pin on that port
+  uint8_t PortEnableBit;      // RCGCGPIO/PRGPIO bit for that port
+}ADC_ChannelMap_t;
 
 /*---------------------------- Module Functions ---------------------------*/
-// None
+static void EnableModule(ADC_Module_t Module);
+static void ReadFIFO(uint32_t Base, uint8_t Sequencer, uint32_t data[]);
 
 /*---------------------------- Module Variables ---------------------------*/
 
@@ -50,6 +95,28 @@ static const uint32_t HowMany2CTL[4] = {ADC_SSCTL2_END0|ADC_SSCTL2_IE0,
                                         ADC_SSCTL2_END3|ADC_SSCTL2_IE3};
 static uint8_t NumChannelsConverting;
 
+// AINn to pin mapping, straight from the TM4C123 pin table
+static const ADC_ChannelMap_t AIN2Pin[NUM_AIN] = {
+  { GPIO_PORTE_BASE, BIT3HI, BIT4HI },  // AIN0  PE3
+  { GPIO_PORTE_BASE, BIT2HI, BIT4HI },  // AIN1  PE2
+  { GPIO_PORTE_BASE, BIT1HI, BIT4HI },  // AIN2  PE1
+  { GPIO_PORTE_BASE, BIT0HI, BIT4HI },  // AIN3  PE0
+  { GPIO_PORTD_BASE, BIT3HI, BIT3HI },  // AIN4  PD3
+  { GPIO_PORTD_BASE, BIT2HI, BIT3HI },  // AIN5  PD2
+  { GPIO_PORTD_BASE, BIT1HI, BIT3HI },  // AIN6  PD1
+  { GPIO_PORTD_BASE, BIT0HI, BIT3HI },  // AIN7  PD0
+  { GPIO_PORTE_BASE, BIT5HI, BIT4HI },  // AIN8  PE5
+  { GPIO_PORTE_BASE, BIT4HI, BIT4HI },  // AIN9  PE4
+  { GPIO_PORTB_BASE, BIT4HI, BIT1HI },  // AIN10 PB4
+  { GPIO_PORTB_BASE, BIT5HI, BIT1HI }   // AIN11 PB5
+};
+static const uint32_t Module2Base[ADC_NUM_MODULES] = {ADC0_BASE, ADC1_BASE};
+static const uint8_t SeqDepth[NUM_SEQUENCERS] = {8, 4, 4, 1};
+// how many results each configured sequencer produces, 0 if not configured
+static uint8_t SeqNumSteps[ADC_NUM_MODULES][NUM_SEQUENCERS];
+static ADC_WatchFunc_t *WatchFunc;
+static volatile uint32_t WatchTrips;
+
 /*------------------------------ Module Code ------------------------------*/
 /****************************************************************************
  Function
@@ -75,10 +142,11 @@ void ADC_MultiInit(uint8_t HowMany){
   uint8_t index = HowMany-1; // index into the HowMany2Mask array
   
   // first sanity check on the HowMany parameter
-  if ( (0 == HowMany) || (4 < HowMany))
+  if ( (0 == HowMany) || (MAX_NUM_CHANNELS < HowMany))
     return;
   
   NumChannelsConverting = HowMany;
+  SeqNumSteps[ADC_MODULE_0][2] = HowMany; // so ADC_ReadSequence sees it too
   
   SYSCTL_RCGCADC_R |= 0x00000001;                // 1) activate clock for ADC0
   while((SYSCTL_PRADC_R & 0x0001) != 0x0001)
@@ -138,3 +206,447 @@ void ADC_MultiRead(uint32_t data[4]){
   }
   ADC0_ISC_R = 0x0004;                // 4) acknowledge completion, clear int
 }
+
+/****************************************************************************
+ Function
+    ADC_ConfigSequence
+
+ Parameters
+    ADC_Module_t : which A/D module (ADC_MODULE_0 or ADC_MODULE_1)
+    uint8_t : which sample sequencer (0-3)
+    const uint8_t Channels[] : list of AIN numbers (0-11), in sample order
+    uint8_t : how many entries in Channels (up to 8, 4, 4, 1 for SS0-SS3)
+
+ Returns
+    bool : false if the module, sequencer or channel list is not legal
+
+ Description
+    enables the module and the GPIO ports needed by the channels, puts the
+    pins into analog mode and programs the sequencer for a software
+    triggered conversion of the channel list. The same channel may appear
+    more than once in the list.
+
+ Notes
+    both modules can convert the same inputs, so splitting a channel list
+    between the two modules and using ADC_ReadSimultaneous gets twice the
+    aggregate sample rate of one module. Each sequencer is triggered on its
+    own, so channels that need to be sampled at different rates should be
+    put in different sequencers and read at those rates.
+
+ Author
+    Sander Tonkens, 10/19/26, 13:20
+****************************************************************************/
+bool ADC_ConfigSequence(ADC_Module_t Module, uint8_t Sequencer,
+                        const uint8_t Channels[], uint8_t HowMany)
+{
+  uint32_t Base;
+  uint32_t MuxValue = 0;
+  uint8_t i;
+
+  // sanity check the request before we touch any hardware
+  if ((Module >= ADC_NUM_MODULES) || (Sequencer >= NUM_SEQUENCERS) ||
+      (0 == HowMany) || (HowMany > SeqDepth[Sequencer]))
+    return false;
+  for (i = 0; i < HowMany; i++){
+    if (Channels[i] >= NUM_AIN)
+      return false;
+  }
+
+  EnableModule(Module);
+  Base = Module2Base[Module];
+
+  for (i = 0; i < HowMany; i++){
+    const ADC_ChannelMap_t *pPin = &AIN2Pin[Channels[i]];
+    // clock the port and wait for it to be ready
+    HWREG(SYSCTL_RCGCGPIO) |= pPin->PortEnableBit;
+    while ((HWREG(SYSCTL_PRGPIO) & pPin->PortEnableBit) != pPin->PortEnableBit)
+      ;
+    // input, alternate function, analog mode, no digital
+    HWREG(pPin->PortBase + GPIO_O_DIR) &= ~pPin->PinMask;
+    HWREG(pPin->PortBase + GPIO_O_AFSEL) |= pPin->PinMask;
+    HWREG(pPin->PortBase + GPIO_O_DEN) &= ~pPin->PinMask;
+    HWREG(pPin->PortBase + GPIO_O_AMSEL) |= pPin->PinMask;
+    MuxValue |= (uint32_t)Channels[i] << (i * BITS_PER_STEP);
+  }
+
+  HWREG(Base + ADC_O_ACTSS) &= ~(1UL << Sequencer);     // disable while we work
+  HWREG(Base + ADC_O_EMUX) &= ~(0xFUL << (Sequencer * BITS_PER_STEP)); // SW
+  HWREG(Base + ADC_O_SSMUX0 + Sequencer * SEQ_STRIDE) = MuxValue;
+  // flag the last step as the end of the sequence and the one that sets RIS
+  HWREG(Base + ADC_O_SSCTL0 + Sequencer * SEQ_STRIDE) =
+      (uint32_t)SSCTL_END_IE << ((HowMany - 1) * BITS_PER_STEP);
+  HWREG(Base + ADC_O_IM) &= ~(1UL << Sequencer);        // polled, no ints
+  HWREG(Base + ADC_O_ISC) = (1UL << Sequencer);         // clear stale status
+  HWREG(Base + ADC_O_ACTSS) |= (1UL << Sequencer);      // and enable it
+
+  SeqNumSteps[Module][Sequencer] = HowMany;
+  return true;
+}
+
+/****************************************************************************
+ Function
+    ADC_ReadSequence
+
+ Parameters
+    ADC_Module_t : which A/D module
+    uint8_t : which sample sequencer (0-3)
+    uint32_t data[] : array to hold the results, one per configured step
+
+ Returns
+    bool : false if that sequencer was never configured
+
+ Description
+    Triggers a conversion on one sequencer, waits for it to finish and
+    returns the results in the order given to ADC_ConfigSequence
+
+ Notes
+    busy-waits like ADC_MultiRead, about 1uS per step at 1M samples/sec
+
+ Author
+    Sander Tonkens, 10/19/26, 13:41
+****************************************************************************/
+bool ADC_ReadSequence(ADC_Module_t Module, uint8_t Sequencer, uint32_t data[])
+{
+  uint32_t Base;
+
+  if ((Module >= ADC_NUM_MODULES) || (Sequencer >= NUM_SEQUENCERS) ||
+      (0 == SeqNumSteps[Module][Sequencer]))
+    return false;
+
+  Base = Module2Base[Module];
+  HWREG(Base + ADC_O_PSSI) = (1UL << Sequencer);        // start conversion
+  while ((HWREG(Base + ADC_O_RIS) & (1UL << Sequencer)) == 0)
+    ;                                                   // wait for it
+  ReadFIFO(Base, Sequencer, data);
+  return true;
+}
+
+/****************************************************************************
+ Function
+    ADC_ReadSimultaneous
+
+ Parameters
+    uint8_t : sequencer to use on ADC0
+    uint32_t data0[] : results from ADC0
+    uint8_t : sequencer to use on ADC1
+    uint32_t data1[] : results from ADC1
+
+ Returns
+    bool : false if either sequencer was never configured
+
+ Description
+    arms both sequencers with SYNCWAIT and then starts them with a single
+    GSYNC write, so the two modules convert in lock step. With the two
+    channel lists interleaved between the modules this gives twice the
+    throughput of a single module and samples pairs of inputs at the same
+    instant.
+
+ Author
+    Sander Tonkens, 10/19/26, 13:55
+****************************************************************************/
+bool ADC_ReadSimultaneous(uint8_t Seq0, uint32_t data0[],
+                          uint8_t Seq1, uint32_t data1[])
+{
+  if ((Seq0 >= NUM_SEQUENCERS) || (Seq1 >= NUM_SEQUENCERS) ||
+      (0 == SeqNumSteps[ADC_MODULE_0][Seq0]) ||
+      (0 == SeqNumSteps[ADC_MODULE_1][Seq1]))
+    return false;
+
+  // arm both, neither starts until the global sync
+  HWREG(ADC0_BASE + ADC_O_PSSI) = ADC_PSSI_SYNCWAIT | (1UL << Seq0);
+  HWREG(ADC1_BASE + ADC_O_PSSI) = ADC_PSSI_SYNCWAIT | (1UL << Seq1);
+  HWREG(ADC0_BASE + ADC_O_PSSI) = ADC_PSSI_GSYNC | ADC_PSSI_SYNCWAIT;
+
+  while ((HWREG(ADC0_BASE + ADC_O_RIS) & (1UL << Seq0)) == 0)
+    ;
+  ReadFIFO(ADC0_BASE, Seq0, data0);
+  while ((HWREG(ADC1_BASE + ADC_O_RIS) & (1UL << Seq1)) == 0)
+    ;
+  ReadFIFO(ADC1_BASE, Seq1, data1);
+  return true;
+}
+
+/****************************************************************************
+ Function
+    ADC_SetSampleRate
+
+ Parameters
+    ADC_Module_t : which A/D module
+    ADC_SampleRate_t : maximum conversion rate for that module
+
+ Returns
+    nothing
+
+ Description
+    sets the ADCPC rate field for a module. The rate applies to every
+    channel converted by that module.
+
+ Author
+    Sander Tonkens, 10/19/26, 14:03
+****************************************************************************/
+void ADC_SetSampleRate(ADC_Module_t Module, ADC_SampleRate_t Rate)
+{
+  if (Module >= ADC_NUM_MODULES)
+    return;
+  EnableModule(Module);
+  HWREG(Module2Base[Module] + ADC_O_PC) =
+      (HWREG(Module2Base[Module] + ADC_O_PC) & ~ADC_PC_SR_M) | Rate;
+}
+
+/****************************************************************************
+ Function
+    ADC_WatchInit
+
+ Parameters
+    uint8_t : AIN channel (0-11) to watch
+    ADC_HWAverage_t : how many conversions ADC1 averages per sample
+    ADC_WatchFunc_t * : called from the interrupt when the input leaves
+                        its band
+
+ Returns
+    bool : false if the channel is not legal or there is no function
+
+ Description
+    puts the channel on ADC1 SS0 twice and leaves the sequencer converting
+    it over and over, with both samples going to the digital comparators
+    instead of the FIFO. The comparator on step 0 interrupts the first time
+    the input is below the band and the one on step 1 the first time it is
+    above it, so the input is compared on every conversion without any
+    code running until it leaves the band. Nothing trips until
+    ADC_WatchSetBand arms the watch.
+
+ Notes
+    this takes ADC1 SS0 and comparators 0 & 1 of ADC1, and sets the hardware
+    averaging of all of ADC1. At 250K samples/sec and 64x averaging the
+    input is compared about 2000 times a second
+
+ Author
+    Sander Tonkens, 10/19/26, 23:52
+****************************************************************************/
+bool ADC_WatchInit(uint8_t Channel, ADC_HWAverage_t HowMany,
+                   ADC_WatchFunc_t *pFunc)
+{
+  const uint8_t Steps[2] = {Channel, Channel};
+  uint32_t Base = ADC1_BASE;
+
+  if ((NULL == pFunc) || (HowMany > ADC_HW_AVG_64X) ||
+      !ADC_ConfigSequence(ADC_MODULE_1, WATCH_SEQ, Steps, 2))
+    return false;
+  WatchFunc = pFunc;
+  WatchTrips = 0;
+
+  HWREG(Base + ADC_O_ACTSS) &= ~(1UL << WATCH_SEQ);    // disable while we work
+  HWREG(Base + ADC_O_IM) &= ~ADC_IM_DCONSS0;           // not armed yet
+  HWREG(Base + ADC_O_SAC) = HowMany;
+  // both steps go to a comparator, so nothing ever lands in the FIFO
+  HWREG(Base + ADC_O_SSOP0) = ADC_SSOP0_S0DCOP | ADC_SSOP0_S1DCOP;
+  HWREG(Base + ADC_O_SSDC0) = (WATCH_HIGH_DC << BITS_PER_STEP) | WATCH_LOW_DC;
+  HWREG(Base + ADC_O_DCCTL0 + WATCH_LOW_DC * DC_STRIDE) =
+      ADC_DCCTL0_CIE | ADC_DCCTL0_CIC_ONCE | ADC_DCCTL0_CIM_LOW;
+  HWREG(Base + ADC_O_DCCTL0 + WATCH_HIGH_DC * DC_STRIDE) =
+      ADC_DCCTL0_CIE | ADC_DCCTL0_CIC_ONCE | ADC_DCCTL0_CIM_HIGH;
+  // convert over and over, with no trigger
+  HWREG(Base + ADC_O_EMUX) |=
+      (ADC_EMUX_EM0_ALWAYS << (WATCH_SEQ * BITS_PER_STEP));
+  HWREG(Base + ADC_O_ACTSS) |= (1UL << WATCH_SEQ);
+
+#ifdef ES_PREEMPT_THRESHOLD
+  // the watch function posts events, so it must be held off by EnterCritical
+  IntPrioritySet(INT_ADC1SS0_TM4C123, ES_KERNEL_IRQ_PRIORITY);
+#endif
+  IntEnable(INT_ADC1SS0_TM4C123);
+  return true;
+}
+
+/****************************************************************************
+ Function
+    ADC_WatchSetBand
+
+ Parameters
+    uint16_t : centre of the band, A/D counts
+    uint16_t : half-width of the band, A/D counts
+
+ Returns
+    nothing
+
+ Description
+    arms the watch to trip once the input is Band or more away from
+    Center. The watch trips once and
+    then waits for the next call, so a caller that re-centres the band on
+    each trip gets one event per move of Band counts.
+
+ Notes
+    if the input is already outside the new band the watch trips on the
+    next conversion. A band edge past full scale is left off, so a
+    saturated input does not trip over and over
+
+ Author
+    Sander Tonkens, 10/19/26, 23:52
+****************************************************************************/
+void ADC_WatchSetBand(uint16_t Center, uint16_t Band)
+{
+  uint32_t Base = ADC1_BASE;
+  // the low comparator trips below COMP0, the high one at or above COMP1
+  uint32_t Low = (Center >= Band) ? (Center - Band + 1) : 0;
+  uint32_t High = (uint32_t)Center + Band;
+
+  HWREG(Base + ADC_O_IM) &= ~ADC_IM_DCONSS0;
+  // COMP1 is never below COMP0, whichever band the comparator uses
+  HWREG(Base + ADC_O_DCCMP0 + WATCH_LOW_DC * DC_STRIDE) =
+      (Low << ADC_DCCMP0_COMP1_S) | Low;
+  if (High > ADC_MAX_COUNT){
+    HWREG(Base + ADC_O_DCCTL0 + WATCH_HIGH_DC * DC_STRIDE) &= ~ADC_DCCTL0_CIE;
+  }else{
+    HWREG(Base + ADC_O_DCCMP0 + WATCH_HIGH_DC * DC_STRIDE) =
+        (High << ADC_DCCMP0_COMP1_S) | High;
+    HWREG(Base + ADC_O_DCCTL0 + WATCH_HIGH_DC * DC_STRIDE) |= ADC_DCCTL0_CIE;
+  }
+  // forget where the input was, so the first sample outside trips
+  HWREG(Base + ADC_O_DCRIC) = ADC_DCRIC_DCINT0 | ADC_DCRIC_DCINT1;
+  HWREG(Base + ADC_O_DCISC) = WATCH_DC_BITS;
+  HWREG(Base + ADC_O_IM) |= ADC_IM_DCONSS0;
+}
+
+/****************************************************************************
+ Function
+    ADC_WatchGetTrips
+
+ Parameters
+    nothing
+
+ Returns
+    uint32_t : how many times the watch has tripped since ADC_WatchInit
+
+ Description
+    for checking the event rate the band gives
+
+ Author
+    Sander Tonkens, 10/19/26, 23:52
+****************************************************************************/
+uint32_t ADC_WatchGetTrips(void)
+{
+  return WatchTrips;
+}
+
+/****************************************************************************
+ Function
+    ADCWatchHandler
+
+ Parameters
+    nothing
+
+ Returns
+    nothing
+
+ Description
+    ADC1 sequence 0 interrupt. Disarms the watch, so it trips once per
+    band, and tells the watch function which way the input went
+
+ Author
+    Sander Tonkens, 10/19/26, 23:52
+****************************************************************************/
+void ADCWatchHandler(void)
+{
+  uint32_t Tripped = HWREG(ADC1_BASE + ADC_O_DCISC) & WATCH_DC_BITS;
+
+  HWREG(ADC1_BASE + ADC_O_IM) &= ~ADC_IM_DCONSS0;
+  HWREG(ADC1_BASE + ADC_O_DCISC) = Tripped;
+  if (0 != Tripped){
+    WatchTrips++;
+    WatchFunc((Tripped & (ADC_DCISC_DCINT0 << WATCH_HIGH_DC)) != 0);
+  }
+}
+
+/****************************************************************************
+ Function
+    ADC_MultiSetHWAverage
+
+ Parameters
+    ADC_HWAverage_t : how many conversions the hardware averages per sample
+
+ Returns
+    nothing
+
+ Description
+    programs the ADC0 sample averaging control register. Every result that
+    ends up in the FIFO is then the average of 2^n back to back conversions
+    of the same channel, which knocks down the white noise on the inputs
+    at no CPU cost
+
+ Notes
+    ADC_MultiRead busy-waits on the sequencer, so its execution time goes up
+    by the averaging factor (about 64uS per channel at 16x)
+
+ Author
+    Sander Tonkens, 10/19/26, 09:20
+****************************************************************************/
+void ADC_MultiSetHWAverage(ADC_HWAverage_t HowMany)
+{
+  if (HowMany > ADC_HW_AVG_64X)
+    return;
+  ADC0_SAC_R = HowMany;
+}
+
+/***************************************************************************
+ private functions
+ ***************************************************************************/
+
+/****************************************************************************
+ Function
+    EnableModule
+
+ Parameters
+    ADC_Module_t : which A/D module
+
+ Returns
+    nothing
+
+ Description
+    turns on the clock to a module the first time it is used and sets it
+    up with the same defaults as ADC_MultiInit
+
+ Author
+    Sander Tonkens, 10/19/26, 14:10
+****************************************************************************/
+static void EnableModule(ADC_Module_t Module)
+{
+  uint32_t EnableBit = (1UL << Module);
+
+  if ((SYSCTL_RCGCADC_R & EnableBit) != 0)
+    return;                                 // already running
+
+  SYSCTL_RCGCADC_R |= EnableBit;
+  while ((SYSCTL_PRADC_R & EnableBit) != EnableBit)
+    ;
+  HWREG(Module2Base[Module] + ADC_O_PC) = ADC_PC_250K;
+  HWREG(Module2Base[Module] + ADC_O_SSPRI) = 0x3210; // SS3 lowest priority
+}
+
+/****************************************************************************
+ Function
+    ReadFIFO
+
+ Parameters
+    uint32_t : module base address
+    uint8_t : sequencer that just finished
+    uint32_t data[] : where to put the results
+
+ Returns
+    nothing
+
+ Description
+    unloads the sequencer FIFO and acknowledges the completion
+
+ Author
+    Sander Tonkens, 10/19/26, 14:14
+****************************************************************************/
+static void ReadFIFO(uint32_t Base, uint8_t Sequencer, uint32_t data[])
+{
+  uint8_t i;
+  uint8_t Module = (Base == ADC0_BASE) ? ADC_MODULE_0 : ADC_MODULE_1;
+
+  for (i = 0; i < SeqNumSteps[Module][Sequencer]; i++){
+    data[i] = HWREG(Base + ADC_O_SSFIFO0 + Sequencer * SEQ_STRIDE) & 0xFFF;
+  }
+  HWREG(Base + ADC_O_ISC) = (1UL << Sequencer);
+}
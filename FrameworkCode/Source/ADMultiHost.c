@@ -0,0 +1,154 @@
+/****************************************************************************
+ Module
+   ADMultiHost.c
+
+ Revision
+   1.0.1
+
+ Description
+   Host only model of the band watch in ADMulti.c, for checking in
+   simulation how many events a band width gives on recorded or generated
+   panel readings.
+
+ Notes
+   Only built when ES_HOST_BUILD is defined, it is not part of the Tiva
+   project, and takes the place of the ADC_Watch functions of ADMulti.c.
+   The simulation feeds the model one sample per comparator conversion with
+   ADC_WatchHostSample, already averaged the way ADC1's hardware averaging
+   would. Each sample is tested the way the two comparators test it, and a
+   trip disarms the watch until the next ADC_WatchSetBand, as the
+   interrupt does on the Tiva. The watch function is called straight from
+   ADC_WatchHostSample, in the simulation's thread.
+
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/19/26 23:52 ston    first pass
+
+****************************************************************************/
+#ifdef ES_HOST_BUILD
+
+/*----------------------------- Include Files -----------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "ADMulti.h"
+
+/*----------------------------- Module Defines ----------------------------*/
+#define ADC_MAX_COUNT 0xFFF
+#define NUM_AIN 12
+
+/*---------------------------- Module Variables ---------------------------*/
+static ADC_WatchFunc_t *WatchFunc;
+static uint32_t WatchTrips;
+static bool Armed;
+static uint32_t Low;        // trips below this
+static uint32_t High;       // trips at or above this
+static bool HighEnabled;
+
+/*------------------------------ Module Code ------------------------------*/
+/****************************************************************************
+ Function
+    ADC_WatchInit
+
+ Parameters
+    uint8_t : AIN channel (0-11) to watch
+    ADC_HWAverage_t : ignored, the samples come in already averaged
+    ADC_WatchFunc_t * : called when the input leaves its band
+
+ Returns
+    bool : false if the channel is not legal or there is no function
+
+ Description
+    same checks as on the Tiva, leaves the watch disarmed
+
+ Author
+    Sander Tonkens, 10/19/26, 23:52
+****************************************************************************/
+bool ADC_WatchInit(uint8_t Channel, ADC_HWAverage_t HowMany,
+                   ADC_WatchFunc_t *pFunc)
+{
+  if ((NULL == pFunc) || (HowMany > ADC_HW_AVG_64X) || (Channel >= NUM_AIN))
+    return false;
+  WatchFunc = pFunc;
+  WatchTrips = 0;
+  Armed = false;
+  return true;
+}
+
+/****************************************************************************
+ Function
+    ADC_WatchSetBand
+
+ Parameters
+    uint16_t : centre of the band, A/D counts
+    uint16_t : half-width of the band, A/D counts
+
+ Returns
+    nothing
+
+ Description
+    arms the model with the comparator values the Tiva version would set
+
+ Author
+    Sander Tonkens, 10/19/26, 23:52
+****************************************************************************/
+void ADC_WatchSetBand(uint16_t Center, uint16_t Band)
+{
+  Low = (Center >= Band) ? (Center - Band + 1) : 0;
+  High = (uint32_t)Center + Band;
+  HighEnabled = (High <= ADC_MAX_COUNT);
+  Armed = true;
+}
+
+/****************************************************************************
+ Function
+    ADC_WatchGetTrips
+
+ Parameters
+    nothing
+
+ Returns
+    uint32_t : how many times the watch has tripped since ADC_WatchInit
+
+ Description
+    for checking the event rate the band gives
+
+ Author
+    Sander Tonkens, 10/19/26, 23:52
+****************************************************************************/
+uint32_t ADC_WatchGetTrips(void)
+{
+  return WatchTrips;
+}
+
+/****************************************************************************
+ Function
+    ADC_WatchHostSample
+
+ Parameters
+    uint16_t : one averaged conversion of the watched input
+
+ Returns
+    nothing
+
+ Description
+    one comparator conversion: trips, disarms and calls the watch function
+    if the armed watch sees the sample outside its band
+
+ Author
+    Sander Tonkens, 10/19/26, 23:52
+****************************************************************************/
+void ADC_WatchHostSample(uint16_t Sample)
+{
+  bool WentHigh = HighEnabled && (Sample >= High);
+
+  if (Armed && (WentHigh || (Sample < Low))){
+    Armed = false;
+    WatchTrips++;
+    WatchFunc(WentHigh);
+  }
+}
+
+#endif /* ES_HOST_BUILD */
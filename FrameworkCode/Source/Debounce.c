@@ -0,0 +1,350 @@
+/***************************************************************************
+ Module
+   Debounce.c
+
+ Revision
+   1.0.1
+
+ Description
+   Shared debounce engine for all of the digital inputs. Every input is
+   sampled together, once per DB_SAMPLE_MS, and posts clean press & release
+   events to the service that owns it.
+
+ Notes
+   Each port is debounced as a whole word with vertical counters: bit n of
+   Count0 & Count1 together form a 2 bit counter for pin n. A pin's counter
+   runs while the pin disagrees with its debounced state and is cleared as
+   soon as it agrees again, so only a pin that reads the new level for 4
+   samples in a row toggles. That is a handful of logic operations per port,
+   however many pins it has.
+   The pins come from the framework's input scan rather than the ports:
+   DB_InputsChanged is one of its change handlers and marks a port as
+   unsettled, and only unsettled ports are clocked. A port drops back out
+   once all of its pins agree with their debounced state, so with quiet
+   inputs a sample costs one test.
+   Release events carry how long the input was held, in mS, in EventParam.
+   To add an input, add a line to InputTable and, if it is on a port not yet
+   handled, a line for that port to INPUT_SCAN_HANDLER_LIST in ES_Configure.h
+
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/19/26 23:50 ston    smoke tower IR moved to the SmokeTowerIR service
+ 10/19/26 13:00 ston    sample from the input scan snapshot, only clock the
+                        ports that have changed
+ 10/19/26 12:00 ston    First pass, replaces ButtonDebounce, the meat switch
+                        debounce states and the undebounced tower & LEAF
+                        checkers
+
+****************************************************************************/
+//----------------------------- Include Files -----------------------------*/
+// the common headers for C99 types
+#include <stdint.h>
+#include <stdbool.h>
+
+/* include header files for this module
+*/
+#include "Debounce.h"
+
+/* include header files for hardware access
+*/
+#include "inc/hw_memmap.h"
+#include "inc/hw_types.h"
+#include "inc/hw_gpio.h"
+#include "inc/hw_sysctl.h"
+#include "BITDEFS.H"
+
+/* include header files for the framework
+*/
+#include "ES_Configure.h"
+#include "ES_Framework.h"
+#include "ES_CheckEvents.h"
+
+#ifndef INPUT_SCAN_PORT_LIST
+#error "Debounce needs the input scan, see INPUT_SCAN_PORT_LIST"
+#endif
+
+/* include header files for the services that get the events
+*/
+#include "GameManager.h"
+#include "VotingGame.h"
+#include "MeatSwitchDebounce.h"
+
+// module level defines
+typedef struct
+{
+  uint8_t Port;                 // SCAN_PORT_x
+  uint8_t Pin;                  // BITnHI mask of the pin
+  bool ActiveLow;               // pressed when the pin reads 0
+  ES_EventType_t PressEvent;    // ES_NO_EVENT to not post on press
+  ES_EventType_t ReleaseEvent;  // ES_NO_EVENT to not post on release
+  pPostFunc PostFunc;
+} DB_Input_t;
+
+typedef struct
+{
+  uint8_t Mask;     // pins on this port that are debounced
+  uint8_t Stable;   // debounced state of those pins
+  uint8_t Count0;   // vertical counter, low bits
+  uint8_t Count1;   // vertical counter, high bits
+} DB_PortState_t;
+
+static const DB_Input_t InputTable[] = {
+  // voting buttons & switch, PD1-3, high when pressed
+  { SCAN_PORT_D, BIT1HI, false, VOTED_YES, ES_NO_EVENT, PostVotingGame },
+  { SCAN_PORT_D, BIT2HI, false, VOTED_NO, ES_NO_EVENT, PostVotingGame },
+  { SCAN_PORT_D, BIT3HI, false, SWITCH_HIT, ES_NO_EVENT, PostVotingGame },
+  // LEAF detector, PD6, low with a LEAF in place
+  { SCAN_PORT_D, BIT6HI, true, LEAF_IN_CORRECT, LEAF_REMOVED, PostGameManager },
+  // meat tracker microswitch, PB3, low when down
+  { SCAN_PORT_B, BIT3HI, true, DB_MEAT_SWITCH_DOWN, DB_MEAT_SWITCH_UP,
+    PostMeatSwitchDebounce },
+};
+
+#define NUM_INPUTS (sizeof(InputTable) / sizeof(InputTable[0]))
+
+// Private functions
+static bool PostEdges(const uint8_t Toggled[], uint16_t Now);
+static bool IsPressed(uint8_t WhichInput);
+
+// Private variables
+static DB_PortState_t PortState[NUM_SCAN_PORTS];
+static uint16_t PressTime[NUM_INPUTS];
+static uint16_t LastSampleTime;
+static uint8_t UnsettledPorts;    // bit n set = SCAN_PORT n is being clocked
+
+/****************************************************************************
+ Function
+     DB_Init
+ Parameters
+     Nothing
+
+ Returns
+     Nothing
+
+ Description
+     Makes every input in the table a digital input and takes its current
+     level as the starting debounced state, so nothing is posted for it
+ Notes
+     The port clocks must already be running. Call before ES_Initialize, so
+     the pins are digital inputs when the input scan takes its first
+     snapshot
+ Author
+     Sander Tonkens, 10/19/26, 12:00
+****************************************************************************/
+void DB_Init(void)
+{
+  uint8_t i;
+
+  for (i = 0; i < NUM_SCAN_PORTS; i++)
+  {
+    PortState[i].Mask = 0;
+  }
+  for (i = 0; i < NUM_INPUTS; i++)
+  {
+    PortState[InputTable[i].Port].Mask |= InputTable[i].Pin;
+  }
+  for (i = 0; i < NUM_SCAN_PORTS; i++)
+  {
+    uint32_t PortBase = ES_GetInputPortBase(i);
+    HWREG(PortBase + GPIO_O_DEN) |= PortState[i].Mask;
+    HWREG(PortBase + GPIO_O_DIR) &= ~PortState[i].Mask;
+    PortState[i].Stable = HWREG(PortBase + (GPIO_O_DATA + ALL_BITS)) &
+                          PortState[i].Mask;
+    PortState[i].Count0 = 0;
+    PortState[i].Count1 = 0;
+  }
+  // clock everything once, in case a pin moves before the first snapshot
+  UnsettledPorts = (1 << NUM_SCAN_PORTS) - 1;
+  LastSampleTime = ES_Timer_GetTime();
+}
+
+/****************************************************************************
+ Function
+     DB_InputsChanged
+ Parameters
+     uint8_t Port, SCAN_PORT_x that changed
+     uint8_t Changed, bits of that port that changed
+     uint8_t Snapshot, the port's new value
+
+ Returns
+     Nothing
+
+ Description
+     Input scan change handler, starts clocking the port if any of the
+     changed bits are ones we debounce
+ Notes
+
+ Author
+     Sander Tonkens, 10/19/26, 13:00
+****************************************************************************/
+void DB_InputsChanged(uint8_t Port, uint8_t Changed, uint8_t Snapshot)
+{
+  (void)Snapshot; // sampled in CheckDebouncedInputs, on the sample tick
+  if ((Port < NUM_SCAN_PORTS) && ((Changed & PortState[Port].Mask) != 0))
+  {
+    UnsettledPorts |= (1 << Port);
+  }
+}
+
+/****************************************************************************
+ Function
+     CheckDebouncedInputs
+ Parameters
+     None
+
+ Returns
+     bool, true if an event is posted
+
+ Description
+     Event checker: once every DB_SAMPLE_MS, clocks the vertical counters
+     of the unsettled ports from the input scan snapshot and posts the
+     events for any input whose debounced state changed
+ Notes
+     With every port settled this is a single test
+ Author
+     Sander Tonkens, 10/19/26, 12:00
+****************************************************************************/
+bool CheckDebouncedInputs(void)
+{
+  uint8_t Toggled[NUM_SCAN_PORTS];
+  uint8_t AnyToggled = 0;
+  uint16_t Now;
+  uint8_t i;
+
+  if (UnsettledPorts == 0)
+  {
+    return false;
+  }
+  Now = ES_Timer_GetTime();
+  if ((uint16_t)(Now - LastSampleTime) < DB_SAMPLE_MS)
+  {
+    return false;
+  }
+  LastSampleTime = Now;
+
+  for (i = 0; i < NUM_SCAN_PORTS; i++)
+  {
+    DB_PortState_t *pState = &PortState[i];
+    uint8_t Sample;
+    uint8_t Delta;
+
+    Toggled[i] = 0;
+    if ((UnsettledPorts & (1 << i)) == 0)
+    {
+      continue;
+    }
+    Sample = ES_GetInputSnapshot(i) & pState->Mask;
+    // pins that disagree with their debounced state
+    Delta = Sample ^ pState->Stable;
+    if (Delta == 0)
+    {
+      // every pin agrees, so all of the counters are clear: settled
+      pState->Count0 = 0;
+      pState->Count1 = 0;
+      UnsettledPorts &= ~(1 << i);
+      continue;
+    }
+
+    // count up where they disagree, clear where they agree
+    pState->Count1 = (pState->Count1 ^ pState->Count0) & Delta;
+    pState->Count0 = ~pState->Count0 & Delta;
+    // a counter that wrapped back to 0 while still disagreeing has seen
+    // 4 samples of the new level in a row
+    Toggled[i] = Delta & ~(pState->Count0 | pState->Count1);
+    pState->Stable ^= Toggled[i];
+    AnyToggled |= Toggled[i];
+  }
+
+  if (AnyToggled == 0)
+  {
+    return false;
+  }
+  return PostEdges(Toggled, Now);
+}
+
+/***************************************************************************
+ private functions
+ ***************************************************************************/
+
+/****************************************************************************
+ Function
+     PostEdges
+ Parameters
+     const uint8_t Toggled[], pins that just changed debounced state, by port
+     uint16_t Now, time of this sample
+
+ Returns
+     bool, true if an event is posted
+
+ Description
+     Walks the input table and posts the press or release event for each
+     input that toggled, releases carry the press duration
+ Notes
+
+ Author
+     Sander Tonkens, 10/19/26, 12:00
+****************************************************************************/
+static bool PostEdges(const uint8_t Toggled[], uint16_t Now)
+{
+  ES_Event_t ThisEvent;
+  bool ReturnVal = false;
+  uint8_t i;
+
+  for (i = 0; i < NUM_INPUTS; i++)
+  {
+    const DB_Input_t *pInput = &InputTable[i];
+
+    if ((Toggled[pInput->Port] & pInput->Pin) == 0)
+    {
+      continue;
+    }
+    if (IsPressed(i))
+    {
+      PressTime[i] = Now;
+      ThisEvent.EventType = pInput->PressEvent;
+      ThisEvent.EventParam = 0;
+    }
+    else
+    {
+      ThisEvent.EventType = pInput->ReleaseEvent;
+      ThisEvent.EventParam = Now - PressTime[i];
+    }
+    if (ThisEvent.EventType != ES_NO_EVENT)
+    {
+      pInput->PostFunc(ThisEvent);
+      ReturnVal = true;
+    }
+  }
+  return ReturnVal;
+}
+
+/****************************************************************************
+ Function
+     IsPressed
+ Parameters
+     uint8_t WhichInput, index into the input table
+
+ Returns
+     bool, true if the input is currently (debounced) pressed
+
+ Description
+     Applies the input's active level to its debounced pin state
+ Notes
+
+ Author
+     Sander Tonkens, 10/19/26, 12:00
+****************************************************************************/
+static bool IsPressed(uint8_t WhichInput)
+{
+  const DB_Input_t *pInput;
+  bool Level;
+
+  if (WhichInput >= NUM_INPUTS)
+  {
+    return false;
+  }
+  pInput = &InputTable[WhichInput];
+  Level = (PortState[pInput->Port].Stable & pInput->Pin) != 0;
+  return Level != pInput->ActiveLow;
+}
@@ -5,9 +5,21 @@
      source file for the module to call the User event checking routines
  Notes
      Users should not modify the contents of this file.
+     If INPUT_SCAN_PORT_LIST is defined, every pass starts by reading each of
+     those ports once. Changed bits are handed to the change handlers in
+     INPUT_SCAN_HANDLER_LIST and the snapshot is what the checkers then use,
+     so no checker needs to touch the GPIO registers itself.
+     The checkers are scheduled rather than simply walked in order: each has
+     a polling period (EVENT_CHECK_PERIODS), a pass resumes after the last
+     checker that found an event so one busy checker cannot starve the rest,
+     and EVENT_CHECK_BUDGET_US caps the time one pass may spend. Calls & hits
+     are counted per checker, see ES_GetCheckerStats.
  History
  When           Who     What/Why
  -------------- ---     --------
+ 10/19/26 14:00 ston     round-robin, periodic & budgeted checker scheduling
+                         with per checker statistics
+ 10/19/26 13:00 ston     added the input scan stage
                 jec     out all user modifications into ES_Configure
  10/16/11 12:32 jec      started coding
 *****************************************************************************/
@@ -16,6 +28,13 @@
 #include "ES_Events.h"
 #include "ES_General.h"
 #include "ES_CheckEvents.h"
+#include "ES_Port.h"
+
+#ifdef INPUT_SCAN_PORT_LIST
+#include "inc/hw_memmap.h"
+#include "inc/hw_types.h"
+#include "inc/hw_gpio.h"
+#endif
 
 // Include the header files for the module(s) with your event checkers.
 // This gets you the prototypes for the event checking functions.
@@ -28,6 +47,42 @@ static CheckFunc *const ES_EventList[] = {
   EVENT_CHECK_LIST
 };
 
+#define NUM_CHECKERS ARRAY_SIZE(ES_EventList)
+
+// how often each checker runs, in timer ticks, 0 = on every pass. Sized
+// from the checker list, so missing periods default to every pass
+#ifdef EVENT_CHECK_PERIODS
+static const uint16_t CheckerPeriod[ARRAY_SIZE(ES_EventList)] = {
+  EVENT_CHECK_PERIODS
+};
+#else
+static const uint16_t CheckerPeriod[ARRAY_SIZE(ES_EventList)] = { 0 };
+#endif
+
+// the scheduler's state
+static uint8_t NextChecker = 0;   // where the next pass starts
+static uint16_t LastRun[ARRAY_SIZE(ES_EventList)];
+static ES_CheckerStats_t CheckerStats[ARRAY_SIZE(ES_EventList)];
+static uint32_t BudgetOverruns = 0;
+
+#ifdef INPUT_SCAN_PORT_LIST
+typedef struct
+{
+  uint8_t Port;             // index into ScanPortBase
+  uint8_t Mask;             // bits this handler wants to hear about
+  ScanHandler_t *Handler;
+}ES_ScanHandlerDesc_t;
+
+static const uint32_t ScanPortBase[] = { INPUT_SCAN_PORT_LIST };
+
+static const ES_ScanHandlerDesc_t ScanHandlers[] = { INPUT_SCAN_HANDLER_LIST };
+
+// the port values as of the last scan
+static uint8_t Snapshot[ARRAY_SIZE(ScanPortBase)];
+
+static void ScanInputs(void);
+#endif
+
 // Implementation for public functions
 
 /****************************************************************************
@@ -38,32 +93,210 @@ static CheckFunc *const ES_EventList[] = {
  Returns
    bool: true if any of the user event checkers returned true, false otherwise
  Description
-   loop through the EF_EventList array executing the event checking functions
+   runs the event checkers that are due, starting after the checker that
+   last found an event, until one finds an event, every checker has had its
+   turn or the pass is over its time budget
  Notes
-
+   a checker is due if its period has elapsed since it last ran. The budget
+   is only tested between checkers, so a single slow checker still runs to
+   completion; the ones after it get their turn on the next pass.
  Author
    J. Edward Carryer, 10/25/11, 08:55
 ****************************************************************************/
 bool ES_CheckUserEvents(void)
 {
-  uint8_t i;
-  // loop through the array executing the event checking functions
-  for (i = 0; i < ARRAY_SIZE(ES_EventList); i++)
+  uint8_t Count;
+  uint8_t i = NextChecker;
+  uint16_t Now = _HW_GetTickCount();
+#ifdef EVENT_CHECK_BUDGET_US
+  uint32_t PassStart = _HW_GetCycleStamp();
+#endif
+
+#ifdef INPUT_SCAN_PORT_LIST
+  ScanInputs(); // one read of each port for the whole pass
+#endif
+  for (Count = 0; Count < NUM_CHECKERS; Count++)
   {
-    if (ES_EventList[i]() == true)
+    if ((CheckerPeriod[i] == 0) ||
+        ((uint16_t)(Now - LastRun[i]) >= CheckerPeriod[i]))
     {
-      break; // found a new event, so process it first
+      LastRun[i] = Now;
+      CheckerStats[i].Calls++;
+      if (ES_EventList[i]() == true)
+      {
+        CheckerStats[i].Hits++;
+        // found a new event, so process it first and let the next
+        // checker go first next time
+        NextChecker = (i + 1) % NUM_CHECKERS;
+        return true;
+      }
+#ifdef EVENT_CHECK_BUDGET_US
+      if (_HW_USSince(PassStart) > EVENT_CHECK_BUDGET_US)
+      {
+        // out of time, pick up from the next checker on the next pass
+        BudgetOverruns++;
+        NextChecker = (i + 1) % NUM_CHECKERS;
+        return false;
+      }
+#endif
     }
+    i = (i + 1) % NUM_CHECKERS;
   }
-  if (i == ARRAY_SIZE(ES_EventList))   // if no new events
+  return false;   // no new events
+}
+
+/****************************************************************************
+ Function
+   ES_GetCheckerStats
+ Parameters
+   uint8_t Which: position of the checker in EVENT_CHECK_LIST
+   ES_CheckerStats_t *pStats: where to copy its statistics
+ Returns
+   bool: false if there is no such checker
+ Description
+   reports how often a checker has been called and how often it found an
+   event, for tuning EVENT_CHECK_PERIODS
+ Notes
+
+ Author
+   Sander Tonkens, 10/19/26, 14:00
+****************************************************************************/
+bool ES_GetCheckerStats(uint8_t Which, ES_CheckerStats_t *pStats)
+{
+  if ((Which >= NUM_CHECKERS) || (pStats == (ES_CheckerStats_t *)0))
   {
     return false;
   }
-  else
+  *pStats = CheckerStats[Which];
+  return true;
+}
+
+/****************************************************************************
+ Function
+   ES_GetCheckerBudgetOverruns
+ Parameters
+   None
+ Returns
+   uint32_t: number of passes cut short by EVENT_CHECK_BUDGET_US
+ Description
+
+ Notes
+
+ Author
+   Sander Tonkens, 10/19/26, 14:00
+****************************************************************************/
+uint32_t ES_GetCheckerBudgetOverruns(void)
+{
+  return BudgetOverruns;
+}
+
+#ifdef INPUT_SCAN_PORT_LIST
+/****************************************************************************
+ Function
+   ES_InitInputScan
+ Parameters
+   None
+ Returns
+   None
+ Description
+   takes the first snapshot, so that the first pass only reports changes
+   made after the framework started
+ Notes
+   called from ES_Initialize
+ Author
+   Sander Tonkens, 10/19/26, 13:00
+****************************************************************************/
+void ES_InitInputScan(void)
+{
+  uint8_t Port;
+  for (Port = 0; Port < ARRAY_SIZE(ScanPortBase); Port++)
+  {
+    Snapshot[Port] = HWREG(ScanPortBase[Port] + (GPIO_O_DATA + ALL_BITS));
+  }
+}
+
+/****************************************************************************
+ Function
+   ES_GetInputSnapshot
+ Parameters
+   uint8_t Port: which scanned port, SCAN_PORT_x
+ Returns
+   uint8_t: the port's pins as of the start of this pass
+ Description
+   lets event checkers work from the snapshot instead of the hardware
+ Notes
+
+ Author
+   Sander Tonkens, 10/19/26, 13:00
+****************************************************************************/
+uint8_t ES_GetInputSnapshot(uint8_t Port)
+{
+  if (Port >= ARRAY_SIZE(ScanPortBase))
   {
-    return true;
+    return 0;
+  }
+  return Snapshot[Port];
+}
+
+/****************************************************************************
+ Function
+   ES_GetInputPortBase
+ Parameters
+   uint8_t Port: which scanned port, SCAN_PORT_x
+ Returns
+   uint32_t: the port's base address, for modules that need to configure it
+ Description
+
+ Notes
+
+ Author
+   Sander Tonkens, 10/19/26, 13:00
+****************************************************************************/
+uint32_t ES_GetInputPortBase(uint8_t Port)
+{
+  return ScanPortBase[Port];
+}
+
+/****************************************************************************
+ Function
+   ScanInputs
+ Parameters
+   None
+ Returns
+   None
+ Description
+   reads every scanned port once, XORs it against the last snapshot and,
+   only for ports that changed, calls the handlers whose mask covers one of
+   the changed bits
+ Notes
+   with nothing changing this is one load and one compare per port
+ Author
+   Sander Tonkens, 10/19/26, 13:00
+****************************************************************************/
+static void ScanInputs(void)
+{
+  uint8_t Port;
+  uint8_t i;
+  for (Port = 0; Port < ARRAY_SIZE(ScanPortBase); Port++)
+  {
+    uint8_t NewValue = HWREG(ScanPortBase[Port] + (GPIO_O_DATA + ALL_BITS));
+    uint8_t Changed = NewValue ^ Snapshot[Port];
+    if (Changed != 0)
+    {
+      Snapshot[Port] = NewValue;
+      for (i = 0; i < ARRAY_SIZE(ScanHandlers); i++)
+      {
+        if ((ScanHandlers[i].Port == Port) &&
+            ((Changed & ScanHandlers[i].Mask) != 0))
+        {
+          ScanHandlers[i].Handler(Port, Changed & ScanHandlers[i].Mask,
+                                  NewValue);
+        }
+      }
+    }
   }
 }
+#endif
 
 /*------------------------------- Footnotes -------------------------------*/
 /*------------------------------ End of file ------------------------------*/
@@ -11,7 +11,11 @@
  History
  When           Who     What/Why
  -------------- ---     --------
-
+ 10/20/26 12:00 ston    the TEST benchmark uses LEAF_REMOVED and runs on the
+                        host too
+ 10/19/26 23:54 ston    recall splices the deferred events back as one block
+                        in the order they were deferred, added
+                        ES_RecallEventsOfType
  10/11/14 14:58 jec     converted RecallEvent to RecallEvents to pull all
                         deferred events off the deferral queue
  11/02/13 16:38 jec      Began Coding
@@ -45,31 +49,167 @@
  Returns
      bool true if an event was recalled, false if no event was left in queue
  Description
-     pulls all events off the deferral queue if any are available. If there was
-     something in the queue, then it posts it LIFO fashion to the queue
-     indicated by WhichService
+     moves all of the deferred events to the front of the queue indicated by
+     WhichService, in the order they were deferred
  Notes
-     None.
+     the events go over in one critical region and the service's Ready bit
+     is set once, rather than a dequeue and a LIFO post for each one. Any
+     that do not fit in the service's queue stay deferred, where they used
+     to be lost.
  Author
      J. Edward Carryer, 11/20/13 16:49
 ****************************************************************************/
 bool ES_RecallEvents(uint8_t WhichService, ES_Event_t *pBlock)
 {
-  ES_Event_t  RecalledEvent;
-  bool      WereEventsPulled = false;
-  // recall any events from the queue
-  do
+  return ES_SpliceToService(WhichService, pBlock, ES_NO_EVENT) > 0;
+}
+
+/****************************************************************************
+ Function
+     ES_RecallEventsOfType
+ Parameters
+      uint8_t WhichService, number of the service to post Recalled event to
+      ES_Event * pBlock, pointer to the block of memory that implements the
+        Defer/Recall queue
+      ES_EventType_t WhichType, the type of event to recall
+ Returns
+     bool true if an event was recalled, false if none of that type was left
+ Description
+     as ES_RecallEvents, but only for events of WhichType
+ Notes
+     ES_NO_EVENT is never deferred, and would recall them all
+ Author
+     Sander Tonkens, 10/19/26, 23:54
+****************************************************************************/
+bool ES_RecallEventsOfType(uint8_t WhichService, ES_Event_t *pBlock,
+    ES_EventType_t WhichType)
+{
+  if (ES_NO_EVENT == WhichType)
   {
-    ES_DeQueue(pBlock, &RecalledEvent);
-    if (RecalledEvent.EventType != ES_NO_EVENT)
+    return false;
+  }
+  return ES_SpliceToService(WhichService, pBlock, WhichType) > 0;
+}
+
+/***************************************************************************
+ private functions
+ ***************************************************************************/
+#ifdef TEST
+/* times recalling 1 to 64 deferred events, the old way, a dequeue and a LIFO
+   add per event, against ES_SpliceQueue, and prints the CPU cycles for each.
+   Each time is for a batch of REPEATS refills and recalls, the best of
+   TRIALS batches, less the best time for the refills alone, so it also
+   works with the uS resolution of the host build's cycle stamps (build
+   with ES_HostPort.c in place of ES_Port.c) */
+#include <stdio.h>
+#ifndef ES_HOST_BUILD
+#include "driverlib/sysctl.h"
+#include "termio.h"
+#endif
+
+#define MAX_DEPTH 64
+#define REPEATS 200
+#define TRIALS 5
+
+typedef enum
+{
+  FILL_ONLY,
+  OLD_LOOP,
+  SPLICE
+}Method_t;
+
+static ES_Event_t Deferred[MAX_DEPTH + 1];
+static ES_Event_t Target[MAX_DEPTH + 1];
+
+static void Fill(uint8_t Depth)
+{
+  ES_Event_t  MyEvent;
+  uint8_t     i;
+
+  ES_InitQueue(Deferred, ARRAY_SIZE(Deferred));
+  ES_InitQueue(Target, ARRAY_SIZE(Target));
+  for (i = 0; i < Depth; i++)
+  {
+    MyEvent.EventType   = LEAF_REMOVED;
+    MyEvent.EventParam  = i;
+    ES_EnQueueFIFO(Deferred, MyEvent);
+  }
+}
+
+static uint32_t BestBatch(uint8_t Depth, Method_t How)
+{
+  ES_Event_t  MyEvent;
+  uint32_t    Start;
+  uint32_t    Cycles;
+  uint32_t    Best = UINT32_MAX;
+  uint16_t    i;
+  uint8_t     Trial;
+
+  for (Trial = 0; Trial < TRIALS; Trial++)
+  {
+    Start = _HW_GetCycleStamp();
+    for (i = 0; i < REPEATS; i++)
+    {
+      Fill(Depth);
+      if (OLD_LOOP == How)
+      {
+        while (ES_DeQueue(Deferred, &MyEvent),
+               MyEvent.EventType != ES_NO_EVENT)
+        {
+          ES_EnQueueLIFO(Target, MyEvent);
+        }
+      }
+      else if (SPLICE == How)
+      {
+        ES_SpliceQueue(Target, Deferred, ES_NO_EVENT);
+      }
+    }
+    Cycles = _HW_GetCycleStamp() - Start;
+    if (Cycles < Best)
     {
-      ES_PostToServiceLIFO(WhichService, RecalledEvent);
-      WereEventsPulled = true;
+      Best = Cycles;
     }
-  } while (RecalledEvent.EventType != ES_NO_EVENT);
-  return WereEventsPulled;
+  }
+  return Best;
+}
+
+int main(void)
+{
+  uint32_t    FillCycles;
+  uint32_t    OldCycles;
+  uint32_t    NewCycles;
+  uint8_t     Depth;
+
+#ifndef ES_HOST_BUILD
+  SysCtlClockSet(SYSCTL_SYSDIV_5 | SYSCTL_USE_PLL | SYSCTL_OSC_MAIN
+      | SYSCTL_XTAL_16MHZ);
+  TERMIO_Init();
+#endif
+  _HW_Timer_Init(ES_Timer_RATE_1mS);
+  puts("\rDepth  Loop  Splice (cycles)\r");
+
+  for (Depth = 1; Depth <= MAX_DEPTH; Depth++)
+  {
+    FillCycles = BestBatch(Depth, FILL_ONLY);
+    OldCycles = BestBatch(Depth, OLD_LOOP);
+    NewCycles = BestBatch(Depth, SPLICE);
+    OldCycles = (OldCycles > FillCycles) ? OldCycles - FillCycles : 0;
+    NewCycles = (NewCycles > FillCycles) ? NewCycles - FillCycles : 0;
+
+    printf("%5u %5lu %7lu\r\n", Depth, (unsigned long)(OldCycles / REPEATS),
+        (unsigned long)(NewCycles / REPEATS));
+  }
+
+#ifndef ES_HOST_BUILD
+  while (1)
+  {
+    ;
+  }
+#endif
+  return 0;
 }
 
+#endif
 /*------------------------------- Footnotes -------------------------------*/
 
 /*------------------------------ End of file ------------------------------*/
@@ -0,0 +1,233 @@
+/****************************************************************************
+ Module
+   ES_FlightRecorder.c
+
+ Revision
+   1.0.1
+
+ Description
+   Flight recorder for ES_Run: a circular log of the last
+   ES_FLIGHT_RECORDER_SIZE dispatches, each with the service, the event and
+   its parameter, the tick and the state the service was left in. It is
+   kept through a soft reset (reset button, watchdog), so after the exhibit
+   misbehaves the history can be printed with ES_FlightRecorderDump and
+   read on the host with Tools/FlightLog.py.
+
+ Notes
+   The log is in the .noinit section, see ES_NOINIT, and is only cleared
+   when its magic number is wrong, as it is after power up. A start up with
+   a good log just adds an ES_RECORD_RESET record to mark the reset.
+   DispatchOne calls ES_FlightRecordStart before each run function and
+   ES_FlightRecordEnd after it. The state is up to the service: the table
+   driven ones get it from ES_StateTableDispatch, and a hand written one
+   calls ES_FlightRecordState with its current state before it returns.
+   The record being run is kept in Current, which DispatchOne saves and
+   restores around each run, so a preemptive service's records nest inside
+   the one it preempted. A run function that lasts through 256 more
+   dispatches has its record overwritten, and its state goes to the record
+   that took its place.
+
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/19/26 23:59 ston    first pass
+
+****************************************************************************/
+// the common headers for I/O, C99 types
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// the framework headers
+#include "ES_Configure.h"
+#include "ES_Port.h"
+#include "ES_FlightRecorder.h"
+
+#ifdef ES_FLIGHT_RECORDER
+
+// module level defines
+#define RECORDER_MAGIC 0x464C5452UL
+#define NO_RECORD 0xFFFF
+
+// module level variables
+// the log, kept through a reset, see ES_NOINIT
+static struct
+{
+  uint32_t          Magic;    // RECORDER_MAGIC while the log is good
+  uint32_t          Total;    // how many records have ever been written
+  uint8_t           Head;     // where the next record goes
+  ES_FlightRecord_t Records[ES_FLIGHT_RECORDER_SIZE];
+} Log ES_NOINIT;
+
+// the record of the run function that is running, NO_RECORD between runs
+static uint16_t Current = NO_RECORD;
+
+/****************************************************************************
+ Function
+     ES_FlightRecorderInit
+ Parameters
+     none
+ Returns
+     nothing
+ Description
+     clears the log if it did not survive, otherwise marks the reset in it
+ Notes
+     called by ES_Initialize. Dump the log before that to see what led up
+     to the reset without the new records in it
+ Author
+     Sander Tonkens, 10/19/26, 23:59
+****************************************************************************/
+void ES_FlightRecorderInit(void)
+{
+  ES_Event_t ResetEvent;
+
+  if (Log.Magic != RECORDER_MAGIC)
+  {
+    Log.Total = 0;
+    Log.Head = 0;
+    Log.Magic = RECORDER_MAGIC;
+  }
+  else
+  {
+    ResetEvent.EventType = ES_NO_EVENT;
+    ResetEvent.EventParam = 0;
+    ES_FlightRecordStart(ES_RECORD_RESET, ResetEvent);
+  }
+  Current = NO_RECORD;
+}
+
+/****************************************************************************
+ Function
+     ES_FlightRecordStart
+ Parameters
+     uint8_t WhichService, the service being dispatched to
+     ES_Event_t ThisEvent, the event it is being dispatched
+ Returns
+     uint16_t, the record that was running, to hand to ES_FlightRecordEnd
+ Description
+     writes the dispatch into the next record, which becomes the current one
+ Notes
+     with preemption taking the record is a critical region, so a service
+     that preempts this one can not take the same record
+ Author
+     Sander Tonkens, 10/19/26, 23:59
+****************************************************************************/
+uint16_t ES_FlightRecordStart(uint8_t WhichService, ES_Event_t ThisEvent)
+{
+  ES_FlightRecord_t *pRecord;
+  uint16_t          Outer = Current;
+  uint8_t           Slot;
+
+#ifdef ES_PREEMPT_THRESHOLD
+  EnterCritical();
+#endif
+  Slot = Log.Head++;
+  Log.Total++;
+#ifdef ES_PREEMPT_THRESHOLD
+  ExitCritical();
+#endif
+  pRecord = &Log.Records[Slot];
+  pRecord->Tick = _HW_GetTickCount();
+  pRecord->EventParam = ThisEvent.EventParam;
+  pRecord->Service = WhichService;
+  pRecord->EventType = (uint8_t)ThisEvent.EventType;
+  pRecord->State = ES_NO_STATE;
+  pRecord->Error = false;
+  Current = Slot;
+  return Outer;
+}
+
+/****************************************************************************
+ Function
+     ES_FlightRecordEnd
+ Parameters
+     uint16_t Outer, what ES_FlightRecordStart returned
+     bool Error, true if the run function returned an error
+ Returns
+     nothing
+ Description
+     finishes the current record and goes back to the one it nested in
+ Notes
+
+ Author
+     Sander Tonkens, 10/19/26, 23:59
+****************************************************************************/
+void ES_FlightRecordEnd(uint16_t Outer, bool Error)
+{
+  if (Current != NO_RECORD)
+  {
+    Log.Records[Current].Error = Error;
+  }
+  Current = Outer;
+}
+
+/****************************************************************************
+ Function
+     ES_FlightRecordState
+ Parameters
+     uint8_t State, the state the service is in
+ Returns
+     nothing
+ Description
+     notes the running service's state in its record, the last call before
+     the run function returns is the one that stays
+ Notes
+     ignored outside a run function
+ Author
+     Sander Tonkens, 10/19/26, 23:59
+****************************************************************************/
+void ES_FlightRecordState(uint8_t State)
+{
+  if (Current != NO_RECORD)
+  {
+    Log.Records[Current].State = State;
+  }
+}
+
+/****************************************************************************
+ Function
+     ES_FlightRecorderDump
+ Parameters
+     none
+ Returns
+     nothing
+ Description
+     prints the log, oldest record first, one record per line as
+     "service event param tick state error", between a "FLIGHT total" line
+     and an "END" line, for Tools/FlightLog.py
+ Notes
+     blocks while it prints, about half a second for a full log
+ Author
+     Sander Tonkens, 10/19/26, 23:59
+****************************************************************************/
+void ES_FlightRecorderDump(void)
+{
+  ES_FlightRecord_t *pRecord;
+  uint16_t          Count;
+  uint8_t           Slot;
+
+  if (Log.Magic != RECORDER_MAGIC)
+  {
+    return;
+  }
+  if (Log.Total < ES_FLIGHT_RECORDER_SIZE)
+  {
+    Count = (uint16_t)Log.Total;
+    Slot = 0;
+  }
+  else
+  {
+    Count = ES_FLIGHT_RECORDER_SIZE;
+    Slot = Log.Head;
+  }
+  printf("\r\nFLIGHT %lu\r\n", (unsigned long)Log.Total);
+  for ( ; Count > 0; Count--, Slot++)
+  {
+    pRecord = &Log.Records[Slot];
+    printf("%u %u %u %u %u %u\r\n", pRecord->Service, pRecord->EventType,
+        pRecord->EventParam, pRecord->Tick, pRecord->State, pRecord->Error);
+  }
+  printf("END\r\n");
+}
+
+#endif /* ES_FLIGHT_RECORDER */
@@ -1,3 +1,4 @@
+//#define TEST
 /****************************************************************************
  Module
      EF_Framework.c
@@ -8,6 +9,34 @@
  History
  When           Who     What/Why
  -------------- ---     --------
+ 10/21/26 17:00 ston    ES_GetServiceData, a service's data is never NULL
+ 10/21/26 15:00 ston    Ready is always updated in a critical region, the
+                        interrupts post to it on the target too
+ 10/21/26 13:00 ston    TEST harness measures ES_RunStep's events per second
+ 10/21/26 12:00 ston    TEST harness for the post to run latency
+ 10/21/26 11:00 ston    recalled events go back to the queue level of their
+                        type, not always the normal one
+ 10/19/26 23:59 ston    dispatches go in the flight recorder
+ 10/19/26 23:58 ston    run functions are timed by the liveness monitor
+ 10/19/26 23:56 ston    optional urgent & background queue levels for each
+                        service, chosen by event type
+ 10/20/26 18:00 ston    ES_RunStep checks in with the liveness monitor
+ 10/20/26 14:00 ston    skip the run function for a Ready bit whose event
+                        was already taken by another context
+ 10/20/26 09:00 ston    ES_MULTI_INSTANCE is a host build option, the executor
+                        is left out of it
+ 10/19/26 23:54 ston    ES_SpliceToService, deferred events go back to the
+                        front of a queue as one block
+ 10/19/26 23:00 ston    tell the timers when an ES_TIMEOUT is dispatched
+ 10/19/26 22:00 ston    ES_EnQueueToService & ES_MarkServicesReady, so the
+                        timer tick can post its timeouts with one Ready update
+ 10/19/26 18:00 ston    optional batch dispatch, ES_BATCH_DISPATCH_SIZE
+ 10/19/26 17:00 ston    optional framework instances, ES_RunStep
+ 10/19/26 16:00 ston    ES_DispatchService & the ready hook for the host
+                        executor
+ 10/19/26 15:00 ston    optional preemptive services run from PendSV above
+                        ES_PREEMPT_THRESHOLD, per service dispatch latency
+ 10/19/26 13:00 ston    take the first input scan snapshot in ES_Initialize
  08/21/17 13:18 jec     added conditional call to initialize the port lines
                         for the hardware debugging of the framework/apps
  12/19/16 20:18 jec      changed includes to accomodate the change to a fixed
@@ -46,6 +75,9 @@
 #endif
 
 #include <stdio.h>
+#ifdef ES_MULTI_INSTANCE
+#include <stdlib.h>
+#endif
 
 #ifndef ES_CONFIGURE_H
 #error "ES_Configure.h was not included"
@@ -74,6 +106,11 @@ typedef struct
 
 /*---------------------------- Module Functions ---------------------------*/
 //static bool CheckSystemEvents( void );
+static void MarkReady(uint8_t WhichService);
+static bool DispatchOne(uint8_t WhichService);
+static bool EnQueue(uint8_t WhichService, ES_Event_t TheEvent, bool ToFront);
+static uint8_t DeQueue(uint8_t WhichService, ES_Event_t *pReturnEvent);
+static bool IsEmpty(uint8_t WhichService);
 
 /*---------------------------- Module Variables ---------------------------*/
 /****************************************************************************/
@@ -234,11 +271,105 @@ static ES_QueueDesc_t const EventQueues[NUM_SERVICES] = {
 #endif
 };
 
+#if defined(ES_URGENT_EVENT_LIST) || defined(ES_BACKGROUND_EVENT_LIST)
+#if !defined(ES_URGENT_EVENT_LIST) || !defined(ES_BACKGROUND_EVENT_LIST)
+#error "define both ES_URGENT_EVENT_LIST and ES_BACKGROUND_EVENT_LIST"
+#endif
+#define QUEUE_LEVELS
+// the levels, by priority, so the highest non-empty level of a service is
+// the MS bit of its Levels bitmap
+#define LEVEL_BACKGROUND 0
+#define LEVEL_NORMAL 1
+#define LEVEL_URGENT 2
+#define NUM_LEVELS 3
+
+static ES_EventType_t const UrgentEvents[] = { ES_URGENT_EVENT_LIST };
+static ES_EventType_t const BackgroundEvents[] = { ES_BACKGROUND_EVENT_LIST };
+
+// the level for each event type, filled in from the lists by ES_Initialize
+static uint8_t EventLevel[NUM_ES_EVENTS];
+#endif
+
+#ifdef ES_MULTI_INSTANCE
+// instances are allocated with calloc and selected per thread, which only
+// the host build supports
+#ifndef ES_HOST_BUILD
+#error "ES_MULTI_INSTANCE is only supported in the host build, define ES_HOST_BUILD"
+#endif
+#ifdef ES_PREEMPT_THRESHOLD
+#error "ES_MULTI_INSTANCE can not be combined with preemption"
+#endif
+/****************************************************************************/
+// Everything that belongs to one exhibit: its Ready bits, its own copy of
+// every queue and the data the timers & services keep per instance. The
+// tables above are shared, they only hold the functions & the queue sizes.
+struct ES_Instance_s
+{
+  uint16_t    Ready;
+  ES_Event_t  *pQueues[NUM_SERVICES];
+#ifdef QUEUE_LEVELS
+  uint8_t     Levels[NUM_SERVICES];
+  ES_Event_t  *pLevelQueues[NUM_SERVICES][NUM_LEVELS];
+#endif
+  void        *pData[ES_NUM_DATA_SLOTS];
+};
+
+// each thread runs its own instances, so each has its own current one
+static __thread ES_Instance_t *pCurrent;
+
+// the rest of this module works on the current instance
+#define Ready (pCurrent->Ready)
+#define QUEUE_MEM(Which) (pCurrent->pQueues[Which])
+#define LEVELS(Which) (pCurrent->Levels[Which])
+#define LEVEL_QUEUE(Which, Level) (pCurrent->pLevelQueues[Which][Level])
+#else
 /****************************************************************************/
-// Variable used to keep track of which queues have events in them
+// Variable used to keep track of which queues have events in them. The
+// interrupts post too (the timer tick, the short timer pool, the IR edges),
+// as do PendSV and the host executor's worker threads, so every
+// read-modify-write of it is done inside a critical region
 
 uint16_t Ready;
 
+#define QUEUE_MEM(Which) (EventQueues[Which].pMem)
+
+#ifdef QUEUE_LEVELS
+static ES_Event_t UrgentQueues[NUM_SERVICES][ES_URGENT_QUEUE_SIZE + 1];
+static ES_Event_t BackgroundQueues[NUM_SERVICES][ES_BACKGROUND_QUEUE_SIZE + 1];
+// bit n is set while level n of the service has events, so the level to
+// take the next event from is found without looking at the queues. A
+// service's Ready bit is set while any of its levels are
+static volatile uint8_t Levels[NUM_SERVICES];
+// each service's queue for each level, the normal one is the queue above
+static ES_Event_t *pLevelQueues[NUM_SERVICES][NUM_LEVELS];
+
+#define LEVELS(Which) (Levels[Which])
+#define LEVEL_QUEUE(Which, Level) (pLevelQueues[Which][Level])
+#endif
+#endif
+
+#ifdef ES_PREEMPT_THRESHOLD
+// Services at or above ES_PREEMPT_THRESHOLD are not run by ES_Run, they are
+// run from PendSV as soon as they are posted, preempting the run function of
+// any lower priority service. ActivePriority is the ceiling: only a ready
+// service above it may preempt. -1 means no preemptive service is running.
+#define PREEMPT_MASK ((uint16_t)(0xFFFF << ES_PREEMPT_THRESHOLD))
+static volatile int8_t ActivePriority = -1;
+// the preemptive services are held off until ES_Run starts
+static volatile bool PreemptEnabled = false;
+// set if a preemptive run function returned an error, ES_Run reports it
+static volatile bool PreemptFailed = false;
+#else
+#define PREEMPT_MASK ((uint16_t)0)
+#endif
+
+#ifdef ES_LATENCY_STATS
+// when each service's queue went from empty to non-empty, and the worst
+// time from then until its run function was called, in uS
+static uint32_t ReadyStamp[NUM_SERVICES];
+static uint32_t WorstLatency[NUM_SERVICES];
+#endif
+
 /*------------------------------ Module Code ------------------------------*/
 /****************************************************************************
  Function
@@ -259,6 +390,26 @@ ES_Return_t ES_Initialize(TimerRate_t NewRate)
 {
   uint8_t i;
   ES_Timer_Init(NewRate);  // start up the timer subsystem
+#ifdef ES_FLIGHT_RECORDER
+  ES_FlightRecorderInit(); // keeps the log from before a reset
+#endif
+#ifdef QUEUE_LEVELS
+  for (i = 0; i < ARRAY_SIZE(EventLevel); i++)
+  {
+    EventLevel[i] = LEVEL_NORMAL;
+  }
+  for (i = 0; i < ARRAY_SIZE(UrgentEvents); i++)
+  {
+    EventLevel[UrgentEvents[i]] = LEVEL_URGENT;
+  }
+  for (i = 0; i < ARRAY_SIZE(BackgroundEvents); i++)
+  {
+    EventLevel[BackgroundEvents[i]] = LEVEL_BACKGROUND;
+  }
+#endif
+#ifdef INPUT_SCAN_PORT_LIST
+  ES_InitInputScan();      // first snapshot for the input scan
+#endif
   // loop through the list testing for NULL pointers and
   for (i = 0; i < ARRAY_SIZE(ServDescList); i++)
   {
@@ -268,7 +419,18 @@ ES_Return_t ES_Initialize(TimerRate_t NewRate)
       return FailedPointer; // protect against NULL pointers
     }
     // and initializing the event queues (must happen before running inits)
-    ES_InitQueue(EventQueues[i].pMem, EventQueues[i].Size);
+    ES_InitQueue(QUEUE_MEM(i), EventQueues[i].Size);
+#ifdef QUEUE_LEVELS
+#ifndef ES_MULTI_INSTANCE
+    LEVEL_QUEUE(i, LEVEL_URGENT) = UrgentQueues[i];
+    LEVEL_QUEUE(i, LEVEL_BACKGROUND) = BackgroundQueues[i];
+#endif
+    LEVEL_QUEUE(i, LEVEL_NORMAL) = QUEUE_MEM(i);
+    ES_InitQueue(LEVEL_QUEUE(i, LEVEL_URGENT), ES_URGENT_QUEUE_SIZE + 1);
+    ES_InitQueue(LEVEL_QUEUE(i, LEVEL_BACKGROUND),
+        ES_BACKGROUND_QUEUE_SIZE + 1);
+    LEVELS(i) = 0;
+#endif
     // executing the init functions
     if (ServDescList[i].InitFunc(i) != true)
     {
@@ -301,44 +463,396 @@ ES_Return_t ES_Initialize(TimerRate_t NewRate)
 ****************************************************************************/
 ES_Return_t ES_Run(void)
 {
-  // make these static to improve speed
-  uint8_t         HighestPrior;
-  static ES_Event_t ThisEvent;
-
+#ifdef ES_PREEMPT_THRESHOLD
+  // everything is initialized, so let the preemptive services go, starting
+  // with anything their inits posted
+  PreemptEnabled = true;
+  _HW_PendPreempt();
+#endif
+#ifdef ES_LIVENESS
+  ES_LivenessStart();  // from here on the run functions have budgets
+#endif
   while (1)  // stay here unless we detect an error condition
-  { // loop through the list executing the run functions for services
-    // with a non-empty queue. Process any pending ints before testing
-    // Ready
-    while ((_HW_Process_Pending_Ints()) && (Ready != 0))
+  {
+    if (ES_RunStep() != Success)
     {
-      HighestPrior = ES_GetMSBitSet(Ready);
-      if (ES_DeQueue(EventQueues[HighestPrior].pMem, &ThisEvent) == 0)
-      {
-        Ready &= BitNum2ClrMask[HighestPrior]; // mark queue as now empty
-      }
+      return FailedRun;
+    }
+  }
+}
+
+/****************************************************************************
+ Function
+   ES_RunStep
+ Parameters
+   None
+ Returns
+   ES_Return_t : FailedRun if any of the run functions failed
+ Description
+   one pass of ES_Run: runs services until every queue is empty, then
+   gives the event checkers one go, and returns
+ Notes
+   lets a host step many instances in turn from one thread, select each
+   with ES_SelectInstance first
+ Author
+   Sander Tonkens, 10/19/26, 17:00
+****************************************************************************/
+ES_Return_t ES_RunStep(void)
+{
+  uint8_t HighestPrior;
+#ifdef ES_BATCH_DISPATCH_SIZE
+  uint16_t HigherMask;
+  uint8_t  BatchCount;
+#endif
+
+  // loop through the list executing the run functions for services
+  // with a non-empty queue. Process any pending ints before testing
+  // Ready. Preemptive services are left to PendSV.
+  while ((_HW_Process_Pending_Ints()) && ((Ready & ~PREEMPT_MASK) != 0))
+  {
+    HighestPrior = ES_GetMSBitSet(Ready & ~PREEMPT_MASK);
 #ifdef _INCLUDE_BASIC_FRAMEWORK_DEBUG_
-      _HW_DebugSetLine1();
+    _HW_DebugSetLine1();
 #endif
-      if (ServDescList[HighestPrior].RunFunc(ThisEvent).EventType !=
-          ES_NO_EVENT)
+#ifdef ES_BATCH_DISPATCH_SIZE
+    // drain up to a batch from this queue before going back round for the
+    // pending ints and a new search. Between events only a test of Ready
+    // against the services above this one is needed to see if something
+    // more urgent was posted
+    HigherMask = (uint16_t)(0xFFFFu << (HighestPrior + 1)) & ~PREEMPT_MASK;
+    BatchCount = 0;
+    do
+    {
+      if (DispatchOne(HighestPrior) != true)
       {
         return FailedRun;
       }
+    } while ((++BatchCount < ES_BATCH_DISPATCH_SIZE) &&
+             ((Ready & HigherMask) == 0) &&
+             ((Ready & BitNum2SetMask[HighestPrior]) != 0));
+#else
+    if (DispatchOne(HighestPrior) != true)
+    {
+      return FailedRun;
+    }
+#endif
 #ifdef _INCLUDE_BASIC_FRAMEWORK_DEBUG_
-      _HW_DebugClearLine1();
+    _HW_DebugClearLine1();
+#endif
+  }
+#ifdef ES_PREEMPT_THRESHOLD
+  if (PreemptFailed)
+  {
+    return FailedRun;
+  }
 #endif
-    }
 
 #ifdef _INCLUDE_BASIC_FRAMEWORK_DEBUG_
-    _HW_DebugSetLine2();
+  _HW_DebugSetLine2();
+#endif
+  // all the queues are empty, so look for new user detected events
+  ES_CheckUserEvents();
+#ifdef ES_LIVENESS
+  ES_LivenessCheckIn();  // the event checkers came back, the loop is alive
 #endif
-    // all the queues are empty, so look for new user detected events
-    ES_CheckUserEvents();
 #ifdef _INCLUDE_BASIC_FRAMEWORK_DEBUG_
-    _HW_DebugClearLine2();
+  _HW_DebugClearLine2();
+#endif
+  return Success;
+}
+
+#ifdef ES_MULTI_INSTANCE
+/****************************************************************************
+ Function
+   ES_CreateInstance
+ Parameters
+   None
+ Returns
+   ES_Instance_t * : the new instance, NULL if out of memory
+ Description
+   makes a new, empty, framework instance with its own queues. Select it
+   and call ES_Initialize to start its services
+ Notes
+
+ Author
+   Sander Tonkens, 10/19/26, 17:00
+****************************************************************************/
+ES_Instance_t *ES_CreateInstance(void)
+{
+  ES_Instance_t *pNew;
+  uint8_t       i;
+
+  pNew = calloc(1, sizeof(ES_Instance_t));
+  if (pNew == NULL)
+  {
+    return NULL;
+  }
+  for (i = 0; i < ARRAY_SIZE(EventQueues); i++)
+  {
+    pNew->pQueues[i] = calloc(EventQueues[i].Size, sizeof(ES_Event_t));
+#ifdef QUEUE_LEVELS
+    pNew->pLevelQueues[i][LEVEL_URGENT] =
+        calloc(ES_URGENT_QUEUE_SIZE + 1, sizeof(ES_Event_t));
+    pNew->pLevelQueues[i][LEVEL_BACKGROUND] =
+        calloc(ES_BACKGROUND_QUEUE_SIZE + 1, sizeof(ES_Event_t));
+    if ((pNew->pLevelQueues[i][LEVEL_URGENT] == NULL) ||
+        (pNew->pLevelQueues[i][LEVEL_BACKGROUND] == NULL))
+    {
+      ES_DestroyInstance(pNew);
+      return NULL;
+    }
+#endif
+    if (pNew->pQueues[i] == NULL)
+    {
+      ES_DestroyInstance(pNew);
+      return NULL;
+    }
+  }
+  return pNew;
+}
+
+/****************************************************************************
+ Function
+   ES_DestroyInstance
+ Parameters
+   ES_Instance_t * : the instance to free
+ Returns
+   None
+ Description
+   frees an instance, its queues and its per instance data
+ Notes
+   must not be the current instance of any thread
+ Author
+   Sander Tonkens, 10/19/26, 17:00
+****************************************************************************/
+void ES_DestroyInstance(ES_Instance_t *pInstance)
+{
+  uint8_t i;
+
+  if (pInstance == NULL)
+  {
+    return;
+  }
+  for (i = 0; i < ARRAY_SIZE(EventQueues); i++)
+  {
+    free(pInstance->pQueues[i]);
+#ifdef QUEUE_LEVELS
+    free(pInstance->pLevelQueues[i][LEVEL_URGENT]);
+    free(pInstance->pLevelQueues[i][LEVEL_BACKGROUND]);
 #endif
   }
+  for (i = 0; i < ES_NUM_DATA_SLOTS; i++)
+  {
+    free(pInstance->pData[i]);
+  }
+  free(pInstance);
+}
+
+/****************************************************************************
+ Function
+   ES_SelectInstance
+ Parameters
+   ES_Instance_t * : the instance the framework calls should work on
+ Returns
+   None
+ Description
+   every framework call from this thread, and every post, timer and service
+   run they lead to, works on this instance until the next select
+ Notes
+
+ Author
+   Sander Tonkens, 10/19/26, 17:00
+****************************************************************************/
+void ES_SelectInstance(ES_Instance_t *pInstance)
+{
+  pCurrent = pInstance;
+}
+
+/****************************************************************************
+ Function
+   ES_GetInstanceData
+ Parameters
+   uint8_t : which slot, a service's priority or ES_TIMER_DATA_SLOT
+   size_t : how big the slot's data is
+ Returns
+   void * : the current instance's data for that slot, NULL if there is no
+            current instance or no memory
+ Description
+   the per instance home for module variables. The block is allocated, and
+   zeroed, the first time it is asked for
+ Notes
+   a slot must always be asked for with the same size
+ Author
+   Sander Tonkens, 10/19/26, 17:00
+****************************************************************************/
+void *ES_GetInstanceData(uint8_t Slot, size_t Size)
+{
+  if ((pCurrent == NULL) || (Slot >= ES_NUM_DATA_SLOTS))
+  {
+    return NULL;
+  }
+  if (pCurrent->pData[Slot] == NULL)
+  {
+    pCurrent->pData[Slot] = calloc(1, Size);
+  }
+  return pCurrent->pData[Slot];
+}
+
+/****************************************************************************
+ Function
+   ES_GetServiceData
+ Parameters
+   uint8_t : which slot, the service's priority
+   size_t : how big the service's data is
+ Returns
+   void * : the current instance's data for the service, never NULL
+ Description
+   ES_GetInstanceData for ES_SERVICE_DATA. The services use their data
+   through it on every line and have no way to carry on without it, so
+   instead of returning NULL this reports the problem and stops the process
+ Notes
+   only the timers, which fail their calls instead, use ES_GetInstanceData
+   directly
+ Author
+   Sander Tonkens, 10/21/26, 17:00
+****************************************************************************/
+void *ES_GetServiceData(uint8_t Slot, size_t Size)
+{
+  void *pData = ES_GetInstanceData(Slot, Size);
+
+  if (pData == NULL)
+  {
+    fprintf(stderr, "ES_SERVICE_DATA for service %u: %s\n", Slot,
+        (pCurrent == NULL) ? "no instance selected" : "out of memory");
+    abort();
+  }
+  return pData;
+}
+#endif
+
+#ifdef ES_PREEMPT_THRESHOLD
+/****************************************************************************
+ Function
+   ES_RunPreemptive
+ Parameters
+   None
+ Returns
+   None
+ Description
+   runs the ready preemptive services, highest priority first, as long as
+   they are above the priority of the service that was running when we got
+   here. Called from PendSV, and directly from a post made by a preemptive
+   service to a higher priority one, which nests the higher run function
+   inside the lower one, the way a QK kernel does it.
+ Notes
+   the ceiling (ActivePriority) is what keeps a service from being
+   re-entered, not turning the interrupts off
+ Author
+   Sander Tonkens, 10/19/26, 15:00
+****************************************************************************/
+void ES_RunPreemptive(void)
+{
+  int8_t SavedPriority = ActivePriority;
+  uint16_t Candidates;
+  uint8_t HighestPrior;
+
+  if (!PreemptEnabled)
+  {
+    return;
+  }
+  while ((Candidates = (Ready & PREEMPT_MASK)) != 0)
+  {
+    HighestPrior = ES_GetMSBitSet(Candidates);
+    if ((int8_t)HighestPrior <= SavedPriority)
+    {
+      break; // nothing ready above the ceiling, back to the one we preempted
+    }
+    ActivePriority = HighestPrior;
+    if (DispatchOne(HighestPrior) != true)
+    {
+      PreemptFailed = true;
+    }
+    ActivePriority = SavedPriority;
+  }
+}
+#endif
+
+#ifdef ES_HOST_BUILD
+/****************************************************************************
+ Function
+   ES_DispatchService
+ Parameters
+   uint8_t : Which service (index into ServDescList)
+ Returns
+   bool : false if the service's run function returned an error
+ Description
+   runs the service's next event, for the host executor, which takes the
+   place of ES_Run and decides which service runs on which thread
+ Notes
+   the caller must make sure that a service is only ever dispatched from one
+   thread at a time
+ Author
+   Sander Tonkens, 10/19/26, 16:00
+****************************************************************************/
+bool ES_DispatchService(uint8_t WhichService)
+{
+  if (WhichService >= ARRAY_SIZE(EventQueues))
+  {
+    return false;
+  }
+  return DispatchOne(WhichService);
+}
+
+/****************************************************************************
+ Function
+   ES_ServiceHasEvents
+ Parameters
+   uint8_t : Which service (index into ServDescList)
+ Returns
+   bool : true if there is an event waiting for the service
+ Description
+   lets the host executor decide whether a service needs to be run again
+ Notes
+
+ Author
+   Sander Tonkens, 10/19/26, 16:00
+****************************************************************************/
+bool ES_ServiceHasEvents(uint8_t WhichService)
+{
+  if (WhichService >= ARRAY_SIZE(EventQueues))
+  {
+    return false;
+  }
+  return !IsEmpty(WhichService);
+}
+#endif
+
+#ifdef ES_LATENCY_STATS
+/****************************************************************************
+ Function
+   ES_GetWorstLatency
+ Parameters
+   uint8_t : Which service (index into ServDescList)
+ Returns
+   uint32_t : worst time, in uS, that the service has had an event waiting
+              before its run function was called
+ Description
+   measured from the post that made the service's queue non-empty, so it
+   shows how long the service was held off by the other services
+ Notes
+
+ Author
+   Sander Tonkens, 10/19/26, 15:00
+****************************************************************************/
+uint32_t ES_GetWorstLatency(uint8_t WhichService)
+{
+  if (WhichService >= ARRAY_SIZE(EventQueues))
+  {
+    return 0;
+  }
+  return WorstLatency[WhichService];
 }
+#endif
 
 /****************************************************************************
  Function
@@ -360,13 +874,13 @@ bool ES_PostAll(ES_Event_t ThisEvent)
   // loop through the list executing the post functions
   for (i = 0; i < ARRAY_SIZE(EventQueues); i++)
   {
-    if (ES_EnQueueFIFO(EventQueues[i].pMem, ThisEvent) != true)
+    if (EnQueue(i, ThisEvent, false) != true)
     {
       break; // this is a failed post
     }
     else
     {
-      Ready |= BitNum2SetMask[i]; // show queue as non-empty
+      MarkReady(i); // show queue as non-empty
     }
   }
   if (i == ARRAY_SIZE(EventQueues))    // if no failures
@@ -397,10 +911,9 @@ bool ES_PostAll(ES_Event_t ThisEvent)
 bool ES_PostToService(uint8_t WhichService, ES_Event_t TheEvent)
 {
   if ((WhichService < ARRAY_SIZE(EventQueues)) &&
-      (ES_EnQueueFIFO(EventQueues[WhichService].pMem, TheEvent) ==
-        true))
+      (EnQueue(WhichService, TheEvent, false) == true))
   {
-    Ready |= BitNum2SetMask[WhichService]; // show queue as non-empty
+    MarkReady(WhichService); // show queue as non-empty
     return true;
   }
   else
@@ -427,10 +940,9 @@ bool ES_PostToService(uint8_t WhichService, ES_Event_t TheEvent)
 bool ES_PostToServiceLIFO(uint8_t WhichService, ES_Event_t TheEvent)
 {
   if ((WhichService < ARRAY_SIZE(EventQueues)) &&
-      (ES_EnQueueLIFO(EventQueues[WhichService].pMem, TheEvent) ==
-        true))
+      (EnQueue(WhichService, TheEvent, true) == true))
   {
-    Ready |= BitNum2SetMask[WhichService]; // show queue as non-empty
+    MarkReady(WhichService); // show queue as non-empty
     return true;
   }
   else
@@ -439,9 +951,373 @@ bool ES_PostToServiceLIFO(uint8_t WhichService, ES_Event_t TheEvent)
   }
 }
 
+/****************************************************************************
+ Function
+   ES_EnQueueToService
+ Parameters
+   uint8_t : Which service to post to (index into ServDescList)
+   ES_Event : The Event to be posted
+ Returns
+   boolean : False if the service does not exist or its queue is full
+ Description
+   puts the event in the service's queue without setting its Ready bit
+ Notes
+   for the timer tick, which enqueues all of a tick's timeouts and then
+   sets their Ready bits together with ES_MarkServicesReady. Anyone else
+   should use ES_PostToService
+ Author
+   Sander Tonkens, 10/19/26, 22:00
+****************************************************************************/
+bool ES_EnQueueToService(uint8_t WhichService, ES_Event_t TheEvent)
+{
+  return (WhichService < ARRAY_SIZE(EventQueues)) &&
+         EnQueue(WhichService, TheEvent, false);
+}
+
+/****************************************************************************
+ Function
+   ES_MarkServicesReady
+ Parameters
+   uint16_t : the services to mark, bit n for service n
+ Returns
+   nothing
+ Description
+   sets the Ready bits of services that ES_EnQueueToService has put events
+   in for, with a single update when nothing else needs to know
+ Notes
+   with preemption, the latency stats or the host executor each service
+   still goes through MarkReady, highest first. The single update is still
+   a read-modify-write, and it is made from one interrupt (the tick or the
+   short timer pool) that another can interrupt, so it is locked too
+ Author
+   Sander Tonkens, 10/19/26, 22:00
+****************************************************************************/
+void ES_MarkServicesReady(uint16_t ServiceMask)
+{
+#if defined(ES_PREEMPT_THRESHOLD) || defined(ES_LATENCY_STATS) || \
+  defined(ES_HOST_BUILD)
+  uint8_t WhichService;
+
+  while (ServiceMask != 0)
+  {
+    WhichService = ES_GetMSBitSet(ServiceMask);
+    ServiceMask &= BitNum2ClrMask[WhichService];
+    MarkReady(WhichService);
+  }
+#else
+  EnterCritical();
+  Ready |= ServiceMask;
+  ExitCritical();
+#endif
+}
+
+/****************************************************************************
+ Function
+   ES_SpliceToService
+ Parameters
+   uint8_t : Which service to move the events to (index into ServDescList)
+   ES_Event * pFrom : the Queue to move them from
+   ES_EventType_t Match : only events of this type are moved, ES_NO_EVENT
+                          moves them all
+ Returns
+   uint8_t : the number of events moved
+ Description
+   moves events, with ES_SpliceQueue, to the front of the service's queue in
+   the order they were in, and sets the service's Ready bit once
+ Notes
+   used by the Defer/Recall event capability. With the queue levels each
+   event goes back to the front of the level its type is posted to, so a
+   deferred urgent event is still urgent, and the order is kept within
+   each level
+ Author
+   Sander Tonkens, 10/19/26, 23:54
+****************************************************************************/
+uint8_t ES_SpliceToService(uint8_t WhichService, ES_Event_t *pFrom,
+    ES_EventType_t Match)
+{
+  uint8_t Moved = 0;
+#ifdef QUEUE_LEVELS
+  uint8_t Level;
+  uint8_t MovedToLevel;
+#endif
+
+  if (WhichService < ARRAY_SIZE(EventQueues))
+  {
+#ifdef QUEUE_LEVELS
+    for (Level = 0; Level < NUM_LEVELS; Level++)
+    {
+      MovedToLevel = 0;
+      if (ES_NO_EVENT == Match)
+      {
+        MovedToLevel = ES_SpliceQueueClass(LEVEL_QUEUE(WhichService, Level),
+            pFrom, EventLevel, Level);
+      }
+      else if (EventLevel[Match] == Level)
+      {
+        MovedToLevel = ES_SpliceQueue(LEVEL_QUEUE(WhichService, Level),
+            pFrom, Match);
+      }
+      if (MovedToLevel > 0)
+      {
+        EnterCritical();
+        LEVELS(WhichService) |= BitNum2SetMask[Level];
+        ExitCritical();
+        Moved += MovedToLevel;
+      }
+    }
+#else
+    Moved = ES_SpliceQueue(QUEUE_MEM(WhichService), pFrom, Match);
+#endif
+    if (Moved > 0)
+    {
+      MarkReady(WhichService); // show queue as non-empty
+    }
+  }
+  return Moved;
+}
+
 //*********************************
 // private functions
 //*********************************
+/****************************************************************************
+ Function
+   MarkReady
+ Parameters
+   uint8_t : Which service just had an event posted
+ Returns
+   nothing
+ Description
+   sets the service's Ready bit and, for a preemptive service above the
+   running one, gets it run: straight away if we are already in PendSV,
+   otherwise by pending PendSV
+ Notes
+   Ready is changed from more than one context, so the read-modify-write
+   is done inside a critical region
+ Author
+   Sander Tonkens, 10/19/26, 15:00
+****************************************************************************/
+static void MarkReady(uint8_t WhichService)
+{
+  EnterCritical();
+#ifdef ES_LATENCY_STATS
+  if ((Ready & BitNum2SetMask[WhichService]) == 0)
+  {
+    ReadyStamp[WhichService] = _HW_GetCycleStamp();
+  }
+#endif
+  Ready |= BitNum2SetMask[WhichService];
+  ExitCritical();
+#if defined(ES_HOST_BUILD) && !defined(ES_MULTI_INSTANCE)
+  ES_HostServiceReady(WhichService);
+#endif
+#ifdef ES_PREEMPT_THRESHOLD
+  if (PreemptEnabled && (WhichService >= ES_PREEMPT_THRESHOLD) &&
+      ((int8_t)WhichService > ActivePriority))
+  {
+    if (_HW_InPreemptContext())
+    {
+      ES_RunPreemptive();
+    }
+    else
+    {
+      _HW_PendPreempt();
+    }
+  }
+#endif
+}
+
+/****************************************************************************
+ Function
+   DispatchOne
+ Parameters
+   uint8_t : Which service to run
+ Returns
+   bool : false if the service's run function returned an error
+ Description
+   takes the next event from the service's queue, clears its Ready bit if
+   that emptied the queue, and calls its run function with the event
+ Notes
+
+ Author
+   Sander Tonkens, 10/19/26, 15:00
+****************************************************************************/
+static bool DispatchOne(uint8_t WhichService)
+{
+  ES_Event_t ThisEvent;
+  bool Result;
+#ifdef ES_FLIGHT_RECORDER
+  uint16_t OuterRecord;
+#endif
+
+#ifdef ES_LATENCY_STATS
+  uint32_t Latency = _HW_USSince(ReadyStamp[WhichService]);
+  if (Latency > WorstLatency[WhichService])
+  {
+    WorstLatency[WhichService] = Latency;
+  }
+#endif
+  if (DeQueue(WhichService, &ThisEvent) == 0)
+  {
+    // a post may have landed since the dequeue, so look again with the
+    // other contexts held off before clearing the bit
+    EnterCritical();
+    if (IsEmpty(WhichService))
+    {
+      Ready &= BitNum2ClrMask[WhichService]; // mark queue as now empty
+    }
+    ExitCritical();
+  }
+#ifdef ES_LATENCY_STATS
+  else
+  {
+    // the next event has been waiting at least since now
+    ReadyStamp[WhichService] = _HW_GetCycleStamp();
+  }
+#endif
+  if (ThisEvent.EventType == ES_NO_EVENT)
+  {
+    // the queue was empty: a post puts the event in the queue and then sets
+    // the Ready bit, and in between another context (a worker thread, or a
+    // preemptive service) can take it. The late Ready bit then gets us here
+    // with nothing to run, so don't hand ES_NO_EVENT to the run function
+    return true;
+  }
+  if (ThisEvent.EventType == ES_TIMEOUT)
+  {
+    ES_Timer_TimeoutTaken(ThisEvent.EventParam); // next periodic can post
+  }
+#ifdef ES_FLIGHT_RECORDER
+  OuterRecord = ES_FlightRecordStart(WhichService, ThisEvent);
+#endif
+#ifdef ES_LIVENESS
+  ES_LivenessEnter(WhichService, ThisEvent);
+#endif
+  Result = ServDescList[WhichService].RunFunc(ThisEvent).EventType ==
+           ES_NO_EVENT;
+#ifdef ES_LIVENESS
+  ES_LivenessLeave(WhichService);
+#endif
+#ifdef ES_FLIGHT_RECORDER
+  ES_FlightRecordEnd(OuterRecord, !Result);
+#endif
+  return Result;
+}
+
+/****************************************************************************
+ Function
+   EnQueue
+ Parameters
+   uint8_t : Which service to post to (index into ServDescList)
+   ES_Event : The Event to be posted
+   bool : true to put it at the front of its queue, false for the end
+ Returns
+   bool : False if the queue was full
+ Description
+   puts the event in the service's queue, or with the queue levels in the
+   queue for the event's level, and marks that level as having events
+ Notes
+   does not set the Ready bit, the callers do that
+ Author
+   Sander Tonkens, 10/19/26, 23:56
+****************************************************************************/
+static bool EnQueue(uint8_t WhichService, ES_Event_t TheEvent, bool ToFront)
+{
+#ifdef QUEUE_LEVELS
+  uint8_t     Level = LEVEL_NORMAL;
+  ES_Event_t  *pQueue;
+  bool        Added;
+
+  if (TheEvent.EventType < NUM_ES_EVENTS)
+  {
+    Level = EventLevel[TheEvent.EventType];
+  }
+  pQueue = LEVEL_QUEUE(WhichService, Level);
+  Added = ToFront ? ES_EnQueueLIFO(pQueue, TheEvent) :
+      ES_EnQueueFIFO(pQueue, TheEvent);
+  if (Added)
+  {
+    EnterCritical();
+    LEVELS(WhichService) |= BitNum2SetMask[Level];
+    ExitCritical();
+  }
+  return Added;
+#else
+  return ToFront ? ES_EnQueueLIFO(QUEUE_MEM(WhichService), TheEvent) :
+         ES_EnQueueFIFO(QUEUE_MEM(WhichService), TheEvent);
+#endif
+}
+
+/****************************************************************************
+ Function
+   DeQueue
+ Parameters
+   uint8_t : Which service to take an event for
+   ES_Event * pReturnEvent : used to return the event taken
+ Returns
+   uint8_t : 0 if that may have emptied the service's queues
+ Description
+   takes the next event from the service's queue. With the queue levels it
+   is taken from the highest level that has events, found from the service's
+   Levels bitmap, and the level's bit is cleared if that emptied it
+ Notes
+   ES_NO_EVENT if there was nothing to take
+ Author
+   Sander Tonkens, 10/19/26, 23:56
+****************************************************************************/
+static uint8_t DeQueue(uint8_t WhichService, ES_Event_t *pReturnEvent)
+{
+#ifdef QUEUE_LEVELS
+  uint8_t     Level;
+  ES_Event_t  *pQueue;
+
+  if (LEVELS(WhichService) == 0)
+  {
+    pReturnEvent->EventType   = ES_NO_EVENT;
+    pReturnEvent->EventParam  = 0;
+    return 0;
+  }
+  Level = ES_GetMSBitSet(LEVELS(WhichService));
+  pQueue = LEVEL_QUEUE(WhichService, Level);
+  if (ES_DeQueue(pQueue, pReturnEvent) == 0)
+  {
+    // a post may have landed since the dequeue, so look again with the
+    // other contexts held off before clearing the bit
+    EnterCritical();
+    if (ES_IsQueueEmpty(pQueue))
+    {
+      LEVELS(WhichService) &= BitNum2ClrMask[Level];
+    }
+    ExitCritical();
+  }
+  return LEVELS(WhichService);
+#else
+  return ES_DeQueue(QUEUE_MEM(WhichService), pReturnEvent);
+#endif
+}
+
+/****************************************************************************
+ Function
+   IsEmpty
+ Parameters
+   uint8_t : Which service
+ Returns
+   bool : true if the service has no events waiting, at any level
+ Description
+   see above
+ Notes
+
+ Author
+   Sander Tonkens, 10/19/26, 23:56
+****************************************************************************/
+static bool IsEmpty(uint8_t WhichService)
+{
+#ifdef QUEUE_LEVELS
+  return LEVELS(WhichService) == 0;
+#else
+  return ES_IsQueueEmpty(QUEUE_MEM(WhichService));
+#endif
+}
+
 #if 0
 /****************************************************************************
  Function
@@ -471,6 +1347,152 @@ static bool CheckSystemEvents(void)
   return false;
 }
 
+#endif
+
+#ifdef TEST
+/* measures the dispatch loop with the services in ES_Configure.h, posting
+   them ES_AUDIO_END, which none of them handles (build with ES_HostPort.c
+   in place of ES_Port.c, and stub services, to run it on the host).
+   It prints the events per second ES_RunStep gets through, for a backlog
+   of 1 to 16 events in every queue (as many as fit). Each backlog is
+   posted and then ES_RunStep is timed running it dry, over REPEATS
+   backlogs. Build with and without ES_BATCH_DISPATCH_SIZE to compare the
+   two loops.
+   Before that, with ES_LATENCY_STATS, the worst post to run latency of each
+   service. For each hold off time it posts an event to every service,
+   busy waits for the hold off, as a long run function of a lower priority
+   service would, then runs the queues dry and prints ES_GetWorstLatency
+   for each service. The hold offs go up, so each line's worst is that hold
+   off's. Run to completion, every service should show about the hold off;
+   with ES_PREEMPT_THRESHOLD the preemptive services run from PendSV as the
+   event is posted and stay near 0 */
+#include <stdio.h>
+#ifndef ES_HOST_BUILD
+#include "driverlib/sysctl.h"
+#include "termio.h"
+#endif
+
+// an event every service ignores, and so is in range of the level table
+#define TEST_EVENT ES_AUDIO_END
+#define MAX_BACKLOG 16
+#define REPEATS 1000
+
+static uint16_t PostBacklog(uint8_t Backlog)
+{
+  ES_Event_t  ThisEvent = { TEST_EVENT, 0 };
+  uint16_t    Posted = 0;
+  uint8_t     WhichService;
+  uint8_t     i;
+
+  for (WhichService = 0; WhichService < NUM_SERVICES; WhichService++)
+  {
+    for (i = 0; (i < Backlog) && ES_PostToService(WhichService, ThisEvent);
+         i++)
+    {
+      Posted++;
+    }
+  }
+  return Posted;
+}
+
+static void TestThroughput(void)
+{
+  uint64_t  Cycles;
+  uint32_t  Posted;
+  uint32_t  Start;
+  uint16_t  i;
+  uint8_t   Backlog;
+
+#ifdef ES_BATCH_DISPATCH_SIZE
+  printf("\rES_BATCH_DISPATCH_SIZE %u\r\n", ES_BATCH_DISPATCH_SIZE);
+#else
+  puts("\rno batch dispatch\r");
+#endif
+  puts("\rBacklog  Events  Events/s\r");
+  for (Backlog = 1; Backlog <= MAX_BACKLOG; Backlog *= 2)
+  {
+    Cycles = 0;
+    Posted = 0;
+    for (i = 0; i < REPEATS; i++)
+    {
+      Posted += PostBacklog(Backlog);
+      Start = _HW_GetCycleStamp();
+      ES_RunStep();
+      Cycles += _HW_GetCycleStamp() - Start;
+    }
+    printf("%7u %7lu %9lu\r\n", Backlog, (unsigned long)(Posted / REPEATS),
+        (unsigned long)((Cycles == 0) ? 0 :
+        ((uint64_t)Posted * ES_CLOCK_HZ) / Cycles));
+  }
+}
+
+#ifdef ES_LATENCY_STATS
+static const uint32_t HoldOffUS[] = { 0, 100, 1000, 5000 };
+
+static void TestLatency(void)
+{
+  ES_Event_t  ThisEvent;
+  uint32_t    Start;
+  uint8_t     WhichHoldOff;
+  uint8_t     WhichService;
+
+  puts("\rHold off  worst latency of each service (uS)\r");
+  ThisEvent.EventType = TEST_EVENT;
+  ThisEvent.EventParam = 0;
+  for (WhichHoldOff = 0; WhichHoldOff < ARRAY_SIZE(HoldOffUS); WhichHoldOff++)
+  {
+    for (WhichService = 0; WhichService < NUM_SERVICES; WhichService++)
+    {
+      ES_PostToService(WhichService, ThisEvent);
+    }
+    Start = _HW_GetCycleStamp();
+    while (_HW_USSince(Start) < HoldOffUS[WhichHoldOff])
+    {
+      ;
+    }
+    ES_RunStep();
+    printf("%8lu ", (unsigned long)HoldOffUS[WhichHoldOff]);
+    for (WhichService = 0; WhichService < NUM_SERVICES; WhichService++)
+    {
+      printf(" %5lu", (unsigned long)ES_GetWorstLatency(WhichService));
+    }
+    printf("\r\n");
+  }
+}
+#endif
+
+int main(void)
+{
+#ifndef ES_HOST_BUILD
+  SysCtlClockSet(SYSCTL_SYSDIV_5 | SYSCTL_USE_PLL | SYSCTL_OSC_MAIN
+      | SYSCTL_XTAL_16MHZ);
+  TERMIO_Init();
+#endif
+  if (ES_Initialize(ES_Timer_RATE_1mS) != Success)
+  {
+    puts("\rES_Initialize failed\r");
+    return 1;
+  }
+#ifdef ES_PREEMPT_THRESHOLD
+  PreemptEnabled = true;
+  _HW_PendPreempt();
+#endif
+  ES_RunStep();   // the events the inits posted
+
+#ifdef ES_LATENCY_STATS
+  TestLatency();    // first, before the backlogs add to the worst
+#endif
+  TestThroughput();
+
+#ifndef ES_HOST_BUILD
+  while (1)
+  {
+    ;
+  }
+#endif
+  return 0;
+}
+
 #endif
 /*------------------------------- Footnotes -------------------------------*/
 /*------------------------------ End of file ------------------------------*/
@@ -0,0 +1,716 @@
+//#define TEST
+/****************************************************************************
+ Module
+     ES_HSM.c
+
+ Description
+     Table driven hierarchical state machine engine, see ES_HSM.h
+
+ Notes
+     The template machines recurse: every level re-runs its parent's run
+     function for the ES_EXIT & ES_ENTRY events and forwards each event
+     down by hand from its During function. Here the hierarchy is data, so
+     an event walks up from the leaf in a loop and a transition walks the
+     exit & entry chains between the leaf, the least common ancestor and
+     the target
+
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/20/26 14:00 ston     added the TEST machine and transition benchmark
+ 10/19/26 21:00 ston     Began Coding
+****************************************************************************/
+
+/*----------------------------- Include Files -----------------------------*/
+#include "ES_Configure.h"
+#include "ES_Framework.h"
+#include "ES_HSM.h"
+
+/*---------------------------- Module Functions ---------------------------*/
+static uint8_t FindLCA(const ES_HSM_t *pMachine, uint8_t StateA,
+    uint8_t StateB);
+static void EnterDown(ES_HSM_t *pMachine, uint8_t From, uint8_t Target,
+    ES_Event_t ThisEvent);
+static void Transition(ES_HSM_t *pMachine, uint8_t Source, uint8_t Target,
+    ES_Event_t ThisEvent);
+
+/*------------------------------ Module Code ------------------------------*/
+/****************************************************************************
+ Function
+     ES_HSMInit
+ Parameters
+     ES_HSM_t *pMachine, the machine to set up
+ Returns
+     bool, false if the state array is not a valid hierarchy
+ Description
+     Checks the state array and fills in the machine's least common
+     ancestor table
+ Notes
+     Call once, from the service's init function, before ES_HSMStart.
+     Fails if a parent or initial child is not a state, if an initial child
+     is not a child of its state or if the nesting is deeper than
+     ES_HSM_MAX_DEPTH (which includes a loop of parents)
+ Author
+     Sander Tonkens, 10/19/26, 21:00
+****************************************************************************/
+bool ES_HSMInit(ES_HSM_t *pMachine)
+{
+  const ES_HSMState_t *pStates = pMachine->pStates;
+  uint8_t NumStates = pMachine->NumStates;
+  uint8_t i;
+  uint8_t j;
+
+  if ((NumStates == 0) || (NumStates >= ES_HSM_HANDLED) ||
+      (pMachine->InitialState >= NumStates) ||
+      (pStates[pMachine->InitialState].Parent != ES_HSM_NO_STATE))
+  {
+    return false;
+  }
+  for (i = 0; i < NumStates; i++)
+  {
+    uint8_t Depth = 0;
+    uint8_t Ancestor = pStates[i].Parent;
+
+    if (pStates[i].InitialChild != ES_HSM_NO_STATE)
+    {
+      if ((pStates[i].InitialChild >= NumStates) ||
+          (pStates[pStates[i].InitialChild].Parent != i))
+      {
+        return false;
+      }
+    }
+    for ( ; Ancestor != ES_HSM_NO_STATE; Ancestor = pStates[Ancestor].Parent)
+    {
+      if ((Ancestor >= NumStates) || (++Depth >= ES_HSM_MAX_DEPTH))
+      {
+        return false;
+      }
+    }
+  }
+  for (i = 0; i < NumStates; i++)
+  {
+    for (j = 0; j < NumStates; j++)
+    {
+      pMachine->pLCA[(i * NumStates) + j] = FindLCA(pMachine, i, j);
+    }
+  }
+  pMachine->Current = ES_HSM_NO_STATE;
+  return true;
+}
+
+/****************************************************************************
+ Function
+     ES_HSMStart
+ Parameters
+     ES_HSM_t *pMachine, the machine to start
+     ES_Event_t ThisEvent, passed to the entry functions
+ Returns
+     nothing
+ Description
+     Forgets any history and enters the initial state, drilling down
+     through initial children to a leaf
+ Notes
+     Does not run any exit functions, so it restarts a machine that is
+     already running from scratch
+ Author
+     Sander Tonkens, 10/19/26, 21:00
+****************************************************************************/
+void ES_HSMStart(ES_HSM_t *pMachine, ES_Event_t ThisEvent)
+{
+  uint8_t i;
+
+  for (i = 0; i < pMachine->NumStates; i++)
+  {
+    pMachine->pHistory[i] = ES_HSM_NO_STATE;
+  }
+  EnterDown(pMachine, ES_HSM_NO_STATE, pMachine->InitialState, ThisEvent);
+}
+
+/****************************************************************************
+ Function
+     ES_HSMDispatch
+ Parameters
+     ES_HSM_t *pMachine, the machine to run
+     ES_Event_t ThisEvent, the event to process
+ Returns
+     bool, true if some state handled the event
+ Description
+     Offers the event to the active leaf and then to each of its ancestors
+     until a handler consumes it or asks for a transition, and carries out
+     that transition
+ Notes
+
+ Author
+     Sander Tonkens, 10/19/26, 21:00
+****************************************************************************/
+bool ES_HSMDispatch(ES_HSM_t *pMachine, ES_Event_t ThisEvent)
+{
+  uint8_t Source;
+  uint8_t Result;
+
+  for (Source = pMachine->Current; Source != ES_HSM_NO_STATE;
+       Source = pMachine->pStates[Source].Parent)
+  {
+    if (pMachine->pStates[Source].pHandler == NULL)
+    {
+      continue;
+    }
+    Result = pMachine->pStates[Source].pHandler(ThisEvent);
+    if (Result == ES_HSM_HANDLED)
+    {
+      return true;
+    }
+    if (Result < pMachine->NumStates)
+    {
+      Transition(pMachine, Source, Result, ThisEvent);
+      return true;
+    }
+    // anything else is ES_HSM_UNHANDLED, try the parent
+  }
+  return false;
+}
+
+/****************************************************************************
+ Function
+     ES_HSMIsIn
+ Parameters
+     const ES_HSM_t *pMachine, the machine to query
+     uint8_t WhichState, the state to look for
+ Returns
+     bool, true if WhichState is the active leaf or one of its ancestors
+ Description
+     Query function, the hierarchical version of QueryTemplateSM
+ Notes
+
+ Author
+     Sander Tonkens, 10/19/26, 21:00
+****************************************************************************/
+bool ES_HSMIsIn(const ES_HSM_t *pMachine, uint8_t WhichState)
+{
+  if ((pMachine->Current == ES_HSM_NO_STATE) ||
+      (WhichState >= pMachine->NumStates))
+  {
+    return false;
+  }
+  return pMachine->pLCA[(pMachine->Current * pMachine->NumStates) +
+                        WhichState] == WhichState;
+}
+
+/***************************************************************************
+ private functions
+ ***************************************************************************/
+
+/****************************************************************************
+ Function
+     FindLCA
+ Parameters
+     const ES_HSM_t *pMachine, the machine
+     uint8_t StateA, uint8_t StateB, the two states
+ Returns
+     uint8_t, the deepest state that contains both (either may be it), or
+     ES_HSM_NO_STATE if they are under different top level states
+ Description
+     Walks up from StateA, looking for each ancestor above StateB
+ Notes
+     Only used by ES_HSMInit to build the table, so it favours being short
+ Author
+     Sander Tonkens, 10/19/26, 21:00
+****************************************************************************/
+static uint8_t FindLCA(const ES_HSM_t *pMachine, uint8_t StateA,
+    uint8_t StateB)
+{
+  uint8_t Above;
+
+  for ( ; StateA != ES_HSM_NO_STATE; StateA = pMachine->pStates[StateA].Parent)
+  {
+    for (Above = StateB; Above != ES_HSM_NO_STATE;
+         Above = pMachine->pStates[Above].Parent)
+    {
+      if (Above == StateA)
+      {
+        return StateA;
+      }
+    }
+  }
+  return ES_HSM_NO_STATE;
+}
+
+/****************************************************************************
+ Function
+     EnterDown
+ Parameters
+     ES_HSM_t *pMachine, the machine
+     uint8_t From, the state that stays active, ES_HSM_NO_STATE for none
+     uint8_t Target, the state being entered, somewhere below From
+     ES_Event_t ThisEvent, passed to the entry functions
+ Returns
+     nothing
+ Description
+     Runs the entry functions from just below From down to Target, then
+     drills into the history or initial child of each state until it
+     reaches a leaf, which becomes the active state
+ Notes
+     ES_HSMInit has checked the depth, so the path fits in Path
+ Author
+     Sander Tonkens, 10/19/26, 21:00
+****************************************************************************/
+static void EnterDown(ES_HSM_t *pMachine, uint8_t From, uint8_t Target,
+    ES_Event_t ThisEvent)
+{
+  const ES_HSMState_t *pStates = pMachine->pStates;
+  uint8_t Path[ES_HSM_MAX_DEPTH];
+  uint8_t PathLength = 0;
+  uint8_t State;
+
+  for (State = Target; State != From; State = pStates[State].Parent)
+  {
+    Path[PathLength++] = State;
+  }
+  while (PathLength > 0)
+  {
+    State = Path[--PathLength];
+    if (pStates[State].pEntry != NULL)
+    {
+      pStates[State].pEntry(ThisEvent);
+    }
+  }
+
+  State = Target;
+  while (pStates[State].InitialChild != ES_HSM_NO_STATE)
+  {
+    if (pStates[State].HasHistory &&
+        (pMachine->pHistory[State] != ES_HSM_NO_STATE))
+    {
+      State = pMachine->pHistory[State];
+    }
+    else
+    {
+      State = pStates[State].InitialChild;
+    }
+    if (pStates[State].pEntry != NULL)
+    {
+      pStates[State].pEntry(ThisEvent);
+    }
+  }
+  pMachine->Current = State;
+}
+
+/****************************************************************************
+ Function
+     Transition
+ Parameters
+     ES_HSM_t *pMachine, the machine
+     uint8_t Source, the state whose handler asked for the transition
+     uint8_t Target, the state to go to
+     ES_Event_t ThisEvent, passed to the exit & entry functions
+ Returns
+     nothing
+ Description
+     Exits from the active leaf up to the least common ancestor of Source
+     and Target, noting each exited state as its parent's history, then
+     enters down to Target
+ Notes
+     When Target is Source or one of its ancestors the common ancestor is
+     Target itself, so go one higher to have Target exited & re-entered
+ Author
+     Sander Tonkens, 10/19/26, 21:00
+****************************************************************************/
+static void Transition(ES_HSM_t *pMachine, uint8_t Source, uint8_t Target,
+    ES_Event_t ThisEvent)
+{
+  const ES_HSMState_t *pStates = pMachine->pStates;
+  uint8_t LCA;
+  uint8_t State;
+
+  LCA = pMachine->pLCA[(Source * pMachine->NumStates) + Target];
+  if (LCA == Target)
+  {
+    LCA = pStates[Target].Parent;
+  }
+  for (State = pMachine->Current; State != LCA; State = pStates[State].Parent)
+  {
+    if (pStates[State].pExit != NULL)
+    {
+      pStates[State].pExit(ThisEvent);
+    }
+    if (pStates[State].Parent != ES_HSM_NO_STATE)
+    {
+      pMachine->pHistory[pStates[State].Parent] = State;
+    }
+  }
+  EnterDown(pMachine, LCA, Target, ThisEvent);
+}
+
+#ifdef TEST
+/* checks a three level machine, then times a transition that exits and
+   enters Depth states, 2 to 5, against the recursive TopHSMTemplate /
+   HSMTemplate pattern and prints the CPU cycles for each. Each time is the
+   best of TRIALS batches of REPEATS transitions, printed to a tenth of a
+   cycle, so it also works with the uS resolution of the host build's cycle
+   stamps (build with ES_HostPort.c in place of ES_Port.c) */
+#include <stdio.h>
+#include <string.h>
+#ifndef ES_HOST_BUILD
+#include "driverlib/sysctl.h"
+#include "termio.h"
+#endif
+
+#define MAX_BENCH_DEPTH 5
+#define REPEATS 1000
+#define TRIALS 5
+
+// this project has no ES_ENTRY / ES_EXIT, so use event numbers past the
+// end of its list for the template's and the test machine's own events
+#define TEST_EVENT(n) ((ES_EventType_t)(NUM_ES_EVENTS + (n)))
+#define TPL_ENTRY     TEST_EVENT(0)
+#define TPL_EXIT      TEST_EVENT(1)
+#define TPL_SWITCH    TEST_EVENT(2)
+#define EV_TO_A2      TEST_EVENT(3)
+#define EV_TO_B       TEST_EVENT(4)
+#define EV_TO_OTHER   TEST_EVENT(5)
+#define EV_TO_TOP     TEST_EVENT(6)
+#define EV_SELF       TEST_EVENT(7)
+#define EV_UP         TEST_EVENT(8)
+#define EV_TO_A       TEST_EVENT(9)
+#define EV_CONSUME    TEST_EVENT(10)
+#define EV_IGNORED    TEST_EVENT(11)
+
+/*------------------------- the three level machine -----------------------*/
+// Top (history) holds A and B, A holds A1 and A2, Other is a second top
+// level state. Entry functions write the state's letter to Trace, exit
+// functions the lower case letter
+typedef enum
+{
+  Top, A, A1, A2, B, Other
+}TestState_t;
+
+static char    Trace[32];
+static uint8_t TraceLength;
+
+static void Note(char Letter)
+{
+  if (TraceLength < (sizeof(Trace) - 1))
+  {
+    Trace[TraceLength++] = Letter;
+    Trace[TraceLength] = '\0';
+  }
+}
+
+#define TRACE_ACTIONS(State, Letter)                                        \
+  static void Enter##State(ES_Event_t ThisEvent) { Note(Letter); }          \
+  static void Exit##State(ES_Event_t ThisEvent) { Note(Letter + 'a' - 'A'); }
+TRACE_ACTIONS(Top, 'T')
+TRACE_ACTIONS(A, 'A')
+TRACE_ACTIONS(A1, 'C')
+TRACE_ACTIONS(A2, 'D')
+TRACE_ACTIONS(B, 'B')
+TRACE_ACTIONS(Other, 'O')
+
+static uint8_t DuringTop(ES_Event_t ThisEvent)
+{
+  if (ThisEvent.EventType == EV_TO_OTHER)
+  {
+    return Other;
+  }
+  if (ThisEvent.EventType == EV_CONSUME)
+  {
+    return ES_HSM_HANDLED;
+  }
+  return ES_HSM_UNHANDLED;
+}
+
+static uint8_t DuringA(ES_Event_t ThisEvent)
+{
+  return (ThisEvent.EventType == EV_TO_B) ? B : ES_HSM_UNHANDLED;
+}
+
+static uint8_t DuringA1(ES_Event_t ThisEvent)
+{
+  return (ThisEvent.EventType == EV_TO_A2) ? A2 : ES_HSM_UNHANDLED;
+}
+
+static uint8_t DuringB(ES_Event_t ThisEvent)
+{
+  if (ThisEvent.EventType == EV_SELF)
+  {
+    return B;
+  }
+  if (ThisEvent.EventType == EV_UP)
+  {
+    return Top;
+  }
+  if (ThisEvent.EventType == EV_TO_A)
+  {
+    return A;
+  }
+  return ES_HSM_UNHANDLED;
+}
+
+static uint8_t DuringOther(ES_Event_t ThisEvent)
+{
+  return (ThisEvent.EventType == EV_TO_TOP) ? Top : ES_HSM_UNHANDLED;
+}
+
+static const ES_HSMState_t TestStates[] = {
+  //  Parent           Initial child    History  Entry  Exit  Handler
+  [Top]   = { ES_HSM_NO_STATE, A,               true,  EnterTop, ExitTop,
+              DuringTop },
+  [A]     = { Top,             A1,              false, EnterA, ExitA,
+              DuringA },
+  [A1]    = { A,               ES_HSM_NO_STATE, false, EnterA1, ExitA1,
+              DuringA1 },
+  [A2]    = { A,               ES_HSM_NO_STATE, false, EnterA2, ExitA2,
+              NULL },
+  [B]     = { Top,             ES_HSM_NO_STATE, false, EnterB, ExitB,
+              DuringB },
+  [Other] = { ES_HSM_NO_STATE, ES_HSM_NO_STATE, false, EnterOther, ExitOther,
+              DuringOther },
+};
+ES_HSM_DEFINE(TestSM, TestStates, Top);
+
+static uint8_t Failures;
+
+static void Check(const char *pName, bool Handled, bool WantHandled,
+    const char *pWantTrace, uint8_t WantState)
+{
+  bool Passed = (Handled == WantHandled) &&
+      (strcmp(Trace, pWantTrace) == 0) && (TestSM.Current == WantState);
+
+  printf("%-12s %-8s %s\r\n", pName, Trace, Passed ? "PASS" : "FAIL");
+  if (!Passed)
+  {
+    Failures++;
+  }
+  TraceLength = 0;
+  Trace[0] = '\0';
+}
+
+static bool Send(ES_EventType_t EventType)
+{
+  ES_Event_t ThisEvent;
+
+  ThisEvent.EventType = EventType;
+  ThisEvent.EventParam = 0;
+  return ES_HSMDispatch(&TestSM, ThisEvent);
+}
+
+static void TestMachine(void)
+{
+  ES_Event_t ThisEvent = { ES_INIT, 0 };
+
+  Check("init", ES_HSMInit(&TestSM), true, "", ES_HSM_NO_STATE);
+  ES_HSMStart(&TestSM, ThisEvent);
+  Check("start", true, true, "TAC", A1);
+  Check("leaf", Send(EV_TO_A2), true, "cD", A2);
+  Check("parent", Send(EV_TO_B), true, "daB", B);
+  Check("top level", Send(EV_TO_OTHER), true, "btO", Other);
+  Check("history", Send(EV_TO_TOP), true, "oTB", B);
+  Check("self", Send(EV_SELF), true, "bB", B);
+  Check("ancestor", Send(EV_UP), true, "btTB", B);
+  Check("no history", Send(EV_TO_A), true, "bAC", A1);
+  Check("consumed", Send(EV_CONSUME), true, "", A1);
+  Check("unhandled", Send(EV_IGNORED), false, "", A1);
+  Check("is in", ES_HSMIsIn(&TestSM, Top) && ES_HSMIsIn(&TestSM, A) &&
+      ES_HSMIsIn(&TestSM, A1) && !ES_HSMIsIn(&TestSM, A2) &&
+      !ES_HSMIsIn(&TestSM, B) && !ES_HSMIsIn(&TestSM, Other), true, "", A1);
+}
+
+/*------------------------- the transition benchmark ----------------------*/
+// both machines have two chains of Depth states under two top level states
+// and switch between the top level states on TPL_SWITCH, handled at the
+// top, so each transition passes the event up (or down) Depth levels,
+// exits Depth states and enters Depth states
+static volatile uint32_t ActionCount;
+static uint8_t BenchDepth;
+
+static void BenchAction(ES_Event_t ThisEvent)
+{
+  ActionCount++;
+}
+
+// the template pattern: level n's run function, with its during function
+// starting / running level n + 1, as in TopHSMTemplate.c & HSMTemplate.c
+static uint8_t TplState[MAX_BENCH_DEPTH];
+
+static ES_Event_t TplRun(uint8_t Level, ES_Event_t CurrentEvent);
+
+static void TplStart(uint8_t Level, ES_Event_t CurrentEvent)
+{
+  TplState[Level] = 0;
+  TplRun(Level, CurrentEvent);
+}
+
+static ES_Event_t TplDuring(uint8_t Level, ES_Event_t Event)
+{
+  ES_Event_t ReturnEvent = Event;
+
+  if (Event.EventType == TPL_ENTRY)
+  {
+    BenchAction(Event);
+    if ((Level + 1) < BenchDepth)
+    {
+      TplStart(Level + 1, Event);
+    }
+  }
+  else if (Event.EventType == TPL_EXIT)
+  {
+    if ((Level + 1) < BenchDepth)
+    {
+      TplRun(Level + 1, Event);
+    }
+    BenchAction(Event);
+  }
+  else if ((Level + 1) < BenchDepth)
+  {
+    ReturnEvent = TplRun(Level + 1, Event);
+  }
+  return ReturnEvent;
+}
+
+static ES_Event_t TplRun(uint8_t Level, ES_Event_t CurrentEvent)
+{
+  bool        MakeTransition = false;
+  uint8_t     NextState = TplState[Level];
+  ES_Event_t  EntryEventKind = { TPL_ENTRY, 0 };
+  ES_Event_t  ReturnEvent;
+
+  ReturnEvent = CurrentEvent = TplDuring(Level, CurrentEvent);
+  if ((Level == 0) && (CurrentEvent.EventType == TPL_SWITCH))
+  {
+    NextState = !TplState[Level];
+    MakeTransition = true;
+    ReturnEvent.EventType = ES_NO_EVENT;
+  }
+  if (MakeTransition == true)
+  {
+    CurrentEvent.EventType = TPL_EXIT;
+    TplRun(Level, CurrentEvent);
+    TplState[Level] = NextState;
+    TplRun(Level, EntryEventKind);
+  }
+  return ReturnEvent;
+}
+
+// the same machine for ES_HSM, states 0 to Depth - 1 are one chain and
+// Depth to 2 * Depth - 1 the other
+static ES_HSMState_t  BenchStates[2 * MAX_BENCH_DEPTH];
+static uint8_t        BenchLCA[2 * MAX_BENCH_DEPTH][2 * MAX_BENCH_DEPTH];
+static uint8_t        BenchHistory[2 * MAX_BENCH_DEPTH];
+static ES_HSM_t       BenchSM =
+{ BenchStates, 0, 0, &BenchLCA[0][0], BenchHistory, ES_HSM_NO_STATE };
+
+static uint8_t DuringFirst(ES_Event_t ThisEvent)
+{
+  return (ThisEvent.EventType == TPL_SWITCH) ? BenchDepth : ES_HSM_UNHANDLED;
+}
+
+static uint8_t DuringSecond(ES_Event_t ThisEvent)
+{
+  return (ThisEvent.EventType == TPL_SWITCH) ? 0 : ES_HSM_UNHANDLED;
+}
+
+static uint8_t DuringInner(ES_Event_t ThisEvent)
+{
+  return ES_HSM_UNHANDLED;
+}
+
+static void BuildBench(uint8_t Depth)
+{
+  ES_Event_t  ThisEvent = { TPL_ENTRY, 0 };
+  uint8_t     Chain;
+  uint8_t     Level;
+  uint8_t     State;
+
+  BenchDepth = Depth;
+  for (Chain = 0; Chain < 2; Chain++)
+  {
+    for (Level = 0; Level < Depth; Level++)
+    {
+      State = (Chain * Depth) + Level;
+      BenchStates[State].Parent = (Level == 0) ? ES_HSM_NO_STATE : State - 1;
+      BenchStates[State].InitialChild =
+          ((Level + 1) < Depth) ? State + 1 : ES_HSM_NO_STATE;
+      BenchStates[State].HasHistory = false;
+      BenchStates[State].pEntry = BenchAction;
+      BenchStates[State].pExit = BenchAction;
+      BenchStates[State].pHandler = (Level != 0) ? DuringInner :
+          ((Chain == 0) ? DuringFirst : DuringSecond);
+    }
+  }
+  BenchSM.NumStates = 2 * Depth;
+  ES_HSMInit(&BenchSM);
+  ES_HSMStart(&BenchSM, ThisEvent);
+  TplStart(0, ThisEvent);
+}
+
+static uint32_t BestBatch(bool UseHSM)
+{
+  ES_Event_t  ThisEvent = { TPL_SWITCH, 0 };
+  uint32_t    Start;
+  uint32_t    Cycles;
+  uint32_t    Best = UINT32_MAX;
+  uint16_t    i;
+  uint8_t     Trial;
+
+  for (Trial = 0; Trial < TRIALS; Trial++)
+  {
+    Start = _HW_GetCycleStamp();
+    for (i = 0; i < REPEATS; i++)
+    {
+      if (UseHSM)
+      {
+        ES_HSMDispatch(&BenchSM, ThisEvent);
+      }
+      else
+      {
+        TplRun(0, ThisEvent);
+      }
+    }
+    Cycles = _HW_GetCycleStamp() - Start;
+    if (Cycles < Best)
+    {
+      Best = Cycles;
+    }
+  }
+  return Best;
+}
+
+int main(void)
+{
+  uint32_t  TplCycles;
+  uint32_t  HSMCycles;
+  uint8_t   Depth;
+
+#ifndef ES_HOST_BUILD
+  SysCtlClockSet(SYSCTL_SYSDIV_5 | SYSCTL_USE_PLL | SYSCTL_OSC_MAIN
+      | SYSCTL_XTAL_16MHZ);
+  TERMIO_Init();
+#endif
+  _HW_Timer_Init(ES_Timer_RATE_1mS);
+
+  TestMachine();
+  printf("%u failures\r\n\n", Failures);
+
+  puts("\rDepth  Template  ES_HSM (cycles per transition)\r");
+  for (Depth = 2; Depth <= MAX_BENCH_DEPTH; Depth++)
+  {
+    BuildBench(Depth);
+    TplCycles = BestBatch(false);
+    HSMCycles = BestBatch(true);
+    TplCycles = (TplCycles * 10) / REPEATS;
+    HSMCycles = (HSMCycles * 10) / REPEATS;
+    printf("%5u %7lu.%lu %5lu.%lu\r\n", Depth,
+        (unsigned long)(TplCycles / 10), (unsigned long)(TplCycles % 10),
+        (unsigned long)(HSMCycles / 10), (unsigned long)(HSMCycles % 10));
+  }
+
+#ifndef ES_HOST_BUILD
+  while (1)
+  {
+    ;
+  }
+#endif
+  return 0;
+}
+
+#endif
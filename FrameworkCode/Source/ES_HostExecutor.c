@@ -0,0 +1,687 @@
+//#define TEST
+/****************************************************************************
+ Module
+   ES_HostExecutor.c
+
+ Revision
+   1.0.1
+
+ Description
+   Host only replacement for ES_Run that spreads the services over a pool
+   of threads, for running the framework in simulation and replay on a PC.
+
+ Notes
+   Only built when ES_HOST_BUILD is defined, it is not part of the Tiva
+   project.
+   Run to completion is kept per service: a service is either waiting in
+   one worker's deque or being run by one worker, never both, so its run
+   function only ever sees one event at a time. Different services run in
+   parallel. Scheduled[] is what guarantees that, and it is only changed
+   inside a critical region.
+   When a post makes a service ready it is pushed onto the deque of the
+   worker that made the post (or dealt round the workers if the post came
+   from the main thread). A worker takes its newest work first and an idle
+   worker steals the oldest work from the others, so busy chains of posts
+   stay on one thread while the load still spreads out.
+   The main thread keeps the event checkers and the timer tick, as ES_Run
+   did. The services start and stop timers from the workers, so the timer
+   module changes its counts & flags inside the critical regions, which
+   makes the tick safe to run alongside them.
+   With ES_MULTI_INSTANCE there are no workers: a worker has no current
+   instance, so ES_HostRunInstances steps the instances in turn with
+   ES_RunStep instead, or a thread that selects them can.
+
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/21/26 17:00 ston    ES_HostRunInstances & its TEST driver
+ 10/21/26 09:00 ston    the timers are locked against the workers, see notes
+ 10/20/26 09:00 ston    only the critical regions with ES_MULTI_INSTANCE
+ 10/19/26 16:00 ston    first pass
+
+****************************************************************************/
+#ifdef ES_HOST_BUILD
+
+/*----------------------------- Include Files -----------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include "ES_Configure.h"
+#include "ES_Framework.h"
+#include "ES_CheckEvents.h"
+#include "ES_HostExecutor.h"
+
+/*----------------------------- Module Defines ----------------------------*/
+// a service is in at most one deque at a time, so NUM_SERVICES always fits
+typedef struct
+{
+  pthread_mutex_t Lock;
+  uint8_t         Items[NUM_SERVICES];
+  uint8_t         Oldest;   // index of the entry thieves take
+  uint8_t         Count;
+}WorkDeque_t;
+
+/*---------------------------- Module Functions ---------------------------*/
+#ifndef ES_MULTI_INSTANCE
+static void *WorkerThread(void *pArg);
+static void PushNewest(uint8_t Worker, uint8_t WhichService);
+static void PushOldest(uint8_t Worker, uint8_t WhichService);
+static bool TakeWork(uint8_t Worker, uint8_t *pService);
+static bool PopNewest(uint8_t Worker, uint8_t *pService);
+static bool StealOldest(uint8_t Victim, uint8_t *pService);
+static void WorkAdded(void);
+static void InitDeques(void);
+#endif
+
+/*---------------------------- Module Variables ---------------------------*/
+static pthread_mutex_t CriticalLock = PTHREAD_MUTEX_INITIALIZER;
+
+#ifndef ES_MULTI_INSTANCE
+static pthread_once_t  DequesOnce = PTHREAD_ONCE_INIT;
+
+static WorkDeque_t  Deques[ES_HOST_MAX_WORKERS];
+static pthread_t    Workers[ES_HOST_MAX_WORKERS];
+static uint8_t      NumWorkers = 1;
+static uint8_t      NextWorker;    // where the main thread's posts go next
+
+// true while a service is in a deque or being run
+static bool Scheduled[NUM_SERVICES];
+
+// idle workers sleep on WorkReady until PendingWork goes non-zero
+static pthread_mutex_t  WorkLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t   WorkReady = PTHREAD_COND_INITIALIZER;
+static uint32_t         PendingWork;
+
+static volatile bool StopRequested;
+static volatile bool RunFailed;
+
+// which worker this thread is, -1 for the main thread
+static __thread int16_t MyWorker = -1;
+#endif
+
+/*------------------------------ Module Code ------------------------------*/
+#ifndef ES_MULTI_INSTANCE
+/****************************************************************************
+ Function
+   ES_HostRun
+ Parameters
+   uint8_t : number of worker threads to run the services on
+ Returns
+   ES_Return_t : FailedRun if any of the run functions failed,
+                 FailedInit if the threads could not be started
+ Description
+   the host build's ES_Run: starts the workers, then runs the event
+   checkers on the calling thread until ES_HostStop is called or a run
+   function fails
+ Notes
+   call after ES_Initialize, anything the inits posted is already waiting
+ Author
+   Sander Tonkens, 10/19/26, 16:00
+****************************************************************************/
+ES_Return_t ES_HostRun(uint8_t HowMany)
+{
+  uint8_t i;
+  uint8_t Started;
+
+  if (HowMany == 0)
+  {
+    HowMany = 1;
+  }
+  if (HowMany > ES_HOST_MAX_WORKERS)
+  {
+    HowMany = ES_HOST_MAX_WORKERS;
+  }
+  // anything the inits posted is on worker 0's deque, the others steal it
+  pthread_once(&DequesOnce, InitDeques);
+  NumWorkers = HowMany;
+  StopRequested = false;
+  RunFailed = false;
+
+  for (Started = 0; Started < NumWorkers; Started++)
+  {
+    if (pthread_create(&Workers[Started], NULL, WorkerThread,
+        (void *)(uintptr_t)Started) != 0)
+    {
+      ES_HostStop();
+      break;
+    }
+  }
+
+  while (!StopRequested)
+  {
+    _HW_Process_Pending_Ints();
+    ES_CheckUserEvents();
+    sched_yield();
+  }
+
+  for (i = 0; i < Started; i++)
+  {
+    pthread_join(Workers[i], NULL);
+  }
+  if (Started < NumWorkers)
+  {
+    return FailedInit;
+  }
+  return RunFailed ? FailedRun : Success;
+}
+
+/****************************************************************************
+ Function
+   ES_HostStop
+ Parameters
+   None
+ Returns
+   None
+ Description
+   asks ES_HostRun to return, the workers finish the event they are on
+ Notes
+   safe to call from a run function or from another thread
+ Author
+   Sander Tonkens, 10/19/26, 16:00
+****************************************************************************/
+void ES_HostStop(void)
+{
+  pthread_mutex_lock(&WorkLock);
+  StopRequested = true;
+  pthread_cond_broadcast(&WorkReady);
+  pthread_mutex_unlock(&WorkLock);
+}
+
+/****************************************************************************
+ Function
+   ES_HostServiceReady
+ Parameters
+   uint8_t : Which service just had an event posted
+ Returns
+   None
+ Description
+   called by the framework after every post. Hands the service to a worker
+   unless it is already waiting in a deque or being run, in which case
+   that worker will see the new event when it finishes the current one
+ Notes
+
+ Author
+   Sander Tonkens, 10/19/26, 16:00
+****************************************************************************/
+void ES_HostServiceReady(uint8_t WhichService)
+{
+  bool NeedsWorker = false;
+  uint8_t Worker;
+
+  if (WhichService >= NUM_SERVICES)
+  {
+    return;
+  }
+  pthread_once(&DequesOnce, InitDeques);
+  EnterCritical();
+  if (!Scheduled[WhichService])
+  {
+    Scheduled[WhichService] = true;
+    NeedsWorker = true;
+  }
+  ExitCritical();
+  if (!NeedsWorker)
+  {
+    return;
+  }
+  if (MyWorker >= 0)
+  {
+    Worker = (uint8_t)MyWorker;   // keep the chain of posts on this thread
+  }
+  else
+  {
+    EnterCritical();
+    Worker = NextWorker % NumWorkers;
+    NextWorker = (Worker + 1) % NumWorkers;
+    ExitCritical();
+  }
+  PushNewest(Worker, WhichService);
+}
+#endif
+
+/****************************************************************************
+ Function
+   ES_HostEnterCritical / ES_HostExitCritical
+ Parameters
+   None
+ Returns
+   None
+ Description
+   EnterCritical & ExitCritical for the host build, one lock shared by
+   every thread, in place of turning the interrupts off
+ Notes
+   like the interrupt version, the regions must not be nested
+ Author
+   Sander Tonkens, 10/19/26, 16:00
+****************************************************************************/
+void ES_HostEnterCritical(void)
+{
+  pthread_mutex_lock(&CriticalLock);
+}
+
+void ES_HostExitCritical(void)
+{
+  pthread_mutex_unlock(&CriticalLock);
+}
+
+#ifndef ES_MULTI_INSTANCE
+//*********************************
+// private functions
+//*********************************
+/****************************************************************************
+ Function
+   WorkerThread
+ Parameters
+   void * : the worker's number
+ Returns
+   NULL
+ Description
+   takes a ready service, runs one event through it, then either puts it
+   back (at the far end of its deque, so the worker's other services go
+   first) or, if its queue is empty, marks it as no longer scheduled
+ Notes
+   the empty test & the clearing of Scheduled are one critical region, so
+   a post that lands in between is never lost: either we see its event or
+   ES_HostServiceReady sees Scheduled clear
+ Author
+   Sander Tonkens, 10/19/26, 16:00
+****************************************************************************/
+static void *WorkerThread(void *pArg)
+{
+  uint8_t Me = (uint8_t)(uintptr_t)pArg;
+  uint8_t Service;
+  bool More;
+
+  MyWorker = Me;
+  while (!StopRequested)
+  {
+    if (!TakeWork(Me, &Service))
+    {
+      pthread_mutex_lock(&WorkLock);
+      while ((PendingWork == 0) && !StopRequested)
+      {
+        pthread_cond_wait(&WorkReady, &WorkLock);
+      }
+      pthread_mutex_unlock(&WorkLock);
+      continue;
+    }
+    if (ES_DispatchService(Service) != true)
+    {
+      RunFailed = true;
+      ES_HostStop();
+    }
+    EnterCritical();
+    More = ES_ServiceHasEvents(Service);
+    if (!More)
+    {
+      Scheduled[Service] = false;
+    }
+    ExitCritical();
+    if (More)
+    {
+      PushOldest(Me, Service);
+    }
+  }
+  return NULL;
+}
+
+/****************************************************************************
+ Function
+   TakeWork
+ Parameters
+   uint8_t : the worker looking for work
+   uint8_t * : where to put the service it gets
+ Returns
+   bool : true if it got one
+ Description
+   newest entry of our own deque first, then steals the oldest entry of
+   each of the other workers' deques in turn, starting with our neighbour
+ Notes
+
+ Author
+   Sander Tonkens, 10/19/26, 16:00
+****************************************************************************/
+static bool TakeWork(uint8_t Worker, uint8_t *pService)
+{
+  uint8_t i;
+
+  if (PopNewest(Worker, pService))
+  {
+    return true;
+  }
+  for (i = 1; i < NumWorkers; i++)
+  {
+    if (StealOldest((Worker + i) % NumWorkers, pService))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+/****************************************************************************
+ Function
+   PushNewest / PushOldest
+ Parameters
+   uint8_t : whose deque
+   uint8_t : the service to add
+ Returns
+   None
+ Description
+   add a service at the owner's end, or at the thieves' end, of a deque
+ Notes
+
+ Author
+   Sander Tonkens, 10/19/26, 16:00
+****************************************************************************/
+static void PushNewest(uint8_t Worker, uint8_t WhichService)
+{
+  WorkDeque_t *pDeque = &Deques[Worker];
+
+  pthread_mutex_lock(&pDeque->Lock);
+  pDeque->Items[(pDeque->Oldest + pDeque->Count) % NUM_SERVICES] =
+      WhichService;
+  pDeque->Count++;
+  pthread_mutex_unlock(&pDeque->Lock);
+  WorkAdded();
+}
+
+static void PushOldest(uint8_t Worker, uint8_t WhichService)
+{
+  WorkDeque_t *pDeque = &Deques[Worker];
+
+  pthread_mutex_lock(&pDeque->Lock);
+  pDeque->Oldest = (pDeque->Oldest + NUM_SERVICES - 1) % NUM_SERVICES;
+  pDeque->Items[pDeque->Oldest] = WhichService;
+  pDeque->Count++;
+  pthread_mutex_unlock(&pDeque->Lock);
+  WorkAdded();
+}
+
+/****************************************************************************
+ Function
+   PopNewest / StealOldest
+ Parameters
+   uint8_t : whose deque
+   uint8_t * : where to put the service taken
+ Returns
+   bool : true if there was one to take
+ Description
+   take a service from the owner's end, or from the thieves' end, of a deque
+ Notes
+
+ Author
+   Sander Tonkens, 10/19/26, 16:00
+****************************************************************************/
+static bool PopNewest(uint8_t Worker, uint8_t *pService)
+{
+  WorkDeque_t *pDeque = &Deques[Worker];
+  bool        Got = false;
+
+  pthread_mutex_lock(&pDeque->Lock);
+  if (pDeque->Count > 0)
+  {
+    pDeque->Count--;
+    *pService = pDeque->Items[(pDeque->Oldest + pDeque->Count) % NUM_SERVICES];
+    Got = true;
+  }
+  pthread_mutex_unlock(&pDeque->Lock);
+  if (Got)
+  {
+    pthread_mutex_lock(&WorkLock);
+    PendingWork--;
+    pthread_mutex_unlock(&WorkLock);
+  }
+  return Got;
+}
+
+static bool StealOldest(uint8_t Victim, uint8_t *pService)
+{
+  WorkDeque_t *pDeque = &Deques[Victim];
+  bool        Got = false;
+
+  pthread_mutex_lock(&pDeque->Lock);
+  if (pDeque->Count > 0)
+  {
+    *pService = pDeque->Items[pDeque->Oldest];
+    pDeque->Oldest = (pDeque->Oldest + 1) % NUM_SERVICES;
+    pDeque->Count--;
+    Got = true;
+  }
+  pthread_mutex_unlock(&pDeque->Lock);
+  if (Got)
+  {
+    pthread_mutex_lock(&WorkLock);
+    PendingWork--;
+    pthread_mutex_unlock(&WorkLock);
+  }
+  return Got;
+}
+
+/****************************************************************************
+ Function
+   InitDeques
+ Parameters
+   None
+ Returns
+   None
+ Description
+   sets up the deques' locks, once, on the first post or ES_HostRun
+ Notes
+
+ Author
+   Sander Tonkens, 10/19/26, 16:00
+****************************************************************************/
+static void InitDeques(void)
+{
+  uint8_t i;
+
+  for (i = 0; i < ES_HOST_MAX_WORKERS; i++)
+  {
+    pthread_mutex_init(&Deques[i].Lock, NULL);
+    Deques[i].Oldest = 0;
+    Deques[i].Count = 0;
+  }
+}
+
+/****************************************************************************
+ Function
+   WorkAdded
+ Parameters
+   None
+ Returns
+   None
+ Description
+   counts a newly pushed service and wakes one idle worker to take it
+ Notes
+
+ Author
+   Sander Tonkens, 10/19/26, 16:00
+****************************************************************************/
+static void WorkAdded(void)
+{
+  pthread_mutex_lock(&WorkLock);
+  PendingWork++;
+  pthread_cond_signal(&WorkReady);
+  pthread_mutex_unlock(&WorkLock);
+}
+
+#else /* ES_MULTI_INSTANCE */
+/****************************************************************************
+ Function
+   ES_HostRunInstances
+ Parameters
+   ES_Instance_t * const * : the instances to run, from ES_CreateInstance
+   uint8_t : how many there are
+   TimerRate_t : the tick rate for each one's ES_Initialize
+   uint32_t : how long to run them for in mS, 0 for until one fails
+ Returns
+   ES_Return_t : FailedInit if an instance is missing or its services did
+                 not start, FailedRun if a run function failed, Success
+                 once the time is up
+ Description
+   the host build's ES_Run for ES_MULTI_INSTANCE: initializes each of the
+   instances, then steps them in turn with ES_RunStep, so every exhibit
+   gets its events, timers & checkers on this one thread
+ Notes
+   leaves no instance selected
+ Author
+   Sander Tonkens, 10/21/26, 17:00
+****************************************************************************/
+ES_Return_t ES_HostRunInstances(ES_Instance_t * const *ppInstances,
+    uint8_t HowMany, TimerRate_t Rate, uint32_t ForMS)
+{
+  ES_Return_t Result = Success;
+  uint64_t    StopUS;
+  uint8_t     i;
+
+  for (i = 0; (i < HowMany) && (Result == Success); i++)
+  {
+    if (ppInstances[i] == NULL)
+    {
+      Result = FailedInit;
+    }
+    else
+    {
+      ES_SelectInstance(ppInstances[i]);
+      if (ES_Initialize(Rate) != Success)
+      {
+        Result = FailedInit;
+      }
+    }
+  }
+
+  StopUS = _HW_GetTimeUS() + ((uint64_t)ForMS * 1000);
+  while ((Result == Success) && ((ForMS == 0) || (_HW_GetTimeUS() < StopUS)))
+  {
+    for (i = 0; (i < HowMany) && (Result == Success); i++)
+    {
+      ES_SelectInstance(ppInstances[i]);
+      if (ES_RunStep() != Success)
+      {
+        Result = FailedRun;
+      }
+    }
+  }
+  ES_SelectInstance(NULL);
+  return Result;
+}
+#endif /* ES_MULTI_INSTANCE */
+
+#if defined(TEST) && defined(ES_MULTI_INSTANCE)
+/* runs two instances side by side for half a second with stand ins for the
+   services in ES_Configure.h, then checks that each instance's service 0
+   kept its own count of its own 10 tick timer, and that the timers fail
+   with no instance selected (build with the other framework modules and
+   ES_HostPort.c, -DES_HOST_BUILD -DES_MULTI_INSTANCE -DTEST) */
+#include <stdio.h>
+
+#define RUN_MS 500
+#define PERIOD 10
+
+typedef struct
+{
+  uint8_t   MyPriority;
+  uint32_t  Timeouts;
+} StandInData_t;
+
+static StandInData_t MyData;   // the single copy, unused here
+
+static bool StandInInit(uint8_t Priority)
+{
+  StandInData_t *Me = ES_SERVICE_DATA(StandInData_t, Priority, MyData);
+
+  Me->MyPriority = Priority;
+  if (Priority == 0)
+  {
+    ES_Timer_InitTimer(0, PERIOD);  // timer 0 goes to service 0
+  }
+  return true;
+}
+
+static ES_Event_t StandInRun(uint8_t Priority, ES_Event_t ThisEvent)
+{
+  StandInData_t *Me = ES_SERVICE_DATA(StandInData_t, Priority, MyData);
+  ES_Event_t    ReturnEvent = { ES_NO_EVENT, 0 };
+
+  if (ThisEvent.EventType == ES_TIMEOUT)
+  {
+    Me->Timeouts++;
+    ES_Timer_InitTimer(ThisEvent.EventParam, PERIOD);
+  }
+  return ReturnEvent;
+}
+
+#define STAND_IN(Priority, Init, Run)                                       \
+  bool Init(uint8_t P) { return StandInInit(P); }                           \
+  ES_Event_t Run(ES_Event_t ThisEvent)                                      \
+  { return StandInRun(Priority, ThisEvent); }
+STAND_IN(0, SERV_0_INIT, SERV_0_RUN)
+#if NUM_SERVICES > 1
+STAND_IN(1, SERV_1_INIT, SERV_1_RUN)
+#endif
+#if NUM_SERVICES > 2
+STAND_IN(2, SERV_2_INIT, SERV_2_RUN)
+#endif
+#if NUM_SERVICES > 3
+STAND_IN(3, SERV_3_INIT, SERV_3_RUN)
+#endif
+#if NUM_SERVICES > 4
+STAND_IN(4, SERV_4_INIT, SERV_4_RUN)
+#endif
+#if NUM_SERVICES > 5
+STAND_IN(5, SERV_5_INIT, SERV_5_RUN)
+#endif
+#if NUM_SERVICES > 6
+#error add stand ins for the services above 5
+#endif
+
+// the event checkers & input scan are the application's, none here
+bool ES_CheckUserEvents(void)
+{
+  return false;
+}
+
+void ES_InitInputScan(void)
+{
+}
+
+int main(void)
+{
+  ES_Instance_t *Instances[2];
+  uint32_t      Timeouts[2];
+  bool          Passed;
+  uint8_t       i;
+
+  Instances[0] = ES_CreateInstance();
+  Instances[1] = ES_CreateInstance();
+  if (ES_HostRunInstances(Instances, 2, ES_Timer_RATE_1mS, RUN_MS) !=
+      Success)
+  {
+    puts("ES_HostRunInstances failed");
+    return 1;
+  }
+  for (i = 0; i < 2; i++)
+  {
+    ES_SelectInstance(Instances[i]);
+    Timeouts[i] = ES_SERVICE_DATA(StandInData_t, 0, MyData)->Timeouts;
+    printf("instance %u: %lu timeouts\n", i, (unsigned long)Timeouts[i]);
+  }
+  ES_SelectInstance(NULL);
+  // each should have had one every PERIOD mS, less the one still counting
+  Passed = (Timeouts[0] >= (RUN_MS / PERIOD) - 2) &&
+           (Timeouts[0] <= (RUN_MS / PERIOD)) &&
+           (Timeouts[1] >= (RUN_MS / PERIOD) - 2) &&
+           (Timeouts[1] <= (RUN_MS / PERIOD)) &&
+           (ES_Timer_InitTimer(0, PERIOD) == ES_Timer_ERR);
+  ES_Timer_Tick_Resp();   // must not crash with no instance
+  printf("%s\n", Passed ? "PASS" : "FAIL");
+  ES_DestroyInstance(Instances[0]);
+  ES_DestroyInstance(Instances[1]);
+  return Passed ? 0 : 1;
+}
+#endif
+
+#endif /* ES_HOST_BUILD */
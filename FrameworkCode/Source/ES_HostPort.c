@@ -0,0 +1,367 @@
+/****************************************************************************
+ Module
+   ES_HostPort.c
+
+ Revision
+   1.0.1
+
+ Description
+   Host only port of the hardware specific functions of ES_Port.c, for
+   running the framework in simulation and replay on a PC.
+
+ Notes
+   Only built when ES_HOST_BUILD is defined, it is not part of the Tiva
+   project, and takes the place of ES_Port.c and termio.c.
+   There is no tick interrupt: the tick count is worked out from the
+   monotonic clock, and _HW_Process_Pending_Ints runs the timer tick
+   response once for every tick since it last caught up. The cycle stamps
+   count the cycles a 40MHz Tiva would have, so times measured with them
+   come out in the same units as on the target.
+
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/20/26 17:00 ston    the clock comes from ES_CLOCK_HZ in ES_Port.h
+ 10/20/26 10:00 ston    the ticks seen are kept per instance
+ 10/20/26 09:00 ston    first pass
+
+****************************************************************************/
+#ifdef ES_HOST_BUILD
+
+/*----------------------------- Include Files -----------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include "ES_Port.h"
+#include "ES_Types.h"
+#include "ES_Timers.h"
+#include "ES_Framework.h"
+
+/*----------------------------- Module Defines ----------------------------*/
+
+/*---------------------------- Module Functions ---------------------------*/
+static uint64_t NowUS(void);
+static uint32_t CurrentTick(void);
+
+/*---------------------------- Module Variables ---------------------------*/
+static uint64_t StartUS;       // when the tick was started
+static uint32_t TickUS;        // length of a tick, 0 until it is started
+#ifdef ES_MULTI_INSTANCE
+// every instance runs its own timers, so each keeps the tick they have been
+// run up to in its own data, and every instance gets every tick
+#define TICKS_SEEN() ((uint32_t *)ES_GetInstanceData(ES_PORT_DATA_SLOT, \
+                                                     sizeof(uint32_t)))
+#else
+static uint32_t TicksSeen;     // the tick the timers have been run up to
+#define TICKS_SEEN() (&TicksSeen)
+#endif
+
+/*------------------------------ Module Code ------------------------------*/
+/****************************************************************************
+ Function
+     _HW_Timer_Init
+ Parameters
+     TimerRate_t the tick rate, in Tiva cycles per tick
+ Returns
+     None.
+ Description
+     starts the tick at the requested rate, the first call sets time zero
+ Notes
+     with ES_MULTI_INSTANCE each instance's ES_Initialize calls this, and
+     its timers start from the tick it was called on
+ Author
+     Sander Tonkens, 10/20/26 09:00
+****************************************************************************/
+void _HW_Timer_Init(TimerRate_t Rate)
+{
+  uint32_t *pSeen = TICKS_SEEN();
+
+  if (TickUS == 0)
+  {
+    StartUS = NowUS();
+  }
+  TickUS = ((uint32_t)Rate + 1) / ES_CYCLES_PER_US;
+  if (TickUS == 0)
+  {
+    TickUS = 1;
+  }
+  if (pSeen != NULL)
+  {
+    *pSeen = CurrentTick();
+  }
+}
+
+/****************************************************************************
+ Function
+     _HW_Process_Pending_Ints
+ Parameters
+     none
+ Returns
+     always true.
+ Description
+     runs the framework tick response once for every tick that has gone by
+     since the last call
+ Notes
+     always returns true, for the loop test in ES_Run. With
+     ES_MULTI_INSTANCE the ticks are counted for the current instance, so
+     stepping one instance leaves the others' ticks pending
+ Author
+     Sander Tonkens, 10/20/26 09:00
+****************************************************************************/
+bool _HW_Process_Pending_Ints(void)
+{
+  uint32_t Now = CurrentTick();
+  uint32_t *pSeen = TICKS_SEEN();
+
+  if (pSeen == NULL)
+  {
+    return true;  // no instance selected, so no timers to run
+  }
+  while (*pSeen != Now)
+  {
+    /* call the framework tick response to actually run the timers */
+    ES_Timer_Tick_Resp();
+    (*pSeen)++;
+  }
+  return true;  // always return true to allow loop test in ES_Run to proceed
+}
+
+/****************************************************************************
+ Function
+     _HW_GetTickCount
+ Parameters
+     none
+ Returns
+     uint16_t   count of number of system ticks that have occurred.
+ Description
+     wrapper for access to the tick count
+ Notes
+ Author
+     Sander Tonkens, 10/20/26 09:00
+****************************************************************************/
+uint16_t _HW_GetTickCount(void)
+{
+  return (uint16_t)CurrentTick();
+}
+
+/****************************************************************************
+ Function
+    _HW_GetCycleStamp
+ Parameters
+    none
+ Returns
+    uint32_t   a free running count of Tiva cycles
+ Description
+    start point for timing a section of code, pass it to _HW_USSince
+ Notes
+    wraps after 107 seconds, as the target's does
+ Author
+    Sander Tonkens, 10/20/26 09:00
+****************************************************************************/
+uint32_t _HW_GetCycleStamp(void)
+{
+  return (uint32_t)(NowUS() * ES_CYCLES_PER_US);
+}
+
+/****************************************************************************
+ Function
+    _HW_USSince
+ Parameters
+    uint32_t Stamp, from _HW_GetCycleStamp
+ Returns
+    uint32_t   uS since the stamp was taken
+ Description
+    the end of a timed section
+ Notes
+ Author
+    Sander Tonkens, 10/20/26 09:00
+****************************************************************************/
+uint32_t _HW_USSince(uint32_t Stamp)
+{
+  return (_HW_GetCycleStamp() - Stamp) / ES_CYCLES_PER_US;
+}
+
+/****************************************************************************
+ Function
+    _HW_GetTimeUS
+ Parameters
+    none
+ Returns
+    uint64_t   uS since the tick was started
+ Description
+    the monotonic clock for time stamps and long intervals
+ Notes
+ Author
+    Sander Tonkens, 10/20/26 09:00
+****************************************************************************/
+uint64_t _HW_GetTimeUS(void)
+{
+  return NowUS() - StartUS;
+}
+
+/****************************************************************************
+ Function
+    _HW_USToTicks
+ Parameters
+    uint32_t US, a time in uS
+ Returns
+    uint32_t   the number of ticks, rounded up, that last at least US
+ Description
+    for starting the framework timers with a time in uS
+ Notes
+ Author
+    Sander Tonkens, 10/20/26 09:00
+****************************************************************************/
+uint32_t _HW_USToTicks(uint32_t US)
+{
+  if (TickUS == 0)
+  {
+    return 0;
+  }
+  return (uint32_t)(((uint64_t)US + TickUS - 1) / TickUS);
+}
+
+/****************************************************************************
+ Function
+     _HW_PendPreempt / _HW_InPreemptContext
+ Parameters
+     none
+ Returns
+     None / always false
+ Description
+     there is no PendSV on the host, the preemptive services are a target
+     only option
+ Notes
+ Author
+     Sander Tonkens, 10/20/26 09:00
+****************************************************************************/
+void _HW_PendPreempt(void)
+{
+}
+
+bool _HW_InPreemptContext(void)
+{
+  return false;
+}
+
+/****************************************************************************
+ Function
+     ConsoleInit
+ Parameters
+     none
+ Returns
+     none.
+ Description
+     nothing to do, the console is the process's stdin & stdout
+ Notes
+ Author
+     Sander Tonkens, 10/20/26 09:00
+ ****************************************************************************/
+void ConsoleInit(void)
+{
+}
+
+/****************************************************************************
+ Function
+     kbhit
+ Parameters
+     none
+ Returns
+     int 1 if there is input waiting on stdin, 0 if not
+ Description
+     the host version of termio.c's test for a new key, never waits
+ Notes
+     stdin is normally line buffered, so a key shows up with its return
+ Author
+     Sander Tonkens, 10/20/26 09:00
+ ****************************************************************************/
+int kbhit(void)
+{
+  struct pollfd Input = { STDIN_FILENO, POLLIN, 0 };
+
+  return (poll(&Input, 1, 0) > 0) ? 1 : 0;
+}
+
+#ifdef _INCLUDE_BASIC_FRAMEWORK_DEBUG_
+/****************************************************************************
+ Function
+     _HW_DebugLines_Init / _HW_DebugSetLineN / _HW_DebugClearLineN
+ Parameters
+     none
+ Returns
+     None.
+ Description
+     there are no debug lines on the host, these do nothing
+ Notes
+ Author
+     Sander Tonkens, 10/20/26 09:00
+****************************************************************************/
+void _HW_DebugLines_Init(void)
+{
+}
+
+void _HW_DebugSetLine1(void)
+{
+}
+
+void _HW_DebugClearLine1(void)
+{
+}
+
+void _HW_DebugSetLine2(void)
+{
+}
+
+void _HW_DebugClearLine2(void)
+{
+}
+#endif
+
+//*********************************
+// private functions
+//*********************************
+/****************************************************************************
+ Function
+     NowUS
+ Parameters
+     none
+ Returns
+     uint64_t the monotonic clock, in uS
+ Description
+ Notes
+ Author
+     Sander Tonkens, 10/20/26 09:00
+****************************************************************************/
+static uint64_t NowUS(void)
+{
+  struct timespec Now;
+
+  clock_gettime(CLOCK_MONOTONIC, &Now);
+  return ((uint64_t)Now.tv_sec * 1000000u) + ((uint64_t)Now.tv_nsec / 1000u);
+}
+
+/****************************************************************************
+ Function
+     CurrentTick
+ Parameters
+     none
+ Returns
+     uint32_t the number of whole ticks since the tick was started
+ Description
+ Notes
+ Author
+     Sander Tonkens, 10/20/26 09:00
+****************************************************************************/
+static uint32_t CurrentTick(void)
+{
+  if (TickUS == 0)
+  {
+    return 0;
+  }
+  return (uint32_t)((NowUS() - StartUS) / TickUS);
+}
+
+#endif /* ES_HOST_BUILD */
@@ -0,0 +1,318 @@
+/****************************************************************************
+ Module
+   ES_Liveness.c
+
+ Revision
+   1.0.1
+
+ Description
+   Liveness monitor for the services. Each run function has a budget, from
+   ES_RUN_BUDGET_LIST, and the tick interrupt checks the ones that are
+   running against it. While they are all within their budgets, and the
+   main loop is still going round, the tick feeds the watchdog. The first
+   overrun is saved, with the service and the
+   event it was running, in a crash record that survives the reset, and the
+   watchdog is left to reset the exhibit.
+
+ Notes
+   ES_Run's dispatch calls ES_LivenessEnter & ES_LivenessLeave around every
+   run function, and SysTickIntHandler calls ES_LivenessTick. Each service
+   has its own running flag, rather than a bit in a shared mask, so the
+   preemptive services can nest without a critical region.
+   The main loop checks in every time a run function returns
+   (ES_LivenessLeave) and every time the event checkers return
+   (ES_LivenessCheckIn, from ES_RunStep). The tick only feeds the watchdog
+   if there has been a check in since the last feed, or a service with a
+   budget is running, whose budget then covers it (a service with a budget
+   of 0 only has the watchdog timeout). So a hang in an event checker, or
+   anywhere else in ES_Run outside a budgeted run function, stops the feed
+   too, and the exhibit is reset, though without a crash record. A service
+   that is starved, ready but never run because higher priorities keep the
+   loop busy, is not caught: the loop is still going round. Its last
+   progress is in ES_LivenessLastProgress, and in the crash record if
+   something else trips.
+   Watchdog 0 is loaded with WATCHDOG_TIMEOUT_MS. Its first timeout only
+   sets its interrupt flag (the interrupt is not enabled in the NVIC) and
+   the second resets, so the reset comes 1 to 2 timeouts after the last
+   feed. A run function that blocks with the interrupts off stops the tick
+   as well, and the exhibit is reset without a crash record.
+
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/20/26 18:00 ston    the main loop must check in for the watchdog to
+                        be fed
+ 10/20/26 17:00 ston    watchdog reload from ES_CYCLES_PER_MS
+ 10/19/26 23:58 ston    first pass
+
+****************************************************************************/
+// the common headers for C99 types
+#include <stdint.h>
+#include <stdbool.h>
+
+// the headers to access the watchdog hardware
+#include "inc/hw_memmap.h"
+#include "inc/hw_types.h"
+
+// the headers to access the TivaWare Library
+#include "driverlib/sysctl.h"
+#include "driverlib/watchdog.h"
+
+// the framework headers
+#include "ES_Configure.h"
+#include "ES_Port.h"
+#include "ES_Liveness.h"
+
+#ifdef ES_LIVENESS
+
+// module level defines
+#define WATCHDOG_TIMEOUT_MS 100
+#define CRASH_MAGIC 0x4C495645UL
+
+// module level functions
+static void SaveCrash(uint8_t WhichService, uint16_t Now);
+
+// module level variables
+static uint16_t const Budget[NUM_SERVICES] = { ES_RUN_BUDGET_LIST };
+static volatile bool Running[NUM_SERVICES];
+static volatile uint16_t RunStart[NUM_SERVICES];
+static ES_Event_t RunEvent[NUM_SERVICES];
+static volatile uint16_t LastProgress[NUM_SERVICES];
+static volatile bool Started;
+static volatile bool Tripped;
+// set by the main loop, cleared by the tick each time it feeds the watchdog
+static volatile bool CheckedIn;
+
+// kept through the watchdog reset, see ES_NOINIT
+static ES_CrashRecord_t CrashRecord ES_NOINIT;
+
+/****************************************************************************
+ Function
+     ES_LivenessStart
+ Parameters
+     none
+ Returns
+     nothing
+ Description
+     Starts watchdog 0 and the checks. From here on the tick feeds the
+     watchdog only while every running service is within its budget
+ Notes
+     called by ES_Run, so the service inits are not held to the budgets
+ Author
+     Sander Tonkens, 10/19/26, 23:58
+****************************************************************************/
+void ES_LivenessStart(void)
+{
+  uint8_t i;
+
+  for (i = 0; i < NUM_SERVICES; i++)
+  {
+    LastProgress[i] = _HW_GetTickCount();
+  }
+  // enable the clock to the watchdog module
+  SysCtlPeripheralEnable(SYSCTL_PERIPH_WDOG0);
+  while (!SysCtlPeripheralReady(SYSCTL_PERIPH_WDOG0))
+  {}
+  WatchdogReloadSet(WATCHDOG0_BASE, WATCHDOG_TIMEOUT_MS * ES_CYCLES_PER_MS);
+  // don't reset the board while the debugger has it stopped
+  WatchdogStallEnable(WATCHDOG0_BASE);
+  WatchdogResetEnable(WATCHDOG0_BASE);
+  WatchdogEnable(WATCHDOG0_BASE);
+  Started = true;
+}
+
+/****************************************************************************
+ Function
+     ES_LivenessEnter
+ Parameters
+     uint8_t WhichService, the service whose run function is being called
+     ES_Event_t ThisEvent, the event it is being called with
+ Returns
+     nothing
+ Description
+     starts the clock on the service's budget
+ Notes
+     the start time is written before the running flag, so the tick never
+     sees the flag with an old start time
+ Author
+     Sander Tonkens, 10/19/26, 23:58
+****************************************************************************/
+void ES_LivenessEnter(uint8_t WhichService, ES_Event_t ThisEvent)
+{
+  RunEvent[WhichService] = ThisEvent;
+  RunStart[WhichService] = _HW_GetTickCount();
+  Running[WhichService] = true;
+}
+
+/****************************************************************************
+ Function
+     ES_LivenessLeave
+ Parameters
+     uint8_t WhichService, the service whose run function has returned
+ Returns
+     nothing
+ Description
+     stops the clock on the service's budget and notes its progress
+ Notes
+
+ Author
+     Sander Tonkens, 10/19/26, 23:58
+****************************************************************************/
+void ES_LivenessLeave(uint8_t WhichService)
+{
+  Running[WhichService] = false;
+  LastProgress[WhichService] = _HW_GetTickCount();
+  CheckedIn = true;
+}
+
+/****************************************************************************
+ Function
+     ES_LivenessCheckIn
+ Parameters
+     none
+ Returns
+     nothing
+ Description
+     tells the monitor the main loop is still going round, called by
+     ES_RunStep each time the event checkers return
+ Notes
+
+ Author
+     Sander Tonkens, 10/20/26, 18:00
+****************************************************************************/
+void ES_LivenessCheckIn(void)
+{
+  CheckedIn = true;
+}
+
+/****************************************************************************
+ Function
+     ES_LivenessTick
+ Parameters
+     uint16_t Now, the tick count
+ Returns
+     nothing
+ Description
+     checks the running services against their budgets, and feeds the
+     watchdog if they are all within them and the main loop has checked in
+     since the last feed, or a budgeted service is running. The first to
+     overrun is saved in the crash record, and the watchdog is not fed again
+ Notes
+     called from SysTickIntHandler, every tick
+ Author
+     Sander Tonkens, 10/19/26, 23:58
+****************************************************************************/
+void ES_LivenessTick(uint16_t Now)
+{
+  uint8_t i;
+  bool InBudget = false;
+
+  if (!Started || Tripped)
+  {
+    return;
+  }
+  for (i = 0; i < NUM_SERVICES; i++)
+  {
+    if (Running[i] && (Budget[i] != 0))
+    {
+      if ((uint16_t)(Now - RunStart[i]) > Budget[i])
+      {
+        SaveCrash(i, Now);
+        Tripped = true;
+        return;
+      }
+      InBudget = true;
+    }
+  }
+  if (CheckedIn || InBudget)
+  {
+    CheckedIn = false;
+    WatchdogIntClear(WATCHDOG0_BASE);  // feed it, the count starts again
+  }
+}
+
+/****************************************************************************
+ Function
+     ES_LivenessLastProgress
+ Parameters
+     uint8_t WhichService, the service to ask about
+ Returns
+     uint16_t, the tick count when its run function last returned
+ Description
+     for spotting a service that is starved rather than stuck
+ Notes
+
+ Author
+     Sander Tonkens, 10/19/26, 23:58
+****************************************************************************/
+uint16_t ES_LivenessLastProgress(uint8_t WhichService)
+{
+  if (WhichService >= NUM_SERVICES)
+  {
+    return 0;
+  }
+  return LastProgress[WhichService];
+}
+
+/****************************************************************************
+ Function
+     ES_GetCrashRecord
+ Parameters
+     ES_CrashRecord_t *pRecord, where to copy the record
+ Returns
+     bool, true if there was a record from before the reset
+ Description
+     hands back the record of the overrun that caused the last watchdog
+     reset, and clears it so it is only reported once
+ Notes
+     may be called before ES_Initialize, to print it at start up
+ Author
+     Sander Tonkens, 10/19/26, 23:58
+****************************************************************************/
+bool ES_GetCrashRecord(ES_CrashRecord_t *pRecord)
+{
+  if (CrashRecord.Magic != CRASH_MAGIC)
+  {
+    return false;
+  }
+  *pRecord = CrashRecord;
+  CrashRecord.Magic = 0;
+  return true;
+}
+
+//*********************************
+// private functions
+//*********************************
+/****************************************************************************
+ Function
+     SaveCrash
+ Parameters
+     uint8_t WhichService, the service that overran
+     uint16_t Now, the tick count
+ Returns
+     nothing
+ Description
+     fills in the crash record, the magic number last so a reset part way
+     through does not leave a record that looks valid
+ Notes
+
+ Author
+     Sander Tonkens, 10/19/26, 23:58
+****************************************************************************/
+static void SaveCrash(uint8_t WhichService, uint16_t Now)
+{
+  uint8_t i;
+
+  CrashRecord.Magic = 0;
+  CrashRecord.Service = WhichService;
+  CrashRecord.Event = RunEvent[WhichService];
+  CrashRecord.Tick = Now;
+  CrashRecord.RunTicks = Now - RunStart[WhichService];
+  for (i = 0; i < NUM_SERVICES; i++)
+  {
+    CrashRecord.LastProgress[i] = LastProgress[i];
+  }
+  CrashRecord.Magic = CRASH_MAGIC;
+}
+
+#endif /* ES_LIVENESS */
@@ -15,6 +15,15 @@
  History
  When           Who     What/Why
  -------------- ---     --------
+ 10/20/26 17:00 ston    the clock comes from ES_CLOCK_HZ in ES_Port.h
+ 10/19/26 23:58 ston    the tick runs the liveness monitor's checks
+ 10/21/26 12:00 ston    _HW_GetCycleStamp counts a pending tick, as
+                        _HW_GetTimeUS does
+ 10/19/26 23:30 ston    added the 64 bit uS clock, _HW_GetTimeUS, and
+                        _HW_USToTicks for timer durations in uS
+ 10/19/26 15:00 ston    added PendSV support for the preemptive services
+ 10/19/26 14:00 ston    added _HW_GetCycleStamp/_HW_USSince for timing
+                        sections shorter than a tick
  08/21/17 13:47 jec     added functions to init 2 lines for debugging the framework
                         and functions to set & clear those lines.
  03/13/14 10:30	joa		  Updated files to use with Cortex M4 processor core.
@@ -29,6 +38,8 @@
 #include "inc/hw_types.h"
 #include "inc/hw_gpio.h"
 #include "inc/hw_sysctl.h"
+#include "inc/hw_nvic.h"
+#include "inc/hw_ints.h"
 #include "driverlib/sysctl.h"
 #include "driverlib/interrupt.h"
 #include "driverlib/uart.h"
@@ -40,11 +51,11 @@
 #include "ES_Port.h"
 #include "ES_Types.h"
 #include "ES_Timers.h"
+#include "ES_Framework.h"
 
 #define UART_PORT 0
 #define UART_BAUD 115200UL
 #define SRC_CLK_FREQ 16000000UL
-#define CLK_FREQ 40000000UL
 
 // change the base address for the debug lines here
 #define DEBUG_PORT GPIO_PORTF_BASE
@@ -77,6 +88,11 @@ static volatile uint8_t TickCount;
 // make uint16_t to maintain backwards compatibility and not overly burden
 // 8 and 16 bit processors
 static volatile uint16_t SysTickCounter = 0;
+// and the ticks above those 16 bits, for the 64 bit uS clock
+static volatile uint32_t SysTickWraps = 0;
+
+// SysTick reload, in cycles, saved to turn tick counts into cycles
+static uint32_t SysTickPeriod = 1;
 
 // This variable is used to store the state of the interrupt mask when
 // doing EnterCritical/ExitCritical pairs
@@ -102,6 +118,13 @@ uint32_t _PRIMASK_temp;
 void _HW_Timer_Init(TimerRate_t Rate)
 {
   SysTickPeriodSet(Rate); /* Set the SysTick Interrupt Rate */
+  SysTickPeriod = Rate;
+#ifdef ES_PREEMPT_THRESHOLD
+  // SysTick under the critical region ceiling, PendSV below everything so
+  // the preemptive services only run once the interrupts are done
+  IntPrioritySet(FAULT_SYSTICK, ES_KERNEL_IRQ_PRIORITY);
+  IntPrioritySet(FAULT_PENDSV, ES_PENDSV_PRIORITY);
+#endif
   SysTickIntEnable();     /* Enable the SysTick Interrupt */
   SysTickEnable();        /* Enable SysTick */
   IntMasterEnable();      /* Make sure interrupts are enabled */
@@ -128,7 +151,13 @@ void SysTickIntHandler(void)
 {
   /* Interrupt automatically cleared by hardware */
   ++TickCount;          /* flag that it occurred and needs a response */
-  ++SysTickCounter;     // keep the free running time going
+  if (++SysTickCounter == 0)  // keep the free running time going
+  {
+    ++SysTickWraps;
+  }
+#ifdef ES_LIVENESS
+  ES_LivenessTick(SysTickCounter);  // and feed the watchdog if all is well
+#endif
 #ifdef LED_DEBUG
   BlinkLED();
 #endif
@@ -154,6 +183,199 @@ uint16_t _HW_GetTickCount(void)
   return SysTickCounter;
 }
 
+/****************************************************************************
+ Function
+    _HW_GetCycleStamp()
+ Parameters
+    none
+ Returns
+    uint32_t   a time stamp in CPU cycles, for use with _HW_USSince
+ Description
+    combines the tick count with the SysTick down counter to time things
+    much shorter than a tick
+ Notes
+    wraps every 65536 ticks, _HW_USSince takes care of that. The counts
+    are re-read until they are stable, and a tick that has reloaded the
+    SysTick but not yet been counted is added, as in _HW_GetTimeUS, so a
+    stamp taken with interrupts held off never steps backwards.
+ Author
+    Sander Tonkens, 10/19/26 14:00
+****************************************************************************/
+uint32_t _HW_GetCycleStamp(void)
+{
+  uint16_t Ticks;
+  uint32_t Current;
+  uint32_t Again;
+  bool TickPending;
+
+  do
+  {
+    Ticks = SysTickCounter;
+    Current = HWREG(NVIC_ST_CURRENT);
+    TickPending = (HWREG(NVIC_INT_CTRL) & NVIC_INT_CTRL_PENDSTSET) != 0;
+    Again = HWREG(NVIC_ST_CURRENT);
+    // SysTick counts down, so Again above Current means it reloaded
+  } while ((Ticks != SysTickCounter) || (Again > Current));
+  if (TickPending)
+  {
+    Ticks++;    // wraps with the 16 bit count, which _HW_USSince allows for
+  }
+  return ((uint32_t)Ticks * SysTickPeriod) + (SysTickPeriod - 1 - Current);
+}
+
+/****************************************************************************
+ Function
+    _HW_USSince()
+ Parameters
+    uint32_t Stamp, an earlier value from _HW_GetCycleStamp
+ Returns
+    uint32_t   uS elapsed since Stamp
+ Description
+    for timing sections of code, such as the event checker budget
+ Notes
+ Author
+    Sander Tonkens, 10/19/26 14:00
+****************************************************************************/
+uint32_t _HW_USSince(uint32_t Stamp)
+{
+  uint32_t Now = _HW_GetCycleStamp();
+  uint32_t Elapsed;
+  if (Now >= Stamp)
+  {
+    Elapsed = Now - Stamp;
+  }
+  else
+  { // the tick count wrapped
+    Elapsed = (Now + (0x10000UL * SysTickPeriod)) - Stamp;
+  }
+  return Elapsed / ES_CYCLES_PER_US;
+}
+
+/****************************************************************************
+ Function
+    _HW_GetTimeUS()
+ Parameters
+    none
+ Returns
+    uint64_t   uS since the tick was started
+ Description
+    a monotonic clock for time stamps and long intervals, the tick count
+    extended to 48 bits by SysTickWraps plus the time into the current tick
+ Notes
+    The counts are re-read until they are stable. A tick that has reloaded
+    the SysTick but not yet been counted, because interrupts are held off,
+    is added here, so the clock never steps backwards.
+ Author
+    Sander Tonkens, 10/19/26 23:30
+****************************************************************************/
+uint64_t _HW_GetTimeUS(void)
+{
+  uint32_t Wraps;
+  uint16_t Ticks;
+  uint32_t Current;
+  uint32_t Again;
+  bool TickPending;
+  uint64_t AllTicks;
+
+  do
+  {
+    Wraps = SysTickWraps;
+    Ticks = SysTickCounter;
+    Current = HWREG(NVIC_ST_CURRENT);
+    TickPending = (HWREG(NVIC_INT_CTRL) & NVIC_INT_CTRL_PENDSTSET) != 0;
+    Again = HWREG(NVIC_ST_CURRENT);
+    // SysTick counts down, so Again above Current means it reloaded
+  } while ((Wraps != SysTickWraps) || (Ticks != SysTickCounter) ||
+           (Again > Current));
+  AllTicks = ((uint64_t)Wraps << 16) | Ticks;
+  if (TickPending)
+  {
+    AllTicks++;
+  }
+  return ((AllTicks * SysTickPeriod) + (SysTickPeriod - 1 - Current)) /
+         ES_CYCLES_PER_US;
+}
+
+/****************************************************************************
+ Function
+    _HW_USToTicks()
+ Parameters
+    uint32_t US, a time in uS
+ Returns
+    uint32_t   the number of ticks, rounded up, that last at least US
+ Description
+    for starting the framework timers with a time in uS
+ Notes
+ Author
+    Sander Tonkens, 10/19/26 23:30
+****************************************************************************/
+uint32_t _HW_USToTicks(uint32_t US)
+{
+  uint64_t Cycles = (uint64_t)US * ES_CYCLES_PER_US;
+  return (uint32_t)((Cycles + SysTickPeriod - 1) / SysTickPeriod);
+}
+
+/****************************************************************************
+ Function
+     _HW_PendPreempt
+ Parameters
+     none
+ Returns
+     None.
+ Description
+     requests the PendSV exception, which runs the ready preemptive services
+     as soon as no other interrupt is active
+ Notes
+ Author
+     Sander Tonkens, 10/19/26 15:00
+****************************************************************************/
+void _HW_PendPreempt(void)
+{
+  HWREG(NVIC_INT_CTRL) = NVIC_INT_CTRL_PEND_SV;
+}
+
+/****************************************************************************
+ Function
+     _HW_InPreemptContext
+ Parameters
+     none
+ Returns
+     bool true if the code is running from the PendSV exception
+ Description
+     lets a post made by a preemptive service run a still higher priority
+     service straight away, rather than pending PendSV again
+ Notes
+     reads the active exception number from the interrupt control register
+ Author
+     Sander Tonkens, 10/19/26 15:00
+****************************************************************************/
+bool _HW_InPreemptContext(void)
+{
+  return (HWREG(NVIC_INT_CTRL) & NVIC_INT_CTRL_VEC_ACT_M) == FAULT_PENDSV;
+}
+
+/****************************************************************************
+ Function
+     PendSVIntHandler
+ Parameters
+     none
+ Returns
+     None.
+ Description
+     interrupt response for PendSV, hands over to the framework to run the
+     preemptive services
+ Notes
+     never pended unless ES_PREEMPT_THRESHOLD is defined
+ Author
+     Sander Tonkens, 10/19/26 15:00
+****************************************************************************/
+void PendSVIntHandler(void)
+{
+#ifdef ES_PREEMPT_THRESHOLD
+  ES_RunPreemptive();
+#endif
+}
+
 /****************************************************************************
  Function
      _HW_Process_Pending_Ints
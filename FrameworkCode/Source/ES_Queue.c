@@ -9,6 +9,10 @@
  History
  When           Who     What/Why
  -------------- ---     --------
+ 10/21/26 11:00 ston     added ES_SpliceQueueClass, for splicing by queue level
+ 10/19/26 23:54 ston     added ES_SpliceQueue & the overflow count
+ 10/19/26 16:00 ston     test for space inside the critical region, so two
+                         posts from different contexts can't overfill it
  01/15/12 09:34 jec      converted to use the new C99 types from types.h
  08/09/11 18:16 jec      started coding
 *****************************************************************************/
@@ -22,16 +26,25 @@
 // CurrentIndex is the 'read-from' index,
 // actually CurrentIndex + sizeof(EF_Queue_t)
 // entries are made to CurrentIndex + NumEntries + sizeof(ES_Queue_t)
+// Overflows counts the adds that found the queue full, it stops at 255.
+// It uses the byte that was padding, so the struct still fits in the
+// ES_Event at the start of the block
 typedef struct
 {
   uint8_t QueueSize;
   uint8_t CurrentIndex;
   uint8_t NumEntries;
+  uint8_t Overflows;
 }ES_Queue_t;
 
 typedef ES_Queue_t *pQueue_t;
 
 /*---------------------------- Module Functions ---------------------------*/
+static void CountOverflow(pQueue_t pThisQueue);
+static uint8_t Splice(ES_Event_t *pTo, ES_Event_t *pFrom,
+    ES_EventType_t Match, uint8_t const *pClassOf, uint8_t Class);
+static bool IsToMove(ES_EventType_t EventType, ES_EventType_t Match,
+    uint8_t const *pClassOf, uint8_t Class);
 
 /*---------------------------- Module Variables ---------------------------*/
 
@@ -49,7 +62,7 @@ typedef ES_Queue_t *pQueue_t;
  Notes
    you should pass it a block that is at least sizeof(ES_Queue_t) larger than
    the number of entries that you want in the queue. Since the size of an
-   ES_Event (at 4 bytes; 2 enum, 2 param) is greater than the
+   ES_Event (at 4 bytes; 2 enum, 2 param) is no smaller than the
    sizeof(ES_Queue_t), you only need to declare an array of ES_Event
    with 1 more element than you need for the actual queue.
  Author
@@ -64,6 +77,7 @@ uint8_t ES_InitQueue(ES_Event_t *pBlock, uint8_t BlockSize)
   pThisQueue->QueueSize     = BlockSize - 1;
   pThisQueue->CurrentIndex  = 0;
   pThisQueue->NumEntries    = 0;
+  pThisQueue->Overflows     = 0;
   return pThisQueue->QueueSize;
 }
 
@@ -86,11 +100,11 @@ bool ES_EnQueueFIFO(ES_Event_t *pBlock, ES_Event_t Event2Add)
 {
   pQueue_t pThisQueue;
   pThisQueue = (pQueue_t)pBlock;
+  EnterCritical();  // save interrupt state, turn ints off
   // index will go from 0 to QueueSize-1 so use '<' to test if there is space
   if (pThisQueue->NumEntries < pThisQueue->QueueSize) // save the new event, use % to create circular buffer in block
   {   // 1+ to step past the Queue struct at the beginning of the
                       // block
-    EnterCritical();  // save interrupt state, turn ints off
     pBlock[1 + ((pThisQueue->CurrentIndex + pThisQueue->NumEntries)
           % pThisQueue->QueueSize)] = Event2Add;
     pThisQueue->NumEntries++; // inc number of entries
@@ -100,6 +114,8 @@ bool ES_EnQueueFIFO(ES_Event_t *pBlock, ES_Event_t Event2Add)
   }
   else
   {
+    CountOverflow(pThisQueue);
+    ExitCritical();
     return false;
   }
 }
@@ -125,10 +141,10 @@ bool ES_EnQueueLIFO(ES_Event_t *pBlock, ES_Event_t Event2Add)
 {
   pQueue_t pThisQueue;
   pThisQueue = (pQueue_t)pBlock;
+  EnterCritical();     // save interrupt state, turn ints off
   // index will go from 0 to QueueSize-1 so use '<' to test if there is space
   if (pThisQueue->NumEntries < pThisQueue->QueueSize)
   {
-    EnterCritical();     // save interrupt state, turn ints off
     // OK, there is space note that the queue now has 1 more entry
     pThisQueue->NumEntries++;
     // Check to see if we need to wrap around as we back up index
@@ -146,6 +162,8 @@ bool ES_EnQueueLIFO(ES_Event_t *pBlock, ES_Event_t Event2Add)
   }
   else    // in case no room on the queue
   {
+    CountOverflow(pThisQueue);
+    ExitCritical();
     return false;
   }
 }
@@ -218,6 +236,77 @@ bool ES_IsQueueEmpty(ES_Event_t *pBlock)
   return pThisQueue->NumEntries == 0;
 }
 
+/****************************************************************************
+ Function
+   ES_SpliceQueue
+ Parameters
+   ES_Event * pTo : the Queue to move the events to
+   ES_Event * pFrom : the Queue to move them from
+   ES_EventType_t Match : only events of this type are moved, ES_NO_EVENT
+                          moves them all
+ Returns
+   uint8_t : the number of events moved
+ Description
+   moves the events from pFrom to the front of pTo, as one block that keeps
+   the order they had in pFrom, so the oldest of them is the next event to
+   be removed from pTo. Events that are not moved close up in pFrom, in
+   their order.
+ Notes
+   done in a single critical region, rather than an add and a remove per
+   event. If pTo does not have room for all of them, the oldest that fit are
+   moved and the rest stay in pFrom; that is not counted as an overflow.
+ Author
+   Sander Tonkens, 10/19/26, 23:54
+****************************************************************************/
+uint8_t ES_SpliceQueue(ES_Event_t *pTo, ES_Event_t *pFrom,
+    ES_EventType_t Match)
+{
+  return Splice(pTo, pFrom, Match, NULL, 0);
+}
+
+/****************************************************************************
+ Function
+   ES_SpliceQueueClass
+ Parameters
+   ES_Event * pTo : the Queue to move the events to
+   ES_Event * pFrom : the Queue to move them from
+   uint8_t const * pClassOf : a class for each event type, indexed by type
+   uint8_t Class : only events whose type is in this class are moved
+ Returns
+   uint8_t : the number of events moved
+ Description
+   as ES_SpliceQueue, but for all of the events of a class of types, such
+   as the framework's queue levels, rather than of one type
+ Notes
+   pClassOf must have an entry for every event type in pFrom
+ Author
+   Sander Tonkens, 10/21/26, 11:00
+****************************************************************************/
+uint8_t ES_SpliceQueueClass(ES_Event_t *pTo, ES_Event_t *pFrom,
+    uint8_t const *pClassOf, uint8_t Class)
+{
+  return Splice(pTo, pFrom, ES_NO_EVENT, pClassOf, Class);
+}
+
+/****************************************************************************
+ Function
+   ES_QueueOverflows
+ Parameters
+   ES_Event * pBlock : pointer to the block of memory in use as the Queue
+ Returns
+   uint8_t : the number of adds that have failed for lack of room, up to 255
+ Description
+   for sizing queues, and deferral queues in particular
+ Notes
+
+ Author
+   Sander Tonkens, 10/19/26, 23:54
+****************************************************************************/
+uint8_t ES_QueueOverflows(ES_Event_t *pBlock)
+{
+  return ((pQueue_t)pBlock)->Overflows;
+}
+
 #if 0
 /****************************************************************************
  Function
@@ -248,6 +337,155 @@ void QueueFlushQueue(uint8_t *pBlock)
 /***************************************************************************
  private functions
  ***************************************************************************/
+/****************************************************************************
+ Function
+   CountOverflow
+ Parameters
+   pQueue_t : the Queue that an add found full
+ Returns
+   nothing
+ Description
+   counts the failed add, stopping at 255 rather than wrapping
+ Notes
+   called inside the adding function's critical region
+ Author
+   Sander Tonkens, 10/19/26, 23:54
+****************************************************************************/
+static void CountOverflow(pQueue_t pThisQueue)
+{
+  if (pThisQueue->Overflows < 0xFF)
+  {
+    pThisQueue->Overflows++;
+  }
+}
+
+/****************************************************************************
+ Function
+   Splice
+ Parameters
+   ES_Event * pTo : the Queue to move the events to
+   ES_Event * pFrom : the Queue to move them from
+   ES_EventType_t Match : the type to move, ES_NO_EVENT for any
+   uint8_t const * pClassOf : NULL, or the class of each event type
+   uint8_t Class : the class to move, when pClassOf is not NULL
+ Returns
+   uint8_t : the number of events moved
+ Description
+   the work of ES_SpliceQueue & ES_SpliceQueueClass
+ Notes
+   done in a single critical region, see ES_SpliceQueue
+ Author
+   Sander Tonkens, 10/19/26, 23:54
+****************************************************************************/
+static uint8_t Splice(ES_Event_t *pTo, ES_Event_t *pFrom,
+    ES_EventType_t Match, uint8_t const *pClassOf, uint8_t Class)
+{
+  pQueue_t    pToQueue = (pQueue_t)pTo;
+  pQueue_t    pFromQueue = (pQueue_t)pFrom;
+  ES_Event_t  ThisEvent;
+  uint8_t     ToMove;
+  uint8_t     Moved = 0;
+  uint8_t     Read;
+  uint8_t     Write;
+  uint8_t     Put;
+  uint8_t     i;
+
+  EnterCritical();     // save interrupt state, turn ints off
+  // first find how many will move, so we know where the block starts in pTo
+  ToMove = pToQueue->QueueSize - pToQueue->NumEntries;
+  if ((ES_NO_EVENT == Match) && (NULL == pClassOf))
+  {
+    if (pFromQueue->NumEntries < ToMove)
+    {
+      ToMove = pFromQueue->NumEntries;
+    }
+  }
+  else
+  {
+    Read = pFromQueue->CurrentIndex;
+    for (i = 0; (i < pFromQueue->NumEntries) && (Moved < ToMove); i++)
+    {
+      if (IsToMove(pFrom[1 + Read].EventType, Match, pClassOf, Class))
+      {
+        Moved++;
+      }
+      if (++Read >= pFromQueue->QueueSize)
+      {
+        Read = 0;
+      }
+    }
+    ToMove = Moved;
+    Moved = 0;
+  }
+  if (ToMove > 0)
+  {
+    // back the read-from index up over the block, wrapping if need be
+    Put = (pToQueue->CurrentIndex >= ToMove) ?
+        (pToQueue->CurrentIndex - ToMove) :
+        (pToQueue->CurrentIndex + pToQueue->QueueSize - ToMove);
+    pToQueue->CurrentIndex = Put;
+    pToQueue->NumEntries += ToMove;
+    // Write, for the events that stay, never passes Read, so closing them up
+    // never writes over one that has not been read yet
+    Read = pFromQueue->CurrentIndex;
+    Write = Read;
+    for (i = pFromQueue->NumEntries; i > 0; i--)
+    {
+      ThisEvent = pFrom[1 + Read];
+      if (++Read >= pFromQueue->QueueSize)
+      {
+        Read = 0;
+      }
+      if ((Moved < ToMove) &&
+          IsToMove(ThisEvent.EventType, Match, pClassOf, Class))
+      {
+        pTo[1 + Put] = ThisEvent;
+        if (++Put >= pToQueue->QueueSize)
+        {
+          Put = 0;
+        }
+        Moved++;
+      }
+      else
+      {
+        pFrom[1 + Write] = ThisEvent;
+        if (++Write >= pFromQueue->QueueSize)
+        {
+          Write = 0;
+        }
+      }
+    }
+    pFromQueue->NumEntries -= Moved;
+  }
+  ExitCritical();    // restore saved interrupt state
+  return Moved;
+}
+
+/****************************************************************************
+ Function
+   IsToMove
+ Parameters
+   ES_EventType_t EventType : the type of an event in the from queue
+   ES_EventType_t Match, uint8_t const * pClassOf, uint8_t Class : as Splice
+ Returns
+   bool : true if the event is one of those to move
+ Description
+   the test Splice applies to each event
+ Notes
+
+ Author
+   Sander Tonkens, 10/21/26, 11:00
+****************************************************************************/
+static bool IsToMove(ES_EventType_t EventType, ES_EventType_t Match,
+    uint8_t const *pClassOf, uint8_t Class)
+{
+  if (NULL != pClassOf)
+  {
+    return pClassOf[EventType] == Class;
+  }
+  return (ES_NO_EVENT == Match) || (Match == EventType);
+}
+
 #ifdef TEST
 
 #include <stdio.h>
@@ -21,6 +21,8 @@
  -------------- ---     --------
  10/11/15 10:30 jec     first pass
  10/11/15 18:10 jec     converted to post events to the framework
+ 10/19/26 15:00 ston    timer interrupts at the kernel priority when the
+                        preemptive services are configured
 
 ****************************************************************************/
 // the common headers for I/O, C99 types
@@ -91,6 +93,11 @@ void ES_ShortTimerInit(uint8_t TimeAPrio, uint8_t TimeBPrio)
 // log the service to which the timeout will be posted
   Timer_A_Priority  = TimeAPrio;
   Timer_B_Priority  = TimeBPrio;
+#ifdef ES_PREEMPT_THRESHOLD
+// the timeouts post to services, so they must be held off by EnterCritical
+  IntPrioritySet(INT_TIMER5A_TM4C123, ES_KERNEL_IRQ_PRIORITY);
+  IntPrioritySet(INT_TIMER5B_TM4C123, ES_KERNEL_IRQ_PRIORITY);
+#endif
 }
 
 void ES_ShortTimerStart(uint32_t Which, uint16_t TimeoutValue)
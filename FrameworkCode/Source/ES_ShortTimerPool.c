@@ -0,0 +1,487 @@
+/****************************************************************************
+ Module
+   ES_ShortTimerPool.c
+
+ Revision
+   1.0.1
+
+ Description
+   A pool of SHORT_TIMER_POOL_SIZE uS resolution one shot timers, each of
+   which posts an ES_SHORT_TIMEOUT, with the timer's number in EventParam,
+   to the service it was started for.
+
+ Notes
+   Timer 4 runs as one free running 32 bit up counter at the CPU clock and
+   is never reloaded. The armed timers are kept in a min-heap on their
+   deadlines, and the counter's match register is set to the earliest one,
+   so starting or stopping a timer is O(log n) and the interrupt only comes
+   when something is due. Deadlines are compared as signed differences from
+   each other, which works across the counter wrapping as long as no
+   timeout is longer than SHORT_TIMER_POOL_MAX_US.
+   The pool numbers do not clash with the TIMER_A & TIMER_B EventParams of
+   ES_ShortTimer, so a service can use both.
+   Stopping a timer that has already posted its timeout does not take the
+   event back out of the queue.
+
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/19/26 23:45 ston    first pass
+
+****************************************************************************/
+// the common headers for I/O, C99 types
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "BITDEFS.H"
+
+// the headers to access the timer hardware
+#include "inc/hw_memmap.h"
+#include "inc/hw_types.h"
+#include "inc/hw_timer.h"
+#include "inc/hw_ints.h"
+
+// the headers to access the TivaWare Library
+#include "driverlib/sysctl.h"
+#include "driverlib/timer.h"
+#include "driverlib/interrupt.h"
+
+// the header to get the timing functions
+#include "ES_ShortTimerPool.h"
+
+// the framework headers
+#include "ES_Configure.h"
+#include "ES_Framework.h"
+
+// module level defines
+#define NOT_ARMED 0xFF
+
+// module level functions
+static void SetNextMatch(void);
+static void SiftUp(uint8_t Pos);
+static void SiftDown(uint8_t Pos);
+static void HeapRemove(uint8_t Pos);
+static bool IsEarlier(uint8_t NumA, uint8_t NumB);
+static void Place(uint8_t Pos, uint8_t Num);
+
+// module level variables
+static uint32_t Deadline[SHORT_TIMER_POOL_SIZE];  // counter value when due
+static uint8_t TargetService[SHORT_TIMER_POOL_SIZE];
+static uint8_t HeapPos[SHORT_TIMER_POOL_SIZE];    // NOT_ARMED or in Heap
+static uint8_t Heap[SHORT_TIMER_POOL_SIZE];       // timer numbers, min first
+static uint8_t NumArmed;
+#ifdef ES_LATENCY_STATS
+// longest the interrupt has taken, in cycles, by how many were armed
+static uint32_t WorstISRCycles[SHORT_TIMER_POOL_SIZE + 1];
+#endif
+
+/****************************************************************************
+ Function
+     ES_ShortTimerPoolInit
+ Parameters
+     none
+ Returns
+     nothing
+ Description
+     Starts Timer 4 free running and empties the pool
+ Notes
+     Call once, before any of the pool timers are started
+ Author
+     Sander Tonkens, 10/19/26, 23:45
+****************************************************************************/
+void ES_ShortTimerPoolInit(void)
+{
+  uint8_t i;
+
+  for (i = 0; i < SHORT_TIMER_POOL_SIZE; i++)
+  {
+    HeapPos[i] = NOT_ARMED;
+  }
+  NumArmed = 0;
+
+  // enable the clock to the timer module
+  SysCtlPeripheralEnable(SYSCTL_PERIPH_TIMER4);
+  while (!SysCtlPeripheralReady(SYSCTL_PERIPH_TIMER4))
+  {}
+  // one 32 bit timer counting up through its whole range
+  TimerConfigure(TIMER4_BASE, TIMER_CFG_PERIODIC_UP);
+  TimerLoadSet(TIMER4_BASE, TIMER_A, 0xFFFFFFFF);
+  // the match interrupt has to be turned on in the mode register as well
+  HWREG(TIMER4_BASE + TIMER_O_TAMR) |= TIMER_TAMR_TAMIE;
+  TimerIntEnable(TIMER4_BASE, TIMER_TIMA_MATCH);
+#ifdef ES_PREEMPT_THRESHOLD
+  // the timeouts post to services, so they must be held off by EnterCritical
+  IntPrioritySet(INT_TIMER4A_TM4C123, ES_KERNEL_IRQ_PRIORITY);
+#endif
+  IntEnable(INT_TIMER4A_TM4C123);
+  TimerEnable(TIMER4_BASE, TIMER_A);
+}
+
+/****************************************************************************
+ Function
+     ES_ShortTimerPoolStart
+ Parameters
+     uint8_t Num, the pool timer, 0 to SHORT_TIMER_POOL_SIZE - 1
+     uint8_t WhichService, the service to post the timeout to
+     uint32_t US, the time until the timeout
+ Returns
+     bool, false if the timer, service or time is out of range
+ Description
+     (Re)starts a pool timer, a timer that is already running starts again
+     from now
+ Notes
+     A time of 0 posts the timeout from the interrupt, straight away
+ Author
+     Sander Tonkens, 10/19/26, 23:45
+****************************************************************************/
+bool ES_ShortTimerPoolStart(uint8_t Num, uint8_t WhichService, uint32_t US)
+{
+  if ((Num >= SHORT_TIMER_POOL_SIZE) || (WhichService >= NUM_SERVICES) ||
+      (US > SHORT_TIMER_POOL_MAX_US))
+  {
+    return false;
+  }
+  EnterCritical();
+  if (HeapPos[Num] != NOT_ARMED)
+  {
+    HeapRemove(HeapPos[Num]);
+  }
+  Deadline[Num] = ES_ShortTimerPoolNow() +
+                  (US * SHORT_TIMER_POOL_CYCLES_PER_US);
+  TargetService[Num] = WhichService;
+  Place(NumArmed, Num);
+  NumArmed++;
+  SiftUp(HeapPos[Num]);
+  if (Heap[0] == Num)
+  {
+    SetNextMatch();
+  }
+  ExitCritical();
+  return true;
+}
+
+/****************************************************************************
+ Function
+     ES_ShortTimerPoolStop
+ Parameters
+     uint8_t Num, the pool timer
+ Returns
+     bool, true if the timer was running
+ Description
+     Stops a pool timer before it times out
+ Notes
+     The match is left on the old deadline when the earliest timer is
+     stopped, the interrupt then finds nothing due and moves it on
+ Author
+     Sander Tonkens, 10/19/26, 23:45
+****************************************************************************/
+bool ES_ShortTimerPoolStop(uint8_t Num)
+{
+  bool WasArmed = false;
+
+  if (Num < SHORT_TIMER_POOL_SIZE)
+  {
+    EnterCritical();
+    if (HeapPos[Num] != NOT_ARMED)
+    {
+      HeapRemove(HeapPos[Num]);
+      WasArmed = true;
+    }
+    ExitCritical();
+  }
+  return WasArmed;
+}
+
+/****************************************************************************
+ Function
+     ES_ShortTimerPoolIsArmed
+ Parameters
+     uint8_t Num, the pool timer
+ Returns
+     bool, true if the timer is running
+ Description
+     Query function
+ Notes
+
+ Author
+     Sander Tonkens, 10/19/26, 23:45
+****************************************************************************/
+bool ES_ShortTimerPoolIsArmed(uint8_t Num)
+{
+  return (Num < SHORT_TIMER_POOL_SIZE) && (HeapPos[Num] != NOT_ARMED);
+}
+
+/****************************************************************************
+ Function
+     ES_ShortTimerPoolNow
+ Parameters
+     none
+ Returns
+     uint32_t, the free running count, in CPU cycles
+ Description
+     For time stamps finer than a uS, differences are good across the wrap
+     as long as they are taken as uint32_t
+ Notes
+
+ Author
+     Sander Tonkens, 10/19/26, 23:45
+****************************************************************************/
+uint32_t ES_ShortTimerPoolNow(void)
+{
+  return TimerValueGet(TIMER4_BASE, TIMER_A);
+}
+
+/****************************************************************************
+ Function
+     ES_ShortTimerPoolWorstISR
+ Parameters
+     uint8_t NumArmed, how many pool timers were running
+ Returns
+     uint32_t, the longest the interrupt has taken, in CPU cycles, when it
+     started with that many timers running
+ Description
+     For measuring the cost of the pool, only kept with ES_LATENCY_STATS
+ Notes
+     Counts from the interrupt handler's first instruction, so the entry
+     and exit of the interrupt itself are not included
+ Author
+     Sander Tonkens, 10/19/26, 23:45
+****************************************************************************/
+uint32_t ES_ShortTimerPoolWorstISR(uint8_t NumArmed)
+{
+#ifdef ES_LATENCY_STATS
+  if (NumArmed <= SHORT_TIMER_POOL_SIZE)
+  {
+    return WorstISRCycles[NumArmed];
+  }
+#endif
+  return 0;
+}
+
+/****************************************************************************
+ Function
+     ShortTimerPoolHandler
+ Parameters
+     none
+ Returns
+     nothing
+ Description
+     Timer 4A match interrupt: posts the timeout of every pool timer that
+     is due, then moves the match on to the next deadline
+ Notes
+     The timeouts are queued first and their services' Ready bits set
+     together, as the framework timer tick does
+ Author
+     Sander Tonkens, 10/19/26, 23:45
+****************************************************************************/
+void ShortTimerPoolHandler(void)
+{
+  ES_Event_t ThisEvent;
+  uint16_t TimedOut = 0;
+  uint8_t Num;
+#ifdef ES_LATENCY_STATS
+  uint32_t StartCount = ES_ShortTimerPoolNow();
+  uint8_t StartArmed = NumArmed;
+  uint32_t Cycles;
+#endif
+
+  // start by clearing the source of the interrupt
+  TimerIntClear(TIMER4_BASE, TIMER_TIMA_MATCH);
+
+  ThisEvent.EventType = ES_SHORT_TIMEOUT;
+  while ((NumArmed > 0) &&
+         ((int32_t)(Deadline[Heap[0]] - ES_ShortTimerPoolNow()) <= 0))
+  {
+    Num = Heap[0];
+    HeapRemove(0);
+    ThisEvent.EventParam = Num;
+    if (ES_EnQueueToService(TargetService[Num], ThisEvent))
+    {
+      TimedOut |= BIT0HI << TargetService[Num];
+    }
+  }
+  if (TimedOut != 0)
+  {
+    ES_MarkServicesReady(TimedOut);
+  }
+  if (NumArmed > 0)
+  {
+    SetNextMatch();
+  }
+#ifdef ES_LATENCY_STATS
+  Cycles = ES_ShortTimerPoolNow() - StartCount;
+  if (Cycles > WorstISRCycles[StartArmed])
+  {
+    WorstISRCycles[StartArmed] = Cycles;
+  }
+#endif
+}
+
+//******************************
+// private functions
+//******************************
+
+/****************************************************************************
+ Function
+     SetNextMatch
+ Parameters
+     none
+ Returns
+     nothing
+ Description
+     Sets the match to the earliest deadline. If the counter is already
+     past it, the match would not come round again until the counter
+     wraps, so the interrupt is pended instead
+ Notes
+     Call with at least one timer armed, from the interrupt or inside a
+     critical region
+ Author
+     Sander Tonkens, 10/19/26, 23:45
+****************************************************************************/
+static void SetNextMatch(void)
+{
+  TimerMatchSet(TIMER4_BASE, TIMER_A, Deadline[Heap[0]]);
+  if ((int32_t)(Deadline[Heap[0]] - ES_ShortTimerPoolNow()) <= 0)
+  {
+    IntPendSet(INT_TIMER4A_TM4C123);
+  }
+}
+
+/****************************************************************************
+ Function
+     IsEarlier
+ Parameters
+     uint8_t NumA, uint8_t NumB, two armed pool timers
+ Returns
+     bool, true if NumA is due before NumB
+ Description
+     Compares the deadlines as a signed difference, so the wrap of the
+     counter between them does not matter
+ Notes
+
+ Author
+     Sander Tonkens, 10/19/26, 23:45
+****************************************************************************/
+static bool IsEarlier(uint8_t NumA, uint8_t NumB)
+{
+  return (int32_t)(Deadline[NumA] - Deadline[NumB]) < 0;
+}
+
+/****************************************************************************
+ Function
+     Place
+ Parameters
+     uint8_t Pos, the place in the heap
+     uint8_t Num, the pool timer to put there
+ Returns
+     nothing
+ Description
+     Puts a timer in the heap and keeps its back pointer up to date
+ Notes
+
+ Author
+     Sander Tonkens, 10/19/26, 23:45
+****************************************************************************/
+static void Place(uint8_t Pos, uint8_t Num)
+{
+  Heap[Pos] = Num;
+  HeapPos[Num] = Pos;
+}
+
+/****************************************************************************
+ Function
+     SiftUp
+ Parameters
+     uint8_t Pos, the place in the heap of a timer that may be too low
+ Returns
+     nothing
+ Description
+     Swaps the timer up past any parents that are due after it
+ Notes
+
+ Author
+     Sander Tonkens, 10/19/26, 23:45
+****************************************************************************/
+static void SiftUp(uint8_t Pos)
+{
+  uint8_t Num = Heap[Pos];
+  uint8_t Parent;
+
+  while (Pos > 0)
+  {
+    Parent = (Pos - 1) / 2;
+    if (!IsEarlier(Num, Heap[Parent]))
+    {
+      break;
+    }
+    Place(Pos, Heap[Parent]);
+    Pos = Parent;
+  }
+  Place(Pos, Num);
+}
+
+/****************************************************************************
+ Function
+     SiftDown
+ Parameters
+     uint8_t Pos, the place in the heap of a timer that may be too high
+ Returns
+     nothing
+ Description
+     Swaps the timer down past any children that are due before it
+ Notes
+
+ Author
+     Sander Tonkens, 10/19/26, 23:45
+****************************************************************************/
+static void SiftDown(uint8_t Pos)
+{
+  uint8_t Num = Heap[Pos];
+  uint8_t Child;
+
+  while ((Child = (2 * Pos) + 1) < NumArmed)
+  {
+    if (((Child + 1) < NumArmed) && IsEarlier(Heap[Child + 1], Heap[Child]))
+    {
+      Child++;
+    }
+    if (!IsEarlier(Heap[Child], Num))
+    {
+      break;
+    }
+    Place(Pos, Heap[Child]);
+    Pos = Child;
+  }
+  Place(Pos, Num);
+}
+
+/****************************************************************************
+ Function
+     HeapRemove
+ Parameters
+     uint8_t Pos, the place in the heap of the timer to take out
+ Returns
+     nothing
+ Description
+     Takes a timer out of the heap, the last timer fills its place and is
+     sifted whichever way it needs to go
+ Notes
+
+ Author
+     Sander Tonkens, 10/19/26, 23:45
+****************************************************************************/
+static void HeapRemove(uint8_t Pos)
+{
+  uint8_t Removed = Heap[Pos];
+  uint8_t Moved;
+
+  NumArmed--;
+  if (Pos < NumArmed)
+  {
+    Moved = Heap[NumArmed];
+    Place(Pos, Moved);
+    SiftUp(Pos);
+    SiftDown(HeapPos[Moved]);
+  }
+  HeapPos[Removed] = NOT_ARMED;
+}
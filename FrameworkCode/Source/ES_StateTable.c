@@ -0,0 +1,319 @@
+//#define TEST
+/****************************************************************************
+ Module
+     ES_StateTable.c
+
+ Description
+     Dispatch for the table driven flat state machines built with
+     ES_STATE_TABLE, see ES_StateTable.h
+ Notes
+     Finding the transitions for an event is one index into the cell array,
+     whatever the number of states or events, so only the guards of the
+     rows for that (state, event) pair are ever evaluated
+
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/20/26 15:00 ston     added the TEST benchmark against a nested switch
+ 10/19/26 23:59 ston     note the state for the flight recorder
+ 10/19/26 20:00 ston     Began Coding
+****************************************************************************/
+
+/*----------------------------- Include Files -----------------------------*/
+#include "ES_Configure.h"
+#include "ES_Framework.h"
+#include "ES_StateTable.h"
+
+/*------------------------------ Module Code ------------------------------*/
+/****************************************************************************
+ Function
+     ES_StateTableDispatch
+ Parameters
+     const ES_StateTable_t *pTable, the transitions of the state machine
+     uint8_t *pState, the machine's current state, updated on a transition
+     ES_Event_t ThisEvent, the event to process
+ Returns
+     bool, true if a transition was taken, false if the event was ignored
+ Description
+     Looks up the first row for the current state & event, then walks it and
+     the ELSE rows after it until a guard passes. That row's action is run
+     with the event and its next state becomes the current state
+ Notes
+     The state is changed after the action runs, so an action can still
+     tell which state it was called from. Events and states outside the
+     table are ignored. The state it leaves the machine in goes in the
+     flight recorder
+ Author
+     Sander Tonkens, 10/19/26, 20:00
+****************************************************************************/
+bool ES_StateTableDispatch(const ES_StateTable_t *pTable, uint8_t *pState,
+    ES_Event_t ThisEvent)
+{
+  const ES_StateRow_t *pRow;
+  uint8_t Cell;
+  uint8_t WhichRow;
+
+  ES_FlightRecordState(*pState);  // in case no transition is taken
+  if ((*pState >= pTable->NumStates) || (ThisEvent.EventType >= NUM_ES_EVENTS))
+  {
+    return false;
+  }
+  Cell = pTable->pCells[(*pState * NUM_ES_EVENTS) + ThisEvent.EventType];
+  if (Cell == 0)
+  {
+    return false;
+  }
+  for (WhichRow = Cell - 1; WhichRow < pTable->NumRows; WhichRow++)
+  {
+    pRow = &pTable->pRows[WhichRow];
+    if ((WhichRow != Cell - 1) && !pRow->IsElse)
+    {
+      break;    // past the last ELSE for this pair
+    }
+    if ((pRow->pGuard == NULL) || pRow->pGuard(ThisEvent))
+    {
+      if (pRow->pAction != NULL)
+      {
+        pRow->pAction(ThisEvent);
+      }
+      *pState = pRow->NextState;
+      ES_FlightRecordState(*pState);
+      return true;
+    }
+  }
+  return false;
+}
+
+#ifdef TEST
+/* times a small game machine, written once as a transition table and once
+   as the nested switch the services used before, over a script of events
+   that visits every state, with guarded, ELSE and ignored events, and
+   prints the CPU cycles per event for each. Each time is the best of
+   TRIALS batches of REPEATS passes of the script, printed to a tenth of a
+   cycle, so it also works with the uS resolution of the host build's cycle
+   stamps (build with ES_HostPort.c in place of ES_Port.c) */
+#include <stdio.h>
+#include "ES_General.h"
+#ifndef ES_HOST_BUILD
+#include "driverlib/sysctl.h"
+#include "termio.h"
+#endif
+
+#define REPEATS 1000
+#define TRIALS 5
+
+typedef enum
+{
+  Standby, Running, Paused, Over, NUM_TEST_STATES
+}TestState_t;
+
+static volatile uint32_t ActionCount;
+
+static bool IsSun(ES_Event_t ThisEvent)
+{
+  return (ThisEvent.EventParam & 0x01) != 0;
+}
+
+static bool IsCoal(ES_Event_t ThisEvent)
+{
+  return (ThisEvent.EventParam & 0x02) != 0;
+}
+
+static bool IsEnd(ES_Event_t ThisEvent)
+{
+  return ThisEvent.EventParam != 0;
+}
+
+static void Act(ES_Event_t ThisEvent)
+{
+  ActionCount++;
+}
+
+#define TEST_ROWS(ROW, ELSE) \
+  ROW (Start,    Standby, START_GAME,         NULL,   Act,  Running) \
+  ROW (SunTick,  Running, ES_TIMEOUT,         IsSun,  Act,  Running) \
+  ELSE(CoalTick, Running, ES_TIMEOUT,         IsCoal, Act,  Running) \
+  ELSE(Idle,     Running, ES_TIMEOUT,         NULL,   NULL, Running) \
+  ROW (Temp,     Running, CHANGE_TEMP,        NULL,   Act,  Running) \
+  ROW (Pause,    Running, VOTED_NO,           NULL,   Act,  Paused)  \
+  ROW (Resume,   Paused,  VOTED_YES,          NULL,   Act,  Running) \
+  ROW (End,      Running, ES_SOLARPOS_CHANGE, IsEnd,  Act,  Over)    \
+  ROW (Reset,    Over,    RESET_ALL_GAMES,    NULL,   Act,  Standby)
+ES_STATE_TABLE(TestTable, TEST_ROWS, NUM_TEST_STATES);
+
+// the same machine the way the services were written before
+static bool SwitchDispatch(uint8_t *pState, ES_Event_t ThisEvent)
+{
+  switch (*pState)
+  {
+    case Standby:
+    {
+      if (ThisEvent.EventType == START_GAME)
+      {
+        Act(ThisEvent);
+        *pState = Running;
+        return true;
+      }
+    }
+    break;
+
+    case Running:
+    {
+      switch (ThisEvent.EventType)
+      {
+        case ES_TIMEOUT:
+        {
+          if (IsSun(ThisEvent) || IsCoal(ThisEvent))
+          {
+            Act(ThisEvent);
+          }
+          return true;
+        }
+
+        case CHANGE_TEMP:
+        {
+          Act(ThisEvent);
+          return true;
+        }
+
+        case VOTED_NO:
+        {
+          Act(ThisEvent);
+          *pState = Paused;
+          return true;
+        }
+
+        case ES_SOLARPOS_CHANGE:
+        {
+          if (IsEnd(ThisEvent))
+          {
+            Act(ThisEvent);
+            *pState = Over;
+            return true;
+          }
+        }
+        break;
+
+        default:
+          ;
+      }
+    }
+    break;
+
+    case Paused:
+    {
+      if (ThisEvent.EventType == VOTED_YES)
+      {
+        Act(ThisEvent);
+        *pState = Running;
+        return true;
+      }
+    }
+    break;
+
+    case Over:
+    {
+      if (ThisEvent.EventType == RESET_ALL_GAMES)
+      {
+        Act(ThisEvent);
+        *pState = Standby;
+        return true;
+      }
+    }
+    break;
+  }
+  return false;
+}
+
+static const ES_Event_t Script[] = {
+  { START_GAME, 0 }, { ES_TIMEOUT, 1 }, { ES_TIMEOUT, 2 }, { ES_TIMEOUT, 0 },
+  { CHANGE_TEMP, 0 }, { LEAF_REMOVED, 0 }, { VOTED_NO, 0 },
+  { LEAF_REMOVED, 0 }, { VOTED_YES, 0 }, { ES_SOLARPOS_CHANGE, 0 },
+  { ES_SOLARPOS_CHANGE, 1 }, { RESET_ALL_GAMES, 0 }
+};
+
+// runs the script once, returns the transitions taken, each as one bit
+static uint16_t RunScript(bool UseTable)
+{
+  uint8_t   State = Standby;
+  uint16_t  Taken = 0;
+  uint8_t   i;
+
+  for (i = 0; i < ARRAY_SIZE(Script); i++)
+  {
+    Taken <<= 1;
+    if (UseTable ? ES_StateTableDispatch(&TestTable, &State, Script[i]) :
+        SwitchDispatch(&State, Script[i]))
+    {
+      Taken |= 1;
+    }
+  }
+  return (State == Standby) ? Taken : 0;
+}
+
+static uint32_t BestBatch(bool UseTable)
+{
+  uint32_t  Start;
+  uint32_t  Cycles;
+  uint32_t  Best = UINT32_MAX;
+  uint16_t  i;
+  uint8_t   Trial;
+
+  for (Trial = 0; Trial < TRIALS; Trial++)
+  {
+    Start = _HW_GetCycleStamp();
+    for (i = 0; i < REPEATS; i++)
+    {
+      RunScript(UseTable);
+    }
+    Cycles = _HW_GetCycleStamp() - Start;
+    if (Cycles < Best)
+    {
+      Best = Cycles;
+    }
+  }
+  return Best;
+}
+
+int main(void)
+{
+  uint32_t  TableCycles;
+  uint32_t  SwitchCycles;
+  uint32_t  TableActions;
+  uint16_t  TableTaken;
+  uint16_t  SwitchTaken;
+
+#ifndef ES_HOST_BUILD
+  SysCtlClockSet(SYSCTL_SYSDIV_5 | SYSCTL_USE_PLL | SYSCTL_OSC_MAIN
+      | SYSCTL_XTAL_16MHZ);
+  TERMIO_Init();
+#endif
+  _HW_Timer_Init(ES_Timer_RATE_1mS);
+
+  // both must take the same transitions & run the same actions
+  ActionCount = 0;
+  TableTaken = RunScript(true);
+  TableActions = ActionCount;
+  ActionCount = 0;
+  SwitchTaken = RunScript(false);
+  printf("taken %04x / %04x, actions %lu / %lu, %s\r\n", TableTaken,
+      SwitchTaken, (unsigned long)TableActions, (unsigned long)ActionCount,
+      ((TableTaken == SwitchTaken) && (TableActions == ActionCount)) ?
+      "PASS" : "FAIL");
+
+  TableCycles = (BestBatch(true) * 10) / (REPEATS * ARRAY_SIZE(Script));
+  SwitchCycles = (BestBatch(false) * 10) / (REPEATS * ARRAY_SIZE(Script));
+  printf("Table %lu.%lu  Switch %lu.%lu (cycles per event)\r\n",
+      (unsigned long)(TableCycles / 10), (unsigned long)(TableCycles % 10),
+      (unsigned long)(SwitchCycles / 10), (unsigned long)(SwitchCycles % 10));
+
+#ifndef ES_HOST_BUILD
+  while (1)
+  {
+    ;
+  }
+#endif
+  return 0;
+}
+
+#endif
@@ -1,9 +1,10 @@
+//#define TEST
 /****************************************************************************
  Module
      ES_Timers.c
 
  Description
-     This is a module implementing  8 16 bit timers all using the RTI
+     This is a module implementing  16 32 bit timers all using the RTI
      timebase
 
  Notes
@@ -13,6 +14,20 @@
  History
  When           Who     What/Why
  -------------- ---     --------
+ 10/21/26 14:00 ston     TEST harness for the cost of a timeout
+ 10/21/26 09:00 ston     the flags & counts are only changed in a critical
+                         region, the services that set timers can run on
+                         other threads or from PendSV while the tick runs
+ 10/20/26 11:00 ston     the timer calls fail, rather than crash, with no
+                         current instance
+ 10/19/26 23:30 ston     timers are 32 bits, added the 64 bit uS clock
+ 10/19/26 23:00 ston     periodic timers, reloaded from their deadline in the
+                         tick, with an overrun count per timer
+ 10/19/26 22:00 ston     timeouts go straight into the service's queue, with
+                         one Ready update per tick, instead of through its
+                         post function
+ 10/19/26 17:00 ston     timer counts & active flags live in the current
+                         framework instance with ES_MULTI_INSTANCE
  10/27/14 14:02 jec      moved ticking of 'time' to ES_Port to allow it to tick
                          even while blocking. required change to ES_GetTime too
  10/20/13 10:48 jec      moved definition of BITS_PER_BYTE to ES_General.h
@@ -64,11 +79,38 @@
 
 typedef uint16_t Tflag_t;
 
-typedef uint16_t Timer_t; // sets size of timers to 16 bits
+typedef uint32_t Timer_t; // sets size of timers to 32 bits
 
 /*---------------------------- Module Functions ---------------------------*/
 
 /*---------------------------- Module Variables ---------------------------*/
+#ifdef ES_MULTI_INSTANCE
+// each instance has its own timers, only the post functions are shared
+typedef struct
+{
+  Timer_t TimerArray[sizeof(Tflag_t) * BITS_PER_BYTE];
+  Timer_t Periods[sizeof(Tflag_t) * BITS_PER_BYTE];
+  uint16_t Overruns[sizeof(Tflag_t) * BITS_PER_BYTE];
+  Tflag_t ActiveFlags;
+  Tflag_t PeriodicFlags;
+  Tflag_t PendingFlags;
+}TimerData_t;
+
+#define TimerData (*(TimerData_t *)ES_GetInstanceData(ES_TIMER_DATA_SLOT, \
+                                                      sizeof(TimerData_t)))
+#define TMR_TimerArray (TimerData.TimerArray)
+#define TMR_Periods (TimerData.Periods)
+#define TMR_Overruns (TimerData.Overruns)
+#define TMR_ActiveFlags (TimerData.ActiveFlags)
+#define TMR_PeriodicFlags (TimerData.PeriodicFlags)
+#define TMR_PendingFlags (TimerData.PendingFlags)
+// with no current instance (or no memory for its timers) there are no
+// timers, so every call fails rather than following a NULL pointer
+#define NO_TIMERS() (ES_GetInstanceData(ES_TIMER_DATA_SLOT, \
+                                        sizeof(TimerData_t)) == NULL)
+#else
+#define NO_TIMERS() false
+
 static Timer_t TMR_TimerArray[sizeof(Tflag_t) * BITS_PER_BYTE] =
 {
   0x0,
@@ -91,26 +133,38 @@ static Timer_t TMR_TimerArray[sizeof(Tflag_t) * BITS_PER_BYTE] =
 
 static Tflag_t TMR_ActiveFlags;
 
-static pPostFunc const Timer2PostFunc[sizeof(Tflag_t) * BITS_PER_BYTE] =
+// periodic timers: the reload value, how many timeouts were dropped because
+// the last one had not been taken yet, and which timers have one queued
+static Timer_t TMR_Periods[sizeof(Tflag_t) * BITS_PER_BYTE];
+static uint16_t TMR_Overruns[sizeof(Tflag_t) * BITS_PER_BYTE];
+static Tflag_t TMR_PeriodicFlags;
+static Tflag_t TMR_PendingFlags;
+#endif
+
+static uint8_t const Timer2Service[sizeof(Tflag_t) * BITS_PER_BYTE] =
 {
-  TIMER0_RESP_FUNC,
-  TIMER1_RESP_FUNC,
-  TIMER2_RESP_FUNC,
-  TIMER3_RESP_FUNC,
-  TIMER4_RESP_FUNC,
-  TIMER5_RESP_FUNC,
-  TIMER6_RESP_FUNC,
-  TIMER7_RESP_FUNC,
-  TIMER8_RESP_FUNC,
-  TIMER9_RESP_FUNC,
-  TIMER10_RESP_FUNC,
-  TIMER11_RESP_FUNC,
-  TIMER12_RESP_FUNC,
-  TIMER13_RESP_FUNC,
-  TIMER14_RESP_FUNC,
-  TIMER15_RESP_FUNC
+  TIMER0_SERVICE,
+  TIMER1_SERVICE,
+  TIMER2_SERVICE,
+  TIMER3_SERVICE,
+  TIMER4_SERVICE,
+  TIMER5_SERVICE,
+  TIMER6_SERVICE,
+  TIMER7_SERVICE,
+  TIMER8_SERVICE,
+  TIMER9_SERVICE,
+  TIMER10_SERVICE,
+  TIMER11_SERVICE,
+  TIMER12_SERVICE,
+  TIMER13_SERVICE,
+  TIMER14_SERVICE,
+  TIMER15_SERVICE
 };
 
+#ifdef ES_LATENCY_STATS
+static uint32_t WorstTickUS;
+#endif
+
 /*------------------------------ Module Code ------------------------------*/
 /****************************************************************************
  Function
@@ -144,23 +198,27 @@ void ES_Timer_Init(TimerRate_t Rate)
      ES_Timer_ERR if requested timer does not exist or has no service
      ES_Timer_OK  otherwise
  Description
-     sets the time for a timer, but does not make it active.
+     sets the time for a timer, but does not make it active. The timer
+     becomes a one shot timer.
  Notes
      None.
  Author
      J. Edward Carryer, 02/24/97 17:11
 ****************************************************************************/
-ES_TimerReturn_t ES_Timer_SetTimer(uint8_t Num, uint16_t NewTime)
+ES_TimerReturn_t ES_Timer_SetTimer(uint8_t Num, uint32_t NewTime)
 {
   /* tried to set a timer that doesn't exist */
-  if ((Num >= ARRAY_SIZE(TMR_TimerArray)) ||
+  if (NO_TIMERS() || (Num >= ARRAY_SIZE(TMR_TimerArray)) ||
       /* tried to set a timer without a service */
-      (Timer2PostFunc[Num] == TIMER_UNUSED) ||
+      (Timer2Service[Num] >= NUM_SERVICES) ||
       (NewTime == 0))   /* no time being set */
   {
     return ES_Timer_ERR;
   }
+  EnterCritical();
   TMR_TimerArray[Num] = NewTime;
+  TMR_PeriodicFlags &= BitNum2ClrMask[Num];   /* and one shot */
+  ExitCritical();
   return ES_Timer_OK;
 }
 
@@ -181,15 +239,24 @@ ES_TimerReturn_t ES_Timer_SetTimer(uint8_t Num, uint16_t NewTime)
 ****************************************************************************/
 ES_TimerReturn_t ES_Timer_StartTimer(uint8_t Num)
 {
+  ES_TimerReturn_t ReturnVal = ES_Timer_OK;
+
   /* tried to set a timer that doesn't exist */
-  if ((Num >= ARRAY_SIZE(TMR_TimerArray)) ||
-      /* tried to set a timer with no time on it */
-      (TMR_TimerArray[Num] == 0))
+  if (NO_TIMERS() || (Num >= ARRAY_SIZE(TMR_TimerArray)))
   {
     return ES_Timer_ERR;
   }
-  TMR_ActiveFlags |= BitNum2SetMask[Num];  /* set timer as active */
-  return ES_Timer_OK;
+  EnterCritical();
+  if (TMR_TimerArray[Num] == 0)
+  {
+    ReturnVal = ES_Timer_ERR;     /* tried to set a timer with no time on it */
+  }
+  else
+  {
+    TMR_ActiveFlags |= BitNum2SetMask[Num];  /* set timer as active */
+  }
+  ExitCritical();
+  return ReturnVal;
 }
 
 /****************************************************************************
@@ -209,11 +276,13 @@ ES_TimerReturn_t ES_Timer_StartTimer(uint8_t Num)
 ****************************************************************************/
 ES_TimerReturn_t ES_Timer_StopTimer(uint8_t Num)
 {
-  if (Num >= ARRAY_SIZE(TMR_TimerArray))
+  if (NO_TIMERS() || (Num >= ARRAY_SIZE(TMR_TimerArray)))
   {
     return ES_Timer_ERR;    /* tried to set a timer that doesn't exist */
   }
+  EnterCritical();
   TMR_ActiveFlags &= BitNum2ClrMask[Num];  /* set timer as inactive */
+  ExitCritical();
   return ES_Timer_OK;
 }
 
@@ -229,26 +298,121 @@ ES_TimerReturn_t ES_Timer_StopTimer(uint8_t Num)
      sets the NewTime into the chosen timer and sets the timer active to
      begin counting.
  Notes
-     None.
+     The timer becomes a one shot timer, even if it was periodic.
+     The tick changes the same flags, so they are set with it held off.
  Author
      J. Edward Carryer, 02/24/97 14:51
 ****************************************************************************/
-ES_TimerReturn_t ES_Timer_InitTimer(uint8_t Num, uint16_t NewTime)
+ES_TimerReturn_t ES_Timer_InitTimer(uint8_t Num, uint32_t NewTime)
 {
   /* tried to set a timer that doesn't exist */
-  if ((Num >= ARRAY_SIZE(TMR_TimerArray)) ||
+  if (NO_TIMERS() || (Num >= ARRAY_SIZE(TMR_TimerArray)) ||
       /* tried to set a timer without a service */
-      (Timer2PostFunc[Num] == TIMER_UNUSED) ||
+      (Timer2Service[Num] >= NUM_SERVICES) ||
       /* tried to set a timer without putting any time on it */
       (NewTime == 0))
   {
     return ES_Timer_ERR;
   }
+  EnterCritical();
   TMR_TimerArray[Num] = NewTime;
+  TMR_PeriodicFlags   &= BitNum2ClrMask[Num]; /* one shot */
   TMR_ActiveFlags     |= BitNum2SetMask[Num]; /* set timer as active */
+  ExitCritical();
   return ES_Timer_OK;
 }
 
+/****************************************************************************
+ Function
+     ES_Timer_InitPeriodic
+ Parameters
+     uint8_t Num, the number of the timer to start
+     uint32_t Period, the number of ticks between timeouts
+ Returns
+     ES_Timer_ERR if the requested timer does not exist, ES_Timer_OK otherwise.
+ Description
+     starts the timer counting Period ticks, after which it posts an
+     ES_TIMEOUT and reloads itself with Period, so the service does not
+     have to restart it from its timeout handling.
+ Notes
+     The reload happens in the tick in which the timer expired, so the
+     timeouts stay on the original schedule however long the service takes
+     to get to them. If a timeout is still in the service's queue when the
+     next one is due, that one is dropped and counted as an overrun, see
+     ES_Timer_GetOverruns. ES_Timer_StopTimer stops it, ES_Timer_StartTimer
+     carries on where it stopped.
+ Author
+     Sander Tonkens, 10/19/26, 23:00
+****************************************************************************/
+ES_TimerReturn_t ES_Timer_InitPeriodic(uint8_t Num, uint32_t Period)
+{
+  if (NO_TIMERS() || (Num >= ARRAY_SIZE(TMR_TimerArray)) ||
+      (Timer2Service[Num] >= NUM_SERVICES) ||
+      (Period == 0))
+  {
+    return ES_Timer_ERR;
+  }
+  EnterCritical();
+  TMR_ActiveFlags     &= BitNum2ClrMask[Num]; /* hold it while we set up */
+  TMR_TimerArray[Num] = Period;
+  TMR_Periods[Num]    = Period;
+  TMR_Overruns[Num]   = 0;
+  TMR_PendingFlags    &= BitNum2ClrMask[Num];
+  TMR_PeriodicFlags   |= BitNum2SetMask[Num];
+  TMR_ActiveFlags     |= BitNum2SetMask[Num]; /* set timer as active */
+  ExitCritical();
+  return ES_Timer_OK;
+}
+
+/****************************************************************************
+ Function
+     ES_Timer_GetOverruns
+ Parameters
+     uint8_t Num, the number of the timer
+ Returns
+     uint16_t, how many of a periodic timer's timeouts have been dropped
+     since ES_Timer_InitPeriodic because the service was behind
+ Description
+     lets a service see that it is not keeping up with its periodic timer
+ Notes
+     Stops counting at 65535.
+ Author
+     Sander Tonkens, 10/19/26, 23:00
+****************************************************************************/
+uint16_t ES_Timer_GetOverruns(uint8_t Num)
+{
+  if (NO_TIMERS() || (Num >= ARRAY_SIZE(TMR_TimerArray)))
+  {
+    return 0;
+  }
+  return TMR_Overruns[Num];
+}
+
+/****************************************************************************
+ Function
+     ES_Timer_TimeoutTaken
+ Parameters
+     uint8_t Num, the EventParam of an ES_TIMEOUT being dispatched
+ Returns
+     None.
+ Description
+     Called by the framework as it takes an ES_TIMEOUT from a queue, so the
+     timer's next periodic timeout can be posted
+ Notes
+     The tick changes the same flags, so this is done with it held off.
+ Author
+     Sander Tonkens, 10/19/26, 23:00
+****************************************************************************/
+void ES_Timer_TimeoutTaken(uint8_t Num)
+{
+  if (!NO_TIMERS() && (Num < ARRAY_SIZE(TMR_TimerArray)))
+  {
+    EnterCritical();
+    TMR_PendingFlags &= BitNum2ClrMask[Num];
+    ExitCritical();
+  }
+}
+
 /****************************************************************************
  Function
      ES_Timer_GetTime
@@ -270,6 +434,47 @@ uint16_t ES_Timer_GetTime(void)
   return _HW_GetTickCount();
 }
 
+/****************************************************************************
+ Function
+     ES_Timer_GetTimeUS
+ Parameters
+     None.
+ Returns
+     uint64_t, uS since the framework timers were started
+ Description
+     A monotonic clock that does not wrap, for time stamping events and
+     for timing over long runs, where ES_Timer_GetTime wraps every 65536
+     ticks.
+ Notes
+     None.
+ Author
+     Sander Tonkens, 10/19/26, 23:30
+****************************************************************************/
+uint64_t ES_Timer_GetTimeUS(void)
+{
+  return _HW_GetTimeUS();
+}
+
+/****************************************************************************
+ Function
+     ES_Timer_USToTicks
+ Parameters
+     uint32_t US, a time in uS
+ Returns
+     uint32_t, the number of ticks, rounded up, to put on a timer for US
+ Description
+     For timers whose time is given in uS rather than ticks, e.g.
+     ES_Timer_InitTimer(MY_TIMER, ES_Timer_USToTicks(2500)).
+ Notes
+     The timers still only expire on a tick.
+ Author
+     Sander Tonkens, 10/19/26, 23:30
+****************************************************************************/
+uint32_t ES_Timer_USToTicks(uint32_t US)
+{
+  return _HW_USToTicks(US);
+}
+
 /****************************************************************************
  Function
      ES_Timer_Tick_Resp
@@ -282,10 +487,16 @@ uint16_t ES_Timer_GetTime(void)
      It will increment time, to maintain the functionality of the
      GetTime() timer and it will check through the active timers,
      decrementing each active timers count, if the count goes to 0, it
-     will post an event to the corresponding SM and clear the active flag to
-     prevent further counting.
+     will put an event in the corresponding SM's queue and clear the active
+     flag to prevent further counting, or reload a periodic timer. The
+     Ready bits of the services that got a timeout are set together once
+     all of the timers are done.
  Notes
-     Called from _Timer_Int_Resp in ES_Port.c.
+     Called from _Timer_Int_Resp in ES_Port.c. On the target it is an
+     interrupt, so the timer functions only have to hold it off. In the host
+     build it runs on the main thread while the services run on the workers,
+     so the timers are counted with the lock held and the timeouts are
+     posted once it has been let go (the posts take the lock themselves).
  Author
      J. Edward Carryer, 02/24/97 15:06
 ****************************************************************************/
@@ -294,8 +505,24 @@ void ES_Timer_Tick_Resp(void)
   static Tflag_t  NeedsProcessing;
   static uint8_t  NextTimer2Process;
   static ES_Event_t NewEvent;
+  uint16_t TimedOut = 0;    // services that got a timeout this tick
+  uint8_t WhichService;
+  bool Deliver;
+  bool Delivered;
+#ifdef ES_HOST_BUILD
+  Tflag_t ToPost = 0;       // timers whose timeout is posted after the lock
+  ES_Event_t PostEvent;
+#endif
+#ifdef ES_LATENCY_STATS
+  uint32_t StartStamp = _HW_GetCycleStamp();
+  uint32_t TickUS;
+#endif
 
-  if (TMR_ActiveFlags != 0) /* if !=0 , then at least 1 timer is active */
+#ifdef ES_HOST_BUILD
+  EnterCritical();
+#endif
+  /* if !=0 , then at least 1 timer is active */
+  if (!NO_TIMERS() && (TMR_ActiveFlags != 0))
   {
     // start by getting a list of all the active timers
     NeedsProcessing = TMR_ActiveFlags;
@@ -308,17 +535,259 @@ void ES_Timer_Tick_Resp(void)
       {
         NewEvent.EventType  = ES_TIMEOUT;
         NewEvent.EventParam = NextTimer2Process;
-        /* post the timeout event to the right Service */
-        Timer2PostFunc[NextTimer2Process](NewEvent);
-        /* and stop counting */
-        TMR_ActiveFlags &= BitNum2ClrMask[NextTimer2Process];
+        Deliver = true;
+        if (TMR_PeriodicFlags & BitNum2SetMask[NextTimer2Process])
+        {
+          /* reload from this deadline, not from when the service gets to
+             the timeout, so the period does not drift */
+          TMR_TimerArray[NextTimer2Process] = TMR_Periods[NextTimer2Process];
+          if (TMR_PendingFlags & BitNum2SetMask[NextTimer2Process])
+          {
+            /* the last one has not been taken yet, drop this one */
+            if (TMR_Overruns[NextTimer2Process] < UINT16_MAX)
+            {
+              TMR_Overruns[NextTimer2Process]++;
+            }
+            Deliver = false;
+          }
+        }
+        else
+        {
+          /* stop counting */
+          TMR_ActiveFlags &= BitNum2ClrMask[NextTimer2Process];
+        }
+        if (Deliver)
+        {
+          /* marked before posting, as it can be taken straight away */
+          TMR_PendingFlags |= (TMR_PeriodicFlags &
+                               BitNum2SetMask[NextTimer2Process]);
+#ifdef ES_HOST_BUILD
+          ToPost |= BitNum2SetMask[NextTimer2Process];
+#else
+          WhichService = Timer2Service[NextTimer2Process];
+          /* queue the timeout event for the right Service */
+          Delivered = ES_EnQueueToService(WhichService, NewEvent);
+          if (Delivered)
+          {
+            TimedOut |= BitNum2SetMask[WhichService];
+          }
+          else
+          {
+            TMR_PendingFlags &= BitNum2ClrMask[NextTimer2Process];
+          }
+#endif
+        }
       }
       // mark off the active timer that we just processed
       NeedsProcessing &= BitNum2ClrMask[NextTimer2Process];
     } while (NeedsProcessing != 0);
   }
+#ifdef ES_HOST_BUILD
+  ExitCritical();
+  /* a worker thread could take the event before a later Ready update, so
+     post each one the usual way */
+  PostEvent.EventType = ES_TIMEOUT;
+  while (ToPost != 0)
+  {
+    PostEvent.EventParam = ES_GetMSBitSet(ToPost);
+    WhichService = Timer2Service[PostEvent.EventParam];
+    Delivered = ES_PostToService(WhichService, PostEvent);
+    if (!Delivered)
+    {
+      ES_Timer_TimeoutTaken(PostEvent.EventParam);
+    }
+    ToPost &= BitNum2ClrMask[PostEvent.EventParam];
+  }
+#endif
+  if (TimedOut != 0)
+  {
+    ES_MarkServicesReady(TimedOut);
+  }
+#ifdef ES_LATENCY_STATS
+  TickUS = _HW_USSince(StartStamp);
+  if (TickUS > WorstTickUS)
+  {
+    WorstTickUS = TickUS;
+  }
+#endif
 }
 
+#ifdef ES_LATENCY_STATS
+/****************************************************************************
+ Function
+     ES_Timer_GetWorstTickUS
+ Parameters
+     None.
+ Returns
+     uint32_t the longest ES_Timer_Tick_Resp has taken so far, in uS
+ Description
+     For measuring the cost of timer expiries, e.g. with every timer
+     started on the same period so they all expire in the same tick
+ Notes
+     None.
+ Author
+     Sander Tonkens, 10/19/26, 22:00
+****************************************************************************/
+uint32_t ES_Timer_GetWorstTickUS(void)
+{
+  return WorstTickUS;
+}
+#endif
+
+#ifdef TEST
+/* times a tick with 1 to all of the configured timers expiring in it and
+   with the same timers still counting, and prints the cycles for each and
+   the difference per expiry. Then it times the two ways of delivering the
+   timeouts: a post for each one, through a pointer to the post function,
+   as the tick used to, against ES_EnQueueToService for each and a single
+   ES_MarkServicesReady. The host build's tick posts each timeout itself, so
+   there only the second table tells the two apart. Each time is the sum
+   over REPEATS ticks, printed per tick to a tenth of a cycle, so it also
+   works with the uS resolution of the host build's cycle stamps (build
+   with ES_HostPort.c in place of ES_Port.c, and stub services) */
+#include <stdio.h>
+#ifndef ES_HOST_BUILD
+#include "driverlib/sysctl.h"
+#include "termio.h"
+#endif
+
+#define REPEATS 1000
+#define NOT_YET 1000    // ticks, for timers that count but don't expire
+
+static uint8_t UsedTimers[sizeof(Tflag_t) * BITS_PER_BYTE];
+static uint8_t NumUsed;
+static bool (*const pOldPost)(uint8_t, ES_Event_t) = ES_PostToService;
+
+static void PrintTenths(uint64_t Cycles, uint32_t Count)
+{
+  uint32_t Tenths = (uint32_t)((Cycles * 10) / Count);
+
+  printf(" %7lu.%lu", (unsigned long)(Tenths / 10),
+      (unsigned long)(Tenths % 10));
+}
+
+static uint64_t TimeTicks(uint8_t NumTimers, Timer_t Count)
+{
+  uint64_t  Cycles = 0;
+  uint32_t  Start;
+  uint16_t  i;
+  uint8_t   j;
+
+  for (i = 0; i < REPEATS; i++)
+  {
+    for (j = 0; j < NumTimers; j++)
+    {
+      ES_Timer_InitTimer(UsedTimers[j], Count);
+    }
+    Start = _HW_GetCycleStamp();
+    ES_Timer_Tick_Resp();
+    Cycles += _HW_GetCycleStamp() - Start;
+    for (j = 0; j < NumTimers; j++)
+    {
+      ES_Timer_StopTimer(UsedTimers[j]);
+    }
+    ES_RunStep();   // empty the queues for the next tick
+  }
+  return Cycles;
+}
+
+static uint64_t TimeDelivery(uint8_t NumTimeouts, bool OneReadyUpdate)
+{
+  ES_Event_t  NewEvent = { ES_TIMEOUT, 0 };
+  uint64_t    Cycles = 0;
+  uint32_t    Start;
+  uint16_t    TimedOut;
+  uint16_t    i;
+  uint8_t     j;
+
+  for (i = 0; i < REPEATS; i++)
+  {
+    TimedOut = 0;
+    Start = _HW_GetCycleStamp();
+    for (j = 0; j < NumTimeouts; j++)
+    {
+      NewEvent.EventParam = UsedTimers[j];
+      if (OneReadyUpdate)
+      {
+        if (ES_EnQueueToService(Timer2Service[UsedTimers[j]], NewEvent))
+        {
+          TimedOut |= BitNum2SetMask[Timer2Service[UsedTimers[j]]];
+        }
+      }
+      else
+      {
+        pOldPost(Timer2Service[UsedTimers[j]], NewEvent);
+      }
+    }
+    if (TimedOut != 0)
+    {
+      ES_MarkServicesReady(TimedOut);
+    }
+    Cycles += _HW_GetCycleStamp() - Start;
+    ES_RunStep();
+  }
+  return Cycles;
+}
+
+int main(void)
+{
+  uint64_t  Expiring;
+  uint64_t  Counting;
+  uint8_t   WhichTimer;
+  uint8_t   NumTimers;
+
+#ifndef ES_HOST_BUILD
+  SysCtlClockSet(SYSCTL_SYSDIV_5 | SYSCTL_USE_PLL | SYSCTL_OSC_MAIN
+      | SYSCTL_XTAL_16MHZ);
+  TERMIO_Init();
+#endif
+  if (ES_Initialize(ES_Timer_RATE_1mS) != Success)
+  {
+    puts("\rES_Initialize failed\r");
+    return 1;
+  }
+  ES_RunStep();   // the events the inits posted
+  for (WhichTimer = 0; WhichTimer < ARRAY_SIZE(Timer2Service); WhichTimer++)
+  {
+    if (Timer2Service[WhichTimer] != TIMER_UNUSED)
+    {
+      UsedTimers[NumUsed++] = WhichTimer;
+    }
+  }
+
+  puts("\rTimers  Expiring  Counting  Per expiry (cycles)\r");
+  for (NumTimers = 1; NumTimers <= NumUsed; NumTimers++)
+  {
+    Expiring = TimeTicks(NumTimers, 1);
+    Counting = TimeTicks(NumTimers, NOT_YET);
+    printf("%6u", NumTimers);
+    PrintTenths(Expiring, REPEATS);
+    PrintTenths(Counting, REPEATS);
+    PrintTenths((Expiring > Counting) ? Expiring - Counting : 0,
+        (uint32_t)REPEATS * NumTimers);
+    printf("\r\n");
+  }
+
+  puts("\rTimeouts  Post each  EnQueue & Mark (cycles per tick)\r");
+  for (NumTimers = 1; NumTimers <= NumUsed; NumTimers++)
+  {
+    printf("%8u  ", NumTimers);
+    PrintTenths(TimeDelivery(NumTimers, false), REPEATS);
+    PrintTenths(TimeDelivery(NumTimers, true), REPEATS);
+    printf("\r\n");
+  }
+
+#ifndef ES_HOST_BUILD
+  while (1)
+  {
+    ;
+  }
+#endif
+  return 0;
+}
+
+#endif
+
 /*------------------------------- Footnotes -------------------------------*/
 /*------------------------------ End of file ------------------------------*/
 
@@ -14,6 +14,25 @@
  History
  When           Who     What/Why
  -------------- ---     --------
+ 10/21/26 12:00 ston    the end stop readings are calibration values, set or
+                        measured at run time, see SetPanelEndStops
+ 10/20/26 13:00 ston    the expected panel reading is derived from the
+                        readings at the panel's end stops
+ 10/19/26 23:52 ston    solar panel moves come from the ADC1 comparators
+                        instead of the CheckSolarPanelPosition checker
+ 10/19/26 23:50 ston    tower plugged & unplugged come from SmokeTowerIR
+ 10/19/26 23:00 ston    sun, coal & solar timers are periodic instead of
+                        being restarted on every timeout
+ 10/19/26 20:00 ston    state machine rewritten as an ES_StateTable transition
+                        list, the coal & solar states share their timer rows
+ 10/19/26 17:00 ston    module variables moved into a per exhibit struct,
+                        see ES_SERVICE_DATA
+ 10/19/26 12:00 ston    smoke tower is debounced by the Debounce module,
+                        removed CheckSmokeTowerEvents
+ 10/19/26 11:00 ston    alignment is checked against the sun's actual
+                        position instead of a stepped V_sun estimate
+ 10/19/26 10:30 ston    solar panel change detection now runs on the filtered
+                        A/D value with a hysteresis band instead of raw samples
  10/23/18 11:11 ston    First pass
  
 ****************************************************************************/
@@ -39,6 +58,7 @@
 #include "ES_Framework.h"
 #include "ES_DeferRecall.h"
 #include "ES_ShortTimer.h"
+#include "ES_StateTable.h"
 
 
 /* include header files for the other modules that are referenced
@@ -51,38 +71,94 @@
 #define ONE_SEC 1000
 #define FIVE_SEC (ONE_SEC*5)
 #define TEN_SEC (ONE_SEC*10)
-#define V_INCREMENT_FIVE_SEC 0 //To be changed
+// the panel reading, in A/D counts, expected at both end stops until they
+// have been measured: the fixed sun reading the game has always used, so
+// an uncalibrated exhibit behaves as it did before the sun moved smoothly
+#define V_SUN_UNMEASURED 2000
 
-// flexibility defines
-#define GPIO_PORT_EP GPIO_PORTA_BASE //configure A on electrical design
-
-//readability defines
-#define TOWER GPIO_PIN_2
-#define TOWER_HI BIT2HI
-#define TOWER_LO BIT2LO
+// the smoke tower IR (PA2) is decoded by the SmokeTowerIR service
 
 //constants
 #define V_MEDIUMALIGNED 2000
 #define V_WELLALIGNED 1000
 
+// solar panel: result 0 of the A/D, AIN3, watched by the ADC1 comparators
+// for moves of V_threshold
+#define SOLAR_PANEL_CHANNEL 0
+#define SOLAR_PANEL_AIN 3
+
 
 #define COAL_AUDIO 1
 
 
 // Private functions
+static bool IsEnergyGame(ES_Event_t ThisEvent);
+static bool IsSunTimer(ES_Event_t ThisEvent);
+static bool IsCoalTimer(ES_Event_t ThisEvent);
+static bool IsSolarTimer(ES_Event_t ThisEvent);
+static void StartCoalPower(ES_Event_t ThisEvent);
+static void RestartCoalPower(ES_Event_t ThisEvent);
+static void StartSolarPower(ES_Event_t ThisEvent);
+static void MoveSun(ES_Event_t ThisEvent);
+static void MoveSunAndAlign(ES_Event_t ThisEvent);
+static void ShowAlignment(ES_Event_t ThisEvent);
+static void TempUp(ES_Event_t ThisEvent);
+static void TempDown(ES_Event_t ThisEvent);
+static void ResetGame(ES_Event_t ThisEvent);
+static void PanelLeftBand(bool WentHigh);
 static uint32_t ReadSolarPanelPosition(void);
-static bool ReadSmokeTowerIR(void);
-static void ChangeSunVoltage(void);
+static int32_t ExpectedSunVoltage(void);
 static uint8_t EvaluateSolarAlignment(void);
 
 // module level defines
 static uint8_t MyPriority;
-static EnergyGameState CurrentEnergyState;
-static uint16_t LastSolarPanelVoltage;
-static bool LastSmokeTowerState;
-static uint32_t V_sun = 2000;
 static uint32_t V_threshold = 200;
 
+// everything that belongs to one exhibit, see ES_SERVICE_DATA
+typedef struct
+{
+  uint8_t CurrentEnergyState;     // an EnergyGameState
+  // panel readings at its two end stops, which line up with the ends of
+  // the sun's arc, see SetPanelEndStops
+  uint16_t PanelAtSunrise;
+  uint16_t PanelAtSunset;
+} EnergyGameData_t;
+
+static EnergyGameData_t MyData;
+#define Me ES_SERVICE_DATA(EnergyGameData_t, MyPriority, MyData)
+
+// the energy game, see ES_StateTable.h for the format. The timer rows are
+// the same whichever way the grid is powered, only the sun move differs
+#define ENERGY_TRANSITIONS(ROW, ELSE) \
+  ROW (EP_Init,         InitEnergyGame, ES_INIT,            NULL, \
+       NULL,            EnergyStandBy) \
+  ROW (EP_Start,        EnergyStandBy,  START_GAME,         IsEnergyGame, \
+       StartCoalPower,  CoalPowered) \
+  ROW (EP_CoalSun,      CoalPowered,    ES_TIMEOUT,         IsSunTimer, \
+       MoveSun,         CoalPowered) \
+  ELSE(EP_CoalTempUp,   CoalPowered,    ES_TIMEOUT,         IsCoalTimer, \
+       TempUp,          CoalPowered) \
+  ELSE(EP_CoalTempDown, CoalPowered,    ES_TIMEOUT,         IsSolarTimer, \
+       TempDown,        CoalPowered) \
+  ROW (EP_Plugged,      CoalPowered,    ES_TOWER_PLUGGED,   NULL, \
+       StartSolarPower, SolarPowered) \
+  ROW (EP_CoalReset,    CoalPowered,    RESET_ALL_GAMES,    NULL, \
+       ResetGame,       EnergyStandBy) \
+  ROW (EP_Unplugged,    SolarPowered,   ES_TOWER_UNPLUGGED, NULL, \
+       RestartCoalPower, CoalPowered) \
+  ROW (EP_SolarSun,     SolarPowered,   ES_TIMEOUT,         IsSunTimer, \
+       MoveSunAndAlign, SolarPowered) \
+  ELSE(EP_SolarTempUp,  SolarPowered,   ES_TIMEOUT,         IsCoalTimer, \
+       TempUp,          SolarPowered) \
+  ELSE(EP_SolarTempDown, SolarPowered,  ES_TIMEOUT,         IsSolarTimer, \
+       TempDown,        SolarPowered) \
+  ROW (EP_PanelMoved,   SolarPowered,   ES_SOLARPOS_CHANGE, NULL, \
+       ShowAlignment,   SolarPowered) \
+  ROW (EP_SolarReset,   SolarPowered,   RESET_ALL_GAMES,    NULL, \
+       ResetGame,       EnergyStandBy)
+
+ES_STATE_TABLE(EnergyTable, ENERGY_TRANSITIONS, NUM_ENERGY_STATES);
+
 
 
 /****************************************************************************
@@ -109,17 +185,17 @@ bool InitEnergyProduction(uint8_t Priority)
   ES_Event_t ThisEvent;
 
   MyPriority = Priority;
-  //Define solar panel position TIVA input as an analog input 
-
-  //Define SmokeTowerIR TIVA input as a digital input
-  HWREG(GPIO_PORT_EP + GPIO_O_DEN) |= (TOWER_HI);
-  HWREG(GPIO_PORT_EP + GPIO_O_DIR) &= (TOWER_LO);
-
-  //Sample port line and use it to initialize the LastSolarPanelVoltage variable
-  LastSolarPanelVoltage = ReadSolarPanelPosition();
-  LastSmokeTowerState = ReadSmokeTowerIR();
+  //Watch the solar panel input in hardware, changes are reported once it
+  //moves V_threshold away from the last reported value
+  if (!ADC_WatchInit(SOLAR_PANEL_AIN, ADC_HW_AVG_64X, PanelLeftBand))
+  {
+    return false;
+  }
+  ADC_WatchSetBand(ReadSolarPanelPosition(), V_threshold);
   
-  CurrentEnergyState = InitEnergyGame;
+  Me->CurrentEnergyState = InitEnergyGame;
+  Me->PanelAtSunrise = V_SUN_UNMEASURED;
+  Me->PanelAtSunset = V_SUN_UNMEASURED;
 
   //Post Event ES_Init to EnergyProduction queue (this service)
   ThisEvent.EventType = ES_INIT;
@@ -127,6 +203,64 @@ bool InitEnergyProduction(uint8_t Priority)
   return true;
 }
 
+/****************************************************************************
+ Function
+     SetPanelEndStops
+ Parameters
+     uint16_t AtSunrise, the panel reading at its sunrise end stop
+     uint16_t AtSunset, the panel reading at its sunset end stop
+
+ Returns
+     Nothing
+
+ Description
+     Sets the calibration the expected panel reading is interpolated from,
+     for an exhibit whose end stop readings are already known
+ Notes
+     Until this or MeasurePanelEndStop is called both are V_SUN_UNMEASURED
+ Author
+     Sander Tonkens, 10/21/26, 12:00
+****************************************************************************/
+void SetPanelEndStops(uint16_t AtSunrise, uint16_t AtSunset)
+{
+  Me->PanelAtSunrise = AtSunrise;
+  Me->PanelAtSunset = AtSunset;
+}
+
+/****************************************************************************
+ Function
+     MeasurePanelEndStop
+ Parameters
+     bool AtSunset, true for the sunset end stop, false for sunrise
+
+ Returns
+     uint16_t the reading that was taken
+
+ Description
+     Takes the panel's current reading as the reading at one end stop, for
+     calibrating with the panel pushed against that stop
+ Notes
+     The reading is printed, so it can be put in a SetPanelEndStops call
+ Author
+     Sander Tonkens, 10/21/26, 12:00
+****************************************************************************/
+uint16_t MeasurePanelEndStop(bool AtSunset)
+{
+  uint16_t Reading = (uint16_t)ReadSolarPanelPosition();
+
+  if (AtSunset)
+  {
+    Me->PanelAtSunset = Reading;
+  }
+  else
+  {
+    Me->PanelAtSunrise = Reading;
+  }
+  printf("Panel at %s end stop: %u\r\n", AtSunset ? "sunset" : "sunrise",
+         Reading);
+  return Reading;
+}
+
 /****************************************************************************
  Function
      PostEnergyProduction
@@ -160,7 +294,8 @@ Parameters
    ES_Event_t, ES_NO_EVENT if no error ES_ERROR otherwise
 
  Description
-     implements the state machine for Morse Elements
+     implements the energy game state machine, the transitions are in
+     ENERGY_TRANSITIONS
  Notes
 
  Author
@@ -170,297 +305,314 @@ Parameters
 ES_Event_t RunEnergyProductionSM(ES_Event_t ThisEvent)
 {
   ES_Event_t ReturnEvent;
-  ES_Event_t TemperatureChange;
-
 
   //Default return event
   ReturnEvent.EventType = ES_NO_EVENT;
 
-  //For posting when sun should move
-  ES_Event_t MoveSunEvent;
-  //Corresponds to number of LEDs to be on
-  uint8_t energy_level;
-
-  //Based on the state of the CurrentEnergyState variable choose one of the 
-  //following blocks of code:
-  switch(CurrentEnergyState)
-    {
-    case InitEnergyGame:
-    {
-      puts("In InitEnergyGame \r\n");
-      if(ThisEvent.EventType == ES_INIT)
-      {
-        CurrentEnergyState = EnergyStandBy;
-      }
-    break;
-    }
-    
-    case EnergyStandBy:
-    {
-
-      if((ThisEvent.EventType == START_GAME) && (ThisEvent.EventParam == 1))
-      {
-        puts("Energy game started \r\n");
-        //post event to game service to 
-        //1. Play coalplant audio
-        //2. turn on pollution leds
-        SR_WritePollution(6);
-        //3. turn on energy leds with parameter all
-        SR_WriteEnergy(6);
-        //Initiate 5 s timer
-        ES_Timer_InitTimer(SUN_POSITION_TIMER, FIVE_SEC);
-        ES_Timer_InitTimer(COAL_ACTIVE_TIMER, FIVE_SEC);
-        CurrentEnergyState = CoalPowered;
-
-      }
-    break;
-    }
- 
-    case CoalPowered:
-    {
-      puts("The energy grid is coal powered \r\n");
-      if((ThisEvent.EventType == ES_TIMEOUT) && (ThisEvent.EventParam == SUN_POSITION_TIMER))
-      {
-        //Move sun to new position by calling that service
-        puts("Sun to be moved, tower unplugged \r\n");
-        MoveSunEvent.EventType = ES_MOVE_SUN;
-        MoveSunEvent.EventParam = 0;
-        PostSunMovement(MoveSunEvent);
-        //Change V_sun by one iteration
-        ChangeSunVoltage();
-        //Initiate 5 s timer
-        ES_Timer_InitTimer(SUN_POSITION_TIMER, FIVE_SEC);
-      }
-      else if((ThisEvent.EventType == ES_TIMEOUT) && (ThisEvent.EventParam == COAL_ACTIVE_TIMER))
-      {
-        //Turn 1 temperature LED on
-        TemperatureChange.EventType = CHANGE_TEMP;
-        TemperatureChange.EventParam = 2;
-        puts("Temp up by 1, too long in coal power state\r\n");
-        PostGameManager(TemperatureChange);
-        ES_Timer_InitTimer(COAL_ACTIVE_TIMER, FIVE_SEC);
-        //to add in: Play "sad" audio tune
-      }
-      else if((ThisEvent.EventType == ES_TIMEOUT) && (ThisEvent.EventParam == SOLAR_ACTIVE_TIMER))
-      {
-        //It could be that we changed to new state already whilst this event was still in the queue
-        //Turn 1 temperature LED off
-        TemperatureChange.EventType = CHANGE_TEMP;
-        TemperatureChange.EventParam = 1;
-        puts("Temp down by 1, enough solar energy produced\r\n");
-        PostGameManager(TemperatureChange);
-        ES_Timer_InitTimer(SOLAR_ACTIVE_TIMER, TEN_SEC);
-        //to add in: Play "happy" audio tune
-        //optional: Have it depend on number of leds that are on (either currently or in the past 10 seconds an average) --> How to??
-      }
-      else if(ThisEvent.EventType == ES_TOWER_PLUGGED)
-      {
-        puts("Tower plugged, move to SolarPowered state \r\n");
-        //post event to do the following:
-        //1. Stop coalplant audio
-        //2. Turn "low" polution leds
-        SR_WritePollution(2);
-        //3. Turn "low" energy leds
-        SR_WriteEnergy(2);
-        //Call EvaluateAlignment to check alignment solar panel
-        energy_level = EvaluateSolarAlignment();
-        SR_WriteEnergy(2*energy_level);
-        CurrentEnergyState = SolarPowered;
-        ES_Timer_InitTimer(SOLAR_ACTIVE_TIMER, TEN_SEC);
-      }
-      else if((ThisEvent.EventType == ES_AUDIO_END) && (ThisEvent.EventParam == COAL_AUDIO))
-      {
-        //1. Play coalplant audio
-      }
-      else if(ThisEvent.EventType == RESET_ALL_GAMES)
-      {
-      	//1. Stop playing coalplant audio directly
-      	//2. Function to reset sun to original position
-      	MoveSunEvent.EventType = ES_MOVE_SUN;
-      	MoveSunEvent.EventParam = 1;
-      	PostSunMovement(MoveSunEvent);
-      	CurrentEnergyState = EnergyStandBy;
-      }
-    break;
-    }
-
-    case SolarPowered:
-    {
-      puts("The energy grid is solar powered \r\n");
-      if(ThisEvent.EventType == ES_TOWER_UNPLUGGED)
-      {
-        puts("Tower unplugged, move to CoalPowered state \r\n");
-        //1. Play coalplant audio
-        //2. Turn on pollution leds
-        SR_WritePollution(6);
-        //3. turn on energy leds with parameter all
-        SR_WriteEnergy(6);
-        CurrentEnergyState = CoalPowered;
-        ES_Timer_InitTimer(COAL_ACTIVE_TIMER, FIVE_SEC);
-      }
-      else if((ThisEvent.EventType == ES_TIMEOUT) && (ThisEvent.EventParam == COAL_ACTIVE_TIMER))
-      {
-        //It could be that we changed to new state already whilst this event was still in the queue
-        //Turn 1 temperature LED on
-        TemperatureChange.EventType = CHANGE_TEMP;
-        TemperatureChange.EventParam = 2;
-        puts("Temp up by 1, too long in coal power state\r\n");
-        PostGameManager(TemperatureChange);
-        ES_Timer_InitTimer(COAL_ACTIVE_TIMER, FIVE_SEC);
-        //to add in: Play "sad" audio tune
-      }
-      else if((ThisEvent.EventType == ES_TIMEOUT) && (ThisEvent.EventParam == SOLAR_ACTIVE_TIMER))
-      {
-        //Turn 1 temperature LED off
-        TemperatureChange.EventType = CHANGE_TEMP;
-        TemperatureChange.EventParam = 1;
-        puts("Temp down by 1, enough solar energy produced\r\n");
-        PostGameManager(TemperatureChange);
-        ES_Timer_InitTimer(SOLAR_ACTIVE_TIMER, TEN_SEC);
-        //to add in: Play "happy" audio tune
-        //optional: Have it depend on number of leds that are on (either currently or in the past 10 seconds an average) --> How to??
-      }
-      else if((ThisEvent.EventType == ES_TIMEOUT) && (ThisEvent.EventParam == SUN_POSITION_TIMER))
-      {
-        //Initiate 5 s timer
-        puts("Sun to be moved, tower plugged \r\n");
-        ES_Timer_InitTimer(SUN_POSITION_TIMER, FIVE_SEC);
-        //Move sun to new position by calling that service
-        MoveSunEvent.EventType = ES_MOVE_SUN;
-        MoveSunEvent.EventParam = 0;
-        PostSunMovement(MoveSunEvent);
-        //Change V_sun by one iteration
-        ChangeSunVoltage();
-        //Call EvaluateAlignment to check alignment solar panel
-        energy_level = EvaluateSolarAlignment();
-        //Write new value of EvaluateSolarAlignment to LEDs
-        //6 LEDs to represent 3 different levels, so *2
-        SR_WriteEnergy(2*energy_level);
-        
-      }
-      else if(ThisEvent.EventType == ES_SOLARPOS_CHANGE)
-      {
-        puts("Solar panel moved, in tower plugged state \r\n");
-        //Call EvaluateAlignment to check alignment solar panel
-        energy_level = EvaluateSolarAlignment();
-        SR_WriteEnergy(2*energy_level);
-      }
-      else if(ThisEvent.EventType == RESET_ALL_GAMES)
-      {
-        //Move sun to initial position by calling that service
-        MoveSunEvent.EventType = ES_MOVE_SUN;
-        MoveSunEvent.EventParam = 0;
-        PostSunMovement(MoveSunEvent);
-        CurrentEnergyState = EnergyStandBy;
-
-      }
-    break;
-    }	
+  //Moving the panel re-centres its band on where it is now
+  if(ThisEvent.EventType == ES_SOLARPOS_CHANGE)
+  {
+    puts("Solarpanel position changed by threshold \r\n");
+    ADC_WatchSetBand(ReadSolarPanelPosition(), V_threshold);
   }
+
+  //Plugging or unplugging the tower, or moving the panel, counts as user
+  //activity in any state
+  if((ThisEvent.EventType == ES_TOWER_PLUGGED) ||
+     (ThisEvent.EventType == ES_TOWER_UNPLUGGED) ||
+     (ThisEvent.EventType == ES_SOLARPOS_CHANGE))
+  {
+    ES_Event_t AnyEvent;
+    AnyEvent.EventType = USERMVT_DETECTED;
+    PostGameManager(AnyEvent);
+  }
+
+  ES_StateTableDispatch(&EnergyTable, &Me->CurrentEnergyState, ThisEvent);
   return ReturnEvent;
 }
 
+//***************************************************************************
+
+//********************************
+// These functions are private to the module
+//********************************
+
 /****************************************************************************
-EVENT CHECKING ROUTINES
+ Function
+     IsEnergyGame, IsSunTimer, IsCoalTimer, IsSolarTimer
+
+ Parameters
+    ES_Event_t ThisEvent, the event being dispatched
+
+ Returns
+    bool, true if the event is for this guard's game or timer
+
+ Description
+    Transition guards on EventParam for ENERGY_TRANSITIONS
+ Notes
+
+ Author
+    Sander Tonkens, 10/19/26, 20:00
 ****************************************************************************/
+static bool IsEnergyGame(ES_Event_t ThisEvent)
+{
+  return ThisEvent.EventParam == 1;
+}
+
+static bool IsSunTimer(ES_Event_t ThisEvent)
+{
+  return ThisEvent.EventParam == SUN_POSITION_TIMER;
+}
+
+static bool IsCoalTimer(ES_Event_t ThisEvent)
+{
+  return ThisEvent.EventParam == COAL_ACTIVE_TIMER;
+}
+
+static bool IsSolarTimer(ES_Event_t ThisEvent)
+{
+  return ThisEvent.EventParam == SOLAR_ACTIVE_TIMER;
+}
 
 /****************************************************************************
  Function
-     CheckSolarPanelPosition
+     StartCoalPower
+
  Parameters
-     None
+    ES_Event_t ThisEvent, unused
 
  Returns
-     bool, true if an event is posted
+    Nothing
 
  Description
-     Checks if pin state has changed and posts event if change detected
+    Game start: the grid begins coal powered and the sun starts moving
  Notes
 
  Author
-     Sander Tonkens, 11/1/18, 10:20
+    Sander Tonkens, 10/19/26, 20:00
 ****************************************************************************/
+static void StartCoalPower(ES_Event_t ThisEvent)
+{
+  puts("Energy game started \r\n");
+  //1. Play coalplant audio
+  //2. turn on pollution leds
+  SR_WritePollution(6);
+  //3. turn on energy leds with parameter all
+  SR_WriteEnergy(6);
+  //Move the sun & raise the temperature every 5 s
+  ES_Timer_InitPeriodic(SUN_POSITION_TIMER, FIVE_SEC);
+  ES_Timer_InitPeriodic(COAL_ACTIVE_TIMER, FIVE_SEC);
+}
+
+/****************************************************************************
+ Function
+     RestartCoalPower
+
+ Parameters
+    ES_Event_t ThisEvent, unused
+
+ Returns
+    Nothing
+
+ Description
+    Tower unplugged: back to coal power, the sun timer is still running
+ Notes
 
-bool CheckSolarPanelPosition(void)
+ Author
+    Sander Tonkens, 10/19/26, 20:00
+****************************************************************************/
+static void RestartCoalPower(ES_Event_t ThisEvent)
 {
-  ES_Event_t ThisEvent;
-  ES_Event_t AnyEvent;
-  bool ReturnVal = false;
-  static uint32_t CurrentSolarPanelVoltage;
+  puts("Tower unplugged, move to CoalPowered state \r\n");
+  //1. Play coalplant audio
+  //2. Turn on pollution leds
+  SR_WritePollution(6);
+  //3. turn on energy leds with parameter all
+  SR_WriteEnergy(6);
+  ES_Timer_InitPeriodic(COAL_ACTIVE_TIMER, FIVE_SEC);
+}
 
-  //Get CurrentSolarPanelVoltage from input line
-  CurrentSolarPanelVoltage = ReadSolarPanelPosition();
-  
-  //Analog signal, to be changed accordingly
-  //If the state of the Morse input line has changed
-  if(abs(CurrentSolarPanelVoltage-LastSolarPanelVoltage) >= V_threshold)
-  {
-    puts("Solarpanel position changed by threshold \r\n");
-  	ThisEvent.EventType = ES_SOLARPOS_CHANGE;
-  	PostEnergyProduction(ThisEvent);
-  	AnyEvent.EventType = USERMVT_DETECTED;
-    PostGameManager(AnyEvent);
-    ReturnVal = true;
-    LastSolarPanelVoltage = CurrentSolarPanelVoltage;
-  }
-  
-  return ReturnVal;
+/****************************************************************************
+ Function
+     StartSolarPower
+
+ Parameters
+    ES_Event_t ThisEvent, unused
+
+ Returns
+    Nothing
+
+ Description
+    Tower plugged: low pollution, energy shown from the panel alignment
+ Notes
+
+ Author
+    Sander Tonkens, 10/19/26, 20:00
+****************************************************************************/
+static void StartSolarPower(ES_Event_t ThisEvent)
+{
+  puts("Tower plugged, move to SolarPowered state \r\n");
+  //1. Stop coalplant audio
+  //2. Turn "low" polution leds
+  SR_WritePollution(2);
+  ShowAlignment(ThisEvent);
+  ES_Timer_InitPeriodic(SOLAR_ACTIVE_TIMER, TEN_SEC);
 }
 
 /****************************************************************************
  Function
-     CheckSmokeTowerEvents
+     MoveSun, MoveSunAndAlign
+
  Parameters
-     None
+    ES_Event_t ThisEvent, unused
 
  Returns
-     bool, true if an event is posted
+    Nothing
 
  Description
-     Checks if pin state has changed and posts event if change detected
+    Sun timer: moves the sun one step. On solar
+    power the energy leds then follow the new alignment
  Notes
-   Returns specific event that has occured (pressing or releasing)
+
  Author
-     Sander Tonkens, 11/1/18, 10:20
+    Sander Tonkens, 10/19/26, 20:00
 ****************************************************************************/
-bool CheckSmokeTowerEvents(void)
+static void MoveSun(ES_Event_t ThisEvent)
 {
-  ES_Event_t ThisEvent;
-  ES_Event_t AnyEvent;
-  bool ReturnVal = false;
-  bool CurrentSmokeTowerState;
+  ES_Event_t MoveSunEvent;
 
-  CurrentSmokeTowerState = ReadSmokeTowerIR();
-  
-  //If the CurrentSmokeTowerState is different from the LastSmokeTowerState
-  if(CurrentSmokeTowerState != LastSmokeTowerState)
-  {
-    ReturnVal = true;
-    //If the CurrentSmokeTowerState is down     
-    if (CurrentSmokeTowerState == 0)
-    {
-      ThisEvent.EventType = ES_TOWER_PLUGGED;
-      PostEnergyProduction(ThisEvent);
-      AnyEvent.EventType = USERMVT_DETECTED;
-      PostGameManager(AnyEvent);
-    }
-    else
-    {   
-      ThisEvent.EventType = ES_TOWER_UNPLUGGED;
-      PostEnergyProduction(ThisEvent);
-      AnyEvent.EventType = USERMVT_DETECTED;
-      PostGameManager(AnyEvent);
-    }
-  } 
-  LastSmokeTowerState = CurrentSmokeTowerState;
-  return ReturnVal;
+  MoveSunEvent.EventType = ES_MOVE_SUN;
+  MoveSunEvent.EventParam = 0;
+  PostSunMovement(MoveSunEvent);
 }
 
-//***************************************************************************
+static void MoveSunAndAlign(ES_Event_t ThisEvent)
+{
+  MoveSun(ThisEvent);
+  ShowAlignment(ThisEvent);
+}
 
-//********************************
-// These functions are private to the module
-//********************************
+/****************************************************************************
+ Function
+     ShowAlignment
+
+ Parameters
+    ES_Event_t ThisEvent, unused
+
+ Returns
+    Nothing
+
+ Description
+    Writes the solar panel alignment to the energy leds
+ Notes
+    6 LEDs represent the 3 alignment levels, so *2
+ Author
+    Sander Tonkens, 10/19/26, 20:00
+****************************************************************************/
+static void ShowAlignment(ES_Event_t ThisEvent)
+{
+  SR_WriteEnergy(2 * EvaluateSolarAlignment());
+}
+
+/****************************************************************************
+ Function
+     TempUp, TempDown
+
+ Parameters
+    ES_Event_t ThisEvent, unused
+
+ Returns
+    Nothing
+
+ Description
+    Coal & solar timers: too long on coal turns a temperature led on, enough
+    solar energy turns one off
+ Notes
+    These fire in both powered states, both timers are periodic and keep
+    running until the game is reset
+ Author
+    Sander Tonkens, 10/19/26, 20:00
+****************************************************************************/
+static void TempUp(ES_Event_t ThisEvent)
+{
+  ES_Event_t TemperatureChange;
+
+  TemperatureChange.EventType = CHANGE_TEMP;
+  TemperatureChange.EventParam = 2;
+  puts("Temp up by 1, too long in coal power state\r\n");
+  PostGameManager(TemperatureChange);
+  //to add in: Play "sad" audio tune
+}
+
+static void TempDown(ES_Event_t ThisEvent)
+{
+  ES_Event_t TemperatureChange;
+
+  TemperatureChange.EventType = CHANGE_TEMP;
+  TemperatureChange.EventParam = 1;
+  puts("Temp down by 1, enough solar energy produced\r\n");
+  PostGameManager(TemperatureChange);
+  //to add in: Play "happy" audio tune
+}
+
+/****************************************************************************
+ Function
+     ResetGame
+
+ Parameters
+    ES_Event_t ThisEvent, unused
+
+ Returns
+    Nothing
+
+ Description
+    Game reset: stops the game's periodic timers and sends the sun back to
+    its starting position
+ Notes
+
+ Author
+    Sander Tonkens, 10/19/26, 20:00
+****************************************************************************/
+static void ResetGame(ES_Event_t ThisEvent)
+{
+  ES_Event_t MoveSunEvent;
+
+  ES_Timer_StopTimer(SUN_POSITION_TIMER);
+  ES_Timer_StopTimer(COAL_ACTIVE_TIMER);
+  ES_Timer_StopTimer(SOLAR_ACTIVE_TIMER);
+  //1. Stop playing coalplant audio directly
+  MoveSunEvent.EventType = ES_MOVE_SUN;
+  MoveSunEvent.EventParam = 1;
+  PostSunMovement(MoveSunEvent);
+}
+
+/****************************************************************************
+ Function
+     PanelLeftBand
+
+ Parameters
+    bool WentHigh, true if the panel reading went up
+
+ Returns
+    Nothing
+
+ Description
+    Watch function for the ADC1 comparators, called from their interrupt
+    when the panel reading leaves its band. The band stays disarmed until
+    the run function re-centres it, so one move posts one event
+ Notes
+
+ Author
+    Sander Tonkens, 10/19/26, 23:52
+****************************************************************************/
+static void PanelLeftBand(bool WentHigh)
+{
+  ES_Event_t ThisEvent;
+
+  ThisEvent.EventType = ES_SOLARPOS_CHANGE;
+  ThisEvent.EventParam = WentHigh;
+  PostEnergyProduction(ThisEvent);
+}
 
 /****************************************************************************
  Function
@@ -470,10 +622,10 @@ bool CheckSmokeTowerEvents(void)
     Nothing
 
  Returns
-    uint16_t returns state of solar panel
+    uint32_t returns state of solar panel
 
  Description
-    Returns analog input pin of TIVA
+    Converts the analog input pin of TIVA and returns the value
  Notes
       
  Author
@@ -483,33 +635,36 @@ static uint32_t ReadSolarPanelPosition(void)
 {
   uint32_t SolarPanelPosition[2];
   //Read analog input pin 
-  ADC_MultiRead(SolarPanelPosition); 
+  ADC_MultiRead(SolarPanelPosition);
   //printf("Solar panel position: %d \r\n", SolarPanelPosition[0]);
-  return SolarPanelPosition[0];
+  return SolarPanelPosition[SOLAR_PANEL_CHANNEL];
 }
 
 /****************************************************************************
  Function
-     V_sun
+     ExpectedSunVoltage
 
  Parameters
     Nothing
 
  Returns
-    Nothing
+    int32_t solar panel reading expected when it points at the sun
 
  Description
-    Function is called every time the sun is moved position
+    Interpolates the expected reading from where the sun servo is right now,
+    so it tracks the sun through its moves instead of jumping per step
  Notes
-      
+    between the end stop readings, see SetPanelEndStops
+
  Author
-    Sander Tonkens, 11/1/18, 10:32
+    Sander Tonkens, 10/19/26, 11:00
 ****************************************************************************/
-static void ChangeSunVoltage(void)
+static int32_t ExpectedSunVoltage(void)
 {
-  puts("Varying V_sun \r\n");
-	V_sun = V_sun + V_INCREMENT_FIVE_SEC;
-	return;
+  int32_t Span = (int32_t)Me->PanelAtSunset - Me->PanelAtSunrise;
+
+  return Me->PanelAtSunrise +
+         ((int32_t)QuerySunPosition() * Span) / SUN_ARC_TENTHS;
 }
 
 /****************************************************************************
@@ -534,12 +689,13 @@ static uint8_t EvaluateSolarAlignment(void)
 {
   //puts("Varying V_sun \r\n");
 	uint8_t Alignment_param;
-	uint32_t V_solar = ReadSolarPanelPosition();
-	if(abs(V_sun - V_solar)<V_WELLALIGNED)
+	int32_t V_solar = ReadSolarPanelPosition();
+	int32_t Misalignment = abs(ExpectedSunVoltage() - V_solar);
+	if(Misalignment<V_WELLALIGNED)
 	{
 		Alignment_param = 3;
 	}
-	else if(abs(V_sun - V_solar)<V_MEDIUMALIGNED)
+	else if(Misalignment<V_MEDIUMALIGNED)
 	{
 		Alignment_param = 2;
 	}
@@ -550,35 +706,3 @@ static uint8_t EvaluateSolarAlignment(void)
   printf("Good alignment: %d \r\n", Alignment_param);
 	return Alignment_param;
 }
-
-/****************************************************************************
- Function
-     ReadSmokeTowerIR
-
- Parameters
-    Nothing
-
- Returns
-    bool returns state of SmokeTowerIR
-
- Description
-    Returns bit 3 of the TIVA Port B, which reads state of morse coder
- Notes
-      
- Author
-    Sander Tonkens, 11/1/18, 10:32
-****************************************************************************/
-static bool ReadSmokeTowerIR(void)
-{
-  bool SmokeTowerIRState;
-  //Read digital input pin (as in Morselements)
-  SmokeTowerIRState = HWREG(GPIO_PORT_EP + (GPIO_O_DATA + ALL_BITS)) & TOWER_HI;
-  return SmokeTowerIRState;
-}
-
-
-
-
-
-
-
@@ -16,6 +16,8 @@
  History
  When           Who     What/Why
  -------------- ---     --------
+ 10/21/26 16:00 ston    't' shows the smoke tower's state & last letter
+ 10/21/26 12:00 ston    '[' & ']' measure the solar panel's end stops
  08/06/13 13:36 jec     initial version
 ****************************************************************************/
 
@@ -134,6 +136,22 @@ bool Check4Keystroke(void)
     {
       SR_WriteTemperature(5);
     }
+    // calibration: push the solar panel against its sunrise ('[') or
+    // sunset (']') end stop first
+    else if (Key == '[')
+    {
+      MeasurePanelEndStop(false);
+    }
+    else if (Key == ']')
+    {
+      MeasurePanelEndStop(true);
+    }
+    else if (Key == 't')
+    {
+      printf("Smoke tower %s, last letter '%c'\r\n",
+          QuerySmokeTowerPlugged() ? "plugged" : "unplugged",
+          (QuerySmokeTowerLetter() != '\0') ? QuerySmokeTowerLetter() : ' ');
+    }
     
     else {
       ThisEvent.EventType = USERMVT_DETECTED;
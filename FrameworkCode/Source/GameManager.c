@@ -4,9 +4,7 @@
 * 
 *
 ****************************************************************************************/
-// PORT D
-#define LEAF_DETECTOR_PORT0 BIT6HI
-#define LEAF_DETECTOR_PORT1 BIT7HI
+// the LEAF detector (PD6) is read by the Debounce module
 #define TEMP_LED_NUM 8
 
 #include "GameManager.h"
@@ -29,19 +27,24 @@
 
 
 /****************************** Private Functions & Variables **************************/
-static uint8_t LEAF0LastState;
-static uint8_t LEAF1LastState;
 static uint8_t MyPriority;
-static GameManagerState CurrentState = InitGState;
+
+// everything that belongs to one exhibit, see ES_SERVICE_DATA
+typedef struct {
+    GameManagerState CurrentState;
+    uint8_t Temperature;
+    uint8_t NumOfActiveGames;
+} GameManagerData_t;
+
+static GameManagerData_t MyData;
+#define Me ES_SERVICE_DATA(GameManagerData_t, MyPriority, MyData)
 
 bool InitGameManager(uint8_t Priority) {
-    // initialize ports (already set to input by default)
-    HWREG(GPIO_PORTD_BASE + GPIO_O_DEN) |= (LEAF_DETECTOR_PORT0|LEAF_DETECTOR_PORT1);
-    LEAF0LastState = HWREG(GPIO_PORTD_BASE + GPIO_O_DATA + ALL_BITS) & 
-        LEAF_DETECTOR_PORT0;
-    LEAF1LastState = HWREG(GPIO_PORTD_BASE + GPIO_O_DATA + ALL_BITS) & 
-        LEAF_DETECTOR_PORT1;
+    MyPriority = Priority;
     SR_Init();
+    Me->CurrentState = InitGState;
+    Me->Temperature = TEMP_LED_NUM;
+    Me->NumOfActiveGames = 0;
     ES_Event_t InitEvent;
     InitEvent.EventType = ES_INIT;
     if (ES_PostToService(MyPriority, InitEvent) == true) {
@@ -56,17 +59,14 @@ bool PostGameManager(ES_Event_t ThisEvent) {
 
 ES_Event_t RunGameManager(ES_Event_t ThisEvent) {
 
-    static uint8_t Temperature = TEMP_LED_NUM;
-    static uint8_t NumOfActiveGames = 0;
-    
     ES_Event_t ReturnEvent;
     ReturnEvent.EventType = ES_NO_EVENT;
 
-    switch (CurrentState) {
+    switch (Me->CurrentState) {
         case InitGState:
             if (ThisEvent.EventType == ES_INIT) {
                 puts("GameManager in standby mode.\r\n");
-                CurrentState = Standby;
+                Me->CurrentState = Standby;
             }
             else 
                 puts("Error: did not receive ES_INIT event.\r\n");
@@ -86,9 +86,9 @@ ES_Event_t RunGameManager(ES_Event_t ThisEvent) {
                 Event2Post.EventType = PLAY_WELCOMING_AUDIO;
                 // PostAudioService(Event2Post);
                 // turn on thermometer LEDs
-                SR_WriteTemperature(Temperature);
+                SR_WriteTemperature(Me->Temperature);
                 puts("LEAF inserted correctly. Going into welcome mode.\r\n");
-                CurrentState = WelcomeMode;                
+                Me->CurrentState = WelcomeMode;                
             }
             break;
 
@@ -98,14 +98,14 @@ ES_Event_t RunGameManager(ES_Event_t ThisEvent) {
                 Event2Post.EventType = START_GAME;
                 Event2Post.EventParam = 1;
                 PostEnergyProduction(Event2Post);
-                NumOfActiveGames ++;
+                Me->NumOfActiveGames ++;
                 puts("Starting first game.\r\n");
 
                 // start timers
                 ES_Timer_InitTimer(NEXT_GAME_TIMER, 10000);
                 ES_Timer_InitTimer(USER_INPUT_TIMER, 30000);
                 ES_Timer_InitTimer(GAME_END_TIMER, 60000);
-                CurrentState = GameActive;
+                Me->CurrentState = GameActive;
             }
             else if (ThisEvent.EventType == LEAF_REMOVED) {
                 
@@ -116,7 +116,7 @@ ES_Event_t RunGameManager(ES_Event_t ThisEvent) {
                 ES_Event_t Event2Post;
                 // Event2Post.EventType = STOP_WELCOMING_AUDIO;
                 // PostAudioService(Event2Post);
-                CurrentState = Standby;
+                Me->CurrentState = Standby;
                 puts("LEAF removed; going back to standby.\r\n");
             }
             break;
@@ -124,17 +124,17 @@ ES_Event_t RunGameManager(ES_Event_t ThisEvent) {
         case GameActive:
             if ((ThisEvent.EventType == ES_TIMEOUT) && (ThisEvent.EventParam ==
                 NEXT_GAME_TIMER)) {
-                if (NumOfActiveGames < 3) {
-                    NumOfActiveGames ++;
+                if (Me->NumOfActiveGames < 3) {
+                    Me->NumOfActiveGames ++;
                     ES_Event_t Event2Post;
                     Event2Post.EventType = START_GAME;
-                    if (NumOfActiveGames == 2) {
+                    if (Me->NumOfActiveGames == 2) {
                         ES_Timer_InitTimer(NEXT_GAME_TIMER, 10000);
                         Event2Post.EventParam = 2;
                         PostMeatSwitchDebounce(Event2Post);
                         puts("10s timer expired: starting second game.\r\n");
                     }
-                    else if (NumOfActiveGames == 3) {
+                    else if (Me->NumOfActiveGames == 3) {
                         Event2Post.EventParam = 3;
                         PostVotingGame(Event2Post);
                         puts("10s timer expired: starting third game.\r\n");
@@ -152,7 +152,7 @@ ES_Event_t RunGameManager(ES_Event_t ThisEvent) {
                 Event2Post.EventType = RESET_ALL_GAMES;
                 // post event to distribution list
                 // ES_PostList00(Event2Post);
-                CurrentState = Standby;
+                Me->CurrentState = Standby;
             }
                 
             else if (ThisEvent.EventType == USERMVT_DETECTED) {
@@ -167,6 +167,7 @@ ES_Event_t RunGameManager(ES_Event_t ThisEvent) {
             puts("Error: GameManager entered unknown state.\r\n");
     }
 
+    ES_FlightRecordState(Me->CurrentState);
     return ReturnEvent;
 }
 
@@ -186,51 +187,3 @@ ES_Event_t RunGameManager(ES_Event_t ThisEvent) {
 // }
 
 
-bool CheckLEAFInsertion() {
-    uint8_t LEAF0CurrState = HWREG(GPIO_PORTD_BASE + GPIO_O_DATA + 
-        ALL_BITS) & LEAF_DETECTOR_PORT0;
-    if (LEAF0CurrState != LEAF0LastState) {
-      ES_Event_t Event2Post;  
-      if (LEAF0CurrState)
-          Event2Post.EventType = LEAF_REMOVED;
-      else
-          Event2Post.EventType = LEAF_IN_CORRECT;
-      ES_PostToService(MyPriority, Event2Post);
-      LEAF0LastState = LEAF0CurrState;
-      return true;
-    }
-  
-/*  
-    uint8_t LEAF1CurrState = HWREG(GPIO_PORTD_BASE + GPIO_O_DATA + 
-        ALL_BITS) & LEAF_DETECTOR_PORT1;
-    if ((LEAF0CurrState != LEAF0LastState) || (LEAF1CurrState != LEAF1LastState)) {
-        ES_Event_t Event2Post;
-        if (LEAF0CurrState && LEAF1CurrState) {
-            // background is white
-            Event2Post.EventType = LEAF_IN_INCORRECT;
-        }
-        else if (!LEAF0CurrState && !LEAF1CurrState) {
-            // background is black and leaf is inserted correctly
-            LEAF0LastState = LEAF0CurrState;
-            LEAF1LastState = LEAF1CurrState;
-            Event2Post.EventType = LEAF_IN_CORRECT;
-        }
-        else {
-            if (LEAF0CurrState) {
-                // assuming LEAF_DETECTOR_PORT0 sets the lower threshold
-                puts("Error: something went wrong with LEAF detection.\r\n");
-                return false;
-            }
-            else {
-                // background is gray
-                Event2Post.EventType = LEAF_REMOVED;
-            }
-        }
-        ES_PostToService(MyPriority, Event2Post);
-        LEAF0LastState = LEAF0CurrState;
-        LEAF1LastState = LEAF1LastState;
-        return true;
-      }
-*/
-    return false;
-}
@@ -10,10 +10,16 @@
    state has changed
 
  Notes
+   The microswitch itself is debounced by the Debounce module, which posts
+   DB_MEAT_SWITCH_DOWN/UP here
 
  History
  When           Who     What/Why
  -------------- ---     --------
+ 10/19/26 17:00 ston    module variables moved into a per exhibit struct,
+                        see ES_SERVICE_DATA
+ 10/19/26 12:00 ston    debouncing moved to the Debounce module, dropped the
+                        Debouncing/Ready2Sample states & DEBOUNCE_TIMER
  11/12/18 11:11 ston    First pass
  
 ****************************************************************************/
@@ -46,26 +52,20 @@
 #include "ShiftRegisterWrite.h"
 #include "GameManager.h"
 
-// flexibility defines
-#define GPIO_PORT GPIO_PORTB_BASE //configure B on electrical design
-
-//readability defines
-#define MEAT GPIO_PIN_3
-#define MEAT_HI BIT3HI
-#define MEAT_LO BIT3LO
-
 #define MEAT_TEMPCHANGE 4 //number of pieces of meat to change temperature
 
-static bool ReadMeatSwitchPress(void);
-
 // Private variables
 static uint8_t MyPriority;
-static bool LastSwitchState;
-static MeatSwitchDebounceState CurrentButtonState;
-static MeatGameState GameStatus;
 
-// module level defines
-static uint8_t DebounceTime=250;
+// everything that belongs to one exhibit, see ES_SERVICE_DATA
+typedef struct
+{
+  MeatGameState GameStatus;
+  uint8_t MeatPieces;
+} MeatGameData_t;
+
+static MeatGameData_t MyData;
+#define Me ES_SERVICE_DATA(MeatGameData_t, MyPriority, MyData)
 
 /****************************************************************************
  Function
@@ -77,11 +77,9 @@ static uint8_t DebounceTime=250;
      bool true in case of no errors
 
  Description
-     Takes service's priority number, initializes TIVA and starts debounce
-     timer
+     Takes service's priority number and posts ES_INIT to itself
  Notes
-	 State machine starts in debouncing state, Ready2Sample is the default 
-	 state if no meat switch presses have occured in the recent history
+
  Author
 	 Sander Tonkens, 11/1/18, 10:20
 ****************************************************************************/
@@ -91,15 +89,8 @@ bool InitMeatSwitchDebounce(uint8_t Priority)
 
 	MyPriority = Priority;
 
-   //Set MicroSwitch as digital input
-  HWREG(GPIO_PORT + GPIO_O_DEN) |= (MEAT_HI);
-  HWREG(GPIO_PORT + GPIO_O_DIR) &= (MEAT_LO);
-
-	//Initialize LastSwitchState
-	LastSwitchState = ReadMeatSwitchPress();
-
-	GameStatus = InitMeatGame;
-	//Start debounce timer (timer posts to MeatSwitchDebounceSM when timeout)
+	Me->GameStatus = InitMeatGame;
+  Me->MeatPieces = 0;
   ThisEvent.EventType = ES_INIT;
   PostMeatSwitchDebounce(ThisEvent);
   
@@ -150,14 +141,22 @@ ES_Event_t RunMeatSwitchDebounceSM(ES_Event_t ThisEvent)
 	ES_Event_t ReturnEvent;
   ES_Event_t TemperatureChange;
 	ReturnEvent.EventType = ES_NO_EVENT;
-  static uint8_t MeatPieces = 0;
-	switch(GameStatus)
+
+  //Pulling the meat counts as user activity whether or not the game is on
+  if(ThisEvent.EventType == DB_MEAT_SWITCH_DOWN)
+  {
+    ES_Event_t AnyEvent;
+    AnyEvent.EventType = USERMVT_DETECTED;
+    PostGameManager(AnyEvent);
+  }
+
+	switch(Me->GameStatus)
   {
     case InitMeatGame:
     {
       if(ThisEvent.EventType == ES_INIT)
       {
-        GameStatus = MeatStandBy;
+        Me->GameStatus = MeatStandBy;
       }
     break;
     }
@@ -167,105 +166,26 @@ ES_Event_t RunMeatSwitchDebounceSM(ES_Event_t ThisEvent)
       if((ThisEvent.EventType == START_GAME) && (ThisEvent.EventParam == 2))
       {
         puts("Meat game started \r\n");
-        GameStatus = MeatActive;
-        CurrentButtonState = Ready2Sample;
+        Me->GameStatus = MeatActive;
       }
+    break;
     }
     case(MeatActive):
     {
-      switch(CurrentButtonState)
+      if(ThisEvent.EventType == DB_MEAT_SWITCH_DOWN)
       {
-        case Debouncing:
+        Me->MeatPieces ++;
+        if (Me->MeatPieces % MEAT_TEMPCHANGE == 0)
         {
-          //	If EventType is ES_TIMEOUT & parameter is debounce timer number
-          if((ThisEvent.EventType == ES_TIMEOUT) && (ThisEvent.EventParam == DEBOUNCE_TIMER))
-          {
-            CurrentButtonState = Ready2Sample;
-          }
-          break;
-        }
-        
-        case Ready2Sample:
-        {
-          if(ThisEvent.EventType == DB_MEAT_SWITCH_UP)
-          {
-            ES_Timer_InitTimer(DEBOUNCE_TIMER, DebounceTime); 
-            CurrentButtonState = Debouncing;
-          }
-          else if(ThisEvent.EventType == DB_MEAT_SWITCH_DOWN)
-          {
-            ES_Timer_InitTimer(DEBOUNCE_TIMER, DebounceTime); 
-            CurrentButtonState = Debouncing;
-            MeatPieces ++;
-            if (MeatPieces % MEAT_TEMPCHANGE == 0)
-            {
-              //Turn 1 temperature LED off
-              TemperatureChange.EventType = CHANGE_TEMP;
-              TemperatureChange.EventParam = 1;
-              puts("Temp down by 1, removed enough meat \r\n");
-              PostGameManager(TemperatureChange);
-            }
-          }        
-          break;
+          //Turn 1 temperature LED off
+          TemperatureChange.EventType = CHANGE_TEMP;
+          TemperatureChange.EventParam = 1;
+          puts("Temp down by 1, removed enough meat \r\n");
+          PostGameManager(TemperatureChange);
         }
       }
+    break;
     }
   }
 	return ReturnEvent;
 }
-
-
-/****************************************************************************
- Function
-     CheckMeatSwitchEvents
- Parameters
-     None
-
- Returns
-     bool, true if an event is posted
-
- Description
-     Checks if pin state has changed and posts event if change detected
- Notes
-	 Returns specific event that has occured (pressing or releasing)
- Author
-     Sander Tonkens, 11/1/18, 10:20
-****************************************************************************/
-bool CheckMeatSwitchEvents(void)
-{
-	ES_Event_t ThisEvent;
-	ES_Event_t AnyEvent;
-	bool ReturnVal = false;
-	bool CurrentSwitchState;
-
-	CurrentSwitchState = ReadMeatSwitchPress();
-	
-	//If the CurrentSwitchState is different from the LastSwitchState
-	if(CurrentSwitchState != LastSwitchState)
-	{
-		ReturnVal = true;
-		//If the CurrentSwitchState is down		
-		if (CurrentSwitchState == 0)
-		{
-			ThisEvent.EventType = DB_MEAT_SWITCH_DOWN;
-			PostMeatSwitchDebounce(ThisEvent);
-
-			AnyEvent.EventType = USERMVT_DETECTED;
-  		PostGameManager(AnyEvent);
-		}
-		else
-		{		
-			ThisEvent.EventType = DB_MEAT_SWITCH_UP;
-			PostMeatSwitchDebounce(ThisEvent);
-		}
-	}	
-	LastSwitchState = CurrentSwitchState;
-	return ReturnVal;
-}
-
-static bool ReadMeatSwitchPress(void)
-{
-	bool SwitchState;
-	SwitchState = HWREG(GPIO_PORT + GPIO_O_DATA + ALL_BITS) & MEAT_HI;
-	return SwitchState;
-}
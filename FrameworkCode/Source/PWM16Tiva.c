@@ -7,9 +7,26 @@
  Notes
      Channels 0-7 are implemented using the PWM Module 0 and channels
      8-15 are on PWM Module 1
+     The generators run in globally synchronized mode: new periods, pulse
+     widths and output actions are latched and only take effect at the next
+     counter zero after a PWMSyncUpdate. The single channel functions issue
+     that sync themselves, the Stage/Commit functions batch any number of
+     channels into one sync so they all change in the same PWM period.
+     The PWM clock is system / 16 (2.5MHz at 40MHz), the finest divider that
+     still fits a 20mS servo frame in the 16 bit period. Times in uS and servo
+     angles are converted with scale factors computed at init, so there are
+     no divides in those paths.
  History
  When           Who     What/Why
  -------------- ---     --------
+ 10/21/26       ston    a period that is not longer than the pulse width of
+                        a channel in pulse width mode is now refused
+ 10/20/26       ston    PWM_TIVA_SetPeriod no longer writes the unconfigured
+                        second channel of the last group
+ 10/19/26       ston    PWM clock now /16, added uS period/pulse width and
+                       servo angle functions with precomputed scaling
+ 10/19/26       ston    switched generators to global sync and added the
+                        staged update (BeginUpdate/Stage/Commit) API
  09/05/17       jec     fixed PWM_TIVA_SetPulseWidth to fail if requested PW
                         would be greater than or equal to the period
  06/08/17       jec     Rev 2 of the 16 channel version, now inplementing 0 &
@@ -29,10 +46,20 @@
 #include "driverlib/pin_map.h"
 #include "driverlib/gpio.h"
 #include "driverlib/pwm.h"
+#include "driverlib/interrupt.h"
 
 #include "PWM16Tiva.h"
 
 #define MAX_NUM_CHANNELS 16
+#define MAX_NUM_GROUPS (MAX_NUM_CHANNELS>>1)
+// groups 0-3 are on module 0, 4-7 on module 1
+#define GROUPS_PER_MODULE 4
+#define GroupToModule(_grp_) ((_grp_) / GROUPS_PER_MODULE)
+// PWM clock divider, must match the SYSCTL_PWMDIV_n passed to SysCtlPWMClockSet
+#define PWM_CLOCK_DIV 16
+#define US_PER_SEC 1000000UL
+// fraction bits used by the fixed point scale factors
+#define SCALE_FRAC_BITS 16
 
 
 #define ChannelTo100DCMode(_ch_) (GenTo100DCConst[((_ch_) & 0x00000001)])
@@ -40,6 +67,14 @@
                                          
 static uint32_t ulPeriod[MAX_NUM_CHANNELS>>1];
 static uint8_t  LocalDuty[MAX_NUM_CHANNELS] = {0,0,0,0,0,0,0,0,0,0,0,0,0,0};
+// pulse width in ticks for channels driven by pulse width instead of duty
+static uint16_t LocalPW[MAX_NUM_CHANNELS];
+static uint16_t PWModeChannels;   // bit n set = channel n uses LocalPW
+// PWM clock ticks per uS, Q16
+static uint32_t TicksPerUS_Q16;
+// servo calibration: ticks at 0 degrees and ticks per 0.1 degree (Q16)
+static uint16_t ServoBaseTicks[MAX_NUM_CHANNELS];
+static uint32_t ServoTicksPerTenth_Q16[MAX_NUM_CHANNELS];
 static const uint32_t ChannelToPWMconst[MAX_NUM_CHANNELS]={
                                       PWM_OUT_0,PWM_OUT_1,PWM_OUT_2,PWM_OUT_3,
                                       PWM_OUT_4,PWM_OUT_5,PWM_OUT_6,PWM_OUT_7,
@@ -75,8 +110,24 @@ static const uint32_t Group2GENconst[MAX_NUM_CHANNELS>>1]={
                                     PWM_GEN_0,PWM_GEN_1,PWM_GEN_2,PWM_GEN_3};
 
 
+static const uint32_t Module2Base[2] = {PWM0_BASE, PWM1_BASE};
+
 static int8_t MaxConfiguredChannel = -1; // init to illegal value
 
+// staging area for the batched updates
+static uint8_t  StagedDuty[MAX_NUM_CHANNELS];
+static uint32_t StagedPeriod[MAX_NUM_GROUPS];
+static uint16_t StagedPW[MAX_NUM_CHANNELS];
+static uint16_t StagedChannels;   // bit n set = channel n has a staged duty
+static uint16_t StagedPWChannels; // bit n set = channel n has a staged PW
+static uint8_t  StagedGroups;     // bit n set = group n has a staged period
+
+static uint8_t WriteDuty(uint8_t channel);
+static uint16_t AngleToTicks(uint16_t AngleTenths, uint8_t channel);
+static void SyncGroups(uint8_t GroupMask);
+static bool PeriodFitsPW(uint16_t reqPeriod, uint8_t group,
+                         uint16_t ChannelMask);
+
 
 bool PWM_TIVA_Init(uint8_t HowMany){    
  static   uint8_t i;
@@ -87,11 +138,14 @@ bool PWM_TIVA_Init(uint8_t HowMany){
   }
   MaxConfiguredChannel = HowMany-1; // note how many we have configured
   
-  //Configure PWM Clock to system / 32
-  SysCtlPWMClockSet(SYSCTL_PWMDIV_32);
+  //Configure PWM Clock to system / 16
+  SysCtlPWMClockSet(SYSCTL_PWMDIV_16);
+  // work out the uS to ticks scale once, so the uS functions only multiply
+  TicksPerUS_Q16 = (uint32_t)(((uint64_t)(SysCtlClockGet()/PWM_CLOCK_DIV)
+                                << SCALE_FRAC_BITS) / US_PER_SEC);
 
-  // Calculate the period for 500 Hz including divide by 32 in PWM clock
-  ulPeriod[0] = SysCtlClockGet()/32 / 500; //PWM frequency 500HZ
+  // Calculate the period for 500 Hz including divide by 16 in PWM clock
+  ulPeriod[0] = SysCtlClockGet()/PWM_CLOCK_DIV / 500; //PWM frequency 500HZ
   // set all of the periods the same initially
   for (i=1; i<(sizeof(Group2GENconst)/sizeof(Group2GENconst[0])); i++){
     ulPeriod[i] = ulPeriod[0];
@@ -145,7 +199,8 @@ bool PWM_TIVA_Init(uint8_t HowMany){
     //Configure PWM Options for the generators (1 generator for 2 channels)
     for (i=0; i<HowMany; i+=2){
       PWMGenConfigure(ChannelToPWM_MOD[i], Group2GENconst[i>>1], 
-                      PWM_GEN_MODE_UP_DOWN | PWM_GEN_MODE_NO_SYNC); 
+                      PWM_GEN_MODE_UP_DOWN | PWM_GEN_MODE_SYNC |
+                      PWM_GEN_MODE_GEN_SYNC_GLOBAL); 
     //Set the Period (expressed in clock ticks)
       PWMGenPeriodSet(ChannelToPWM_MOD[i], Group2GENconst[i>>1], ulPeriod[i>>1]);
     }
@@ -244,35 +299,16 @@ bool PWM_TIVA_Init(uint8_t HowMany){
 
 bool PWM_TIVA_SetDuty( uint8_t dutyCycle, uint8_t channel)
 {
-  uint32_t updateVal;
-  
   if (channel > MaxConfiguredChannel)// sanity check, reasonable channel number
     return false;
   if (dutyCycle > 100)               // sanity check, reasonable DC
     return false;
   // update local copy of DC used when changing freq or period
   LocalDuty[channel] = dutyCycle;
-  
-  if (0 == dutyCycle){ // don't try to calculate with 0 DC
-    updateVal = 0;
-  }else{ // reasonable duty cycle number, so calculate new pulse width
-    updateVal = (ulPeriod[channel>>1]*dutyCycle)/100;    
-  }
-  // 100% DC needs to be handled differently to work with the PWM hardware
-  if (100 == dutyCycle)
-  {
-  // To program 100% DC, simply set the action on Zero to set the output to ONE
-    HWREG( ChannelToPWM_MOD[channel]+ChannelToGENOffset[channel] ) = 
-                                     ChannelTo100DCMode(channel);
-
-  }else{
-    // if not 100%, then program normal DC actions
-    HWREG( ChannelToPWM_MOD[channel]+ChannelToGENOffset[channel] ) = 
-                                     ChannelToNormDCMode(channel);
-    // and set the new pulse width based on requested DC
-    PWMPulseWidthSet(ChannelToPWM_MOD[channel], 
-                                        ChannelToPWMconst[channel],updateVal);
-  }
+  PWModeChannels &= ~(1 << channel);
+  WriteDuty(channel);
+  // latch the new pulse width at the next zero of this generator
+  SyncGroups(1 << (channel>>1));
   return true;
 }
 
@@ -282,7 +318,11 @@ bool PWM_TIVA_SetPulseWidth( uint16_t NewPW, uint8_t channel)
     return false;
   // make sure that the requested PW is less than the period before updating 
   if ( NewPW < ulPeriod[channel>>1]){  
-    PWMPulseWidthSet(ChannelToPWM_MOD[channel], ChannelToPWMconst[channel],NewPW); 
+    // remember it so that a period change keeps the same pulse width
+    LocalPW[channel] = NewPW;
+    PWModeChannels |= (1 << channel);
+    WriteDuty(channel);
+    SyncGroups(1 << (channel>>1));
     return true;
   }else{
     return false;
@@ -300,6 +340,8 @@ bool PWM_TIVA_SetPulseWidth( uint16_t NewPW, uint8_t channel)
     group 5 = channels 10 & 11
     group 6 = channels 12 & 13
     group 7 = channels 14 & 15
+    fails if a channel of the group is in pulse width mode with a pulse
+    width that would not be less than the new period
 *****************************************************************************/
 
 bool PWM_TIVA_SetPeriod( uint16_t reqPeriod, uint8_t group)
@@ -307,12 +349,21 @@ bool PWM_TIVA_SetPeriod( uint16_t reqPeriod, uint8_t group)
   if(group > (MaxConfiguredChannel>>1)){  // sanity check
     return false;
   }
+  // same rule as PWM_TIVA_SetPulseWidth, the PW must stay below the period
+  if (!PeriodFitsPW(reqPeriod, group, PWModeChannels)){
+    return false;
+  }
   //Set the Period (expressed in clock ticks)
   ulPeriod[group] = reqPeriod;
   PWMGenPeriodSet(ChannelToPWM_MOD[group<<1], Group2GENconst[group], reqPeriod); 
-  // Set new Duty after period change
-  PWM_TIVA_SetDuty( LocalDuty[group<<1], group<<1);
-  PWM_TIVA_SetDuty( LocalDuty[(group<<1)+1], (group<<1)+1);
+  // Set new Duty after period change, the sync makes period & duty change
+  // together. An odd number of channels leaves the last group's second
+  // channel unconfigured, so only rewrite the ones that were set up
+  WriteDuty(group<<1);
+  if (((group<<1)+1) <= MaxConfiguredChannel){
+    WriteDuty((group<<1)+1);
+  }
+  SyncGroups(1 << group);
   return true;
 }
 
@@ -335,9 +386,314 @@ bool PWM_TIVA_SetFreq( uint16_t reqFreq, uint8_t group)
     return false;
   }
   //Use the Frequency (expressed in Hz) to calculate a new period
-  ulPeriod[group] = SysCtlClockGet()/32 /reqFreq;
-  // apply the new period
-  PWM_TIVA_SetPeriod( ulPeriod[group], group);
+  // and apply it, SetPeriod updates ulPeriod only if the period is legal
+  return PWM_TIVA_SetPeriod( SysCtlClockGet()/PWM_CLOCK_DIV /reqFreq, group);
+}
+
+
+/*****************************************************************************
+  PWM_TIVA_BeginUpdate( void)
+    starts a new batch of staged changes, throwing away anything that was
+    staged but not committed
+*****************************************************************************/
+
+void PWM_TIVA_BeginUpdate( void)
+{
+  StagedChannels = 0;
+  StagedPWChannels = 0;
+  StagedGroups = 0;
+}
+
+/*****************************************************************************
+  PWM_TIVA_StageDuty( uint8_t dutyCycle, uint8_t channel)
+    stages a new duty cycle (0-100%) for a channel, nothing is written to
+    the hardware until PWM_TIVA_CommitUpdate
+*****************************************************************************/
+
+bool PWM_TIVA_StageDuty( uint8_t dutyCycle, uint8_t channel)
+{
+  if (channel > MaxConfiguredChannel)// sanity check, reasonable channel number
+    return false;
+  if (dutyCycle > 100)               // sanity check, reasonable DC
+    return false;
+  StagedDuty[channel] = dutyCycle;
+  StagedChannels |= (1 << channel);
+  StagedPWChannels &= ~(1 << channel);
+  return true;
+}
+
+/*****************************************************************************
+  PWM_TIVA_StagePeriod( uint16_t reqPeriod, uint8_t group)
+    stages a new period, in PWM clock ticks, for a group. The channels of the
+    group keep their duty cycle unless a new one is also staged. Fails if a
+    channel of the group stays in pulse width mode with a pulse width that
+    would not be less than the new period; stage its duty first to take it
+    out of pulse width mode.
+*****************************************************************************/
+
+bool PWM_TIVA_StagePeriod( uint16_t reqPeriod, uint8_t group)
+{
+  if(group > (MaxConfiguredChannel>>1)){  // sanity check
+    return false;
+  }
+  // a channel with a staged duty leaves pulse width mode at the commit
+  if (!PeriodFitsPW(reqPeriod, group, PWModeChannels & ~StagedChannels)){
+    return false;
+  }
+  StagedPeriod[group] = reqPeriod;
+  StagedGroups |= (1 << group);
+  return true;
+}
+
+/*****************************************************************************
+  PWM_TIVA_CommitUpdate( void)
+    writes everything staged since PWM_TIVA_BeginUpdate and latches it with
+    one PWMSyncUpdate per module, so all of the channels change at their
+    next counter zero instead of whenever their own write happens to land.
+    Channels & groups whose staged value matches what is already running
+    are skipped.
+    Returns the number of PWM register writes it took (the cost of the
+    commit), 0 if nothing needed to change.
+*****************************************************************************/
+
+uint8_t PWM_TIVA_CommitUpdate( void)
+{
+  uint8_t group;
+  uint8_t channel;
+  uint8_t Writes = 0;
+  uint8_t TouchedGroups = 0;
+
+  // periods first, since the pulse widths are computed from them
+  for (group = 0; group < MAX_NUM_GROUPS; group++){
+    if ((StagedGroups & (1 << group)) &&
+        (StagedPeriod[group] != ulPeriod[group])){
+      ulPeriod[group] = StagedPeriod[group];
+      PWMGenPeriodSet(ChannelToPWM_MOD[group<<1], Group2GENconst[group],
+                      ulPeriod[group]);
+      Writes++;
+      // a new period means new pulse widths for both channels in the group
+      TouchedGroups |= (1 << group);
+    }
+  }
+  for (channel = 0; channel <= MaxConfiguredChannel; channel++){
+    bool InPWMode = (PWModeChannels & (1 << channel)) != 0;
+    bool DutyChanged = (StagedChannels & (1 << channel)) &&
+                       ((StagedDuty[channel] != LocalDuty[channel]) ||
+                        InPWMode);
+    if (DutyChanged){
+      LocalDuty[channel] = StagedDuty[channel];
+      PWModeChannels &= ~(1 << channel);
+    }else if ((StagedPWChannels & (1 << channel)) &&
+              ((StagedPW[channel] != LocalPW[channel]) || !InPWMode) &&
+              (StagedPW[channel] < ulPeriod[channel>>1])){
+      LocalPW[channel] = StagedPW[channel];
+      PWModeChannels |= (1 << channel);
+      DutyChanged = true;
+    }
+    if (DutyChanged || (TouchedGroups & (1 << (channel>>1)))){
+      Writes += WriteDuty(channel);
+      TouchedGroups |= (1 << (channel>>1));
+    }
+  }
+  if (TouchedGroups != 0){
+    SyncGroups(TouchedGroups);
+    Writes++;
+  }
+  StagedChannels = 0;
+  StagedPWChannels = 0;
+  StagedGroups = 0;
+  return Writes;
+}
+
+/*****************************************************************************
+  PWM_TIVA_SetPeriodUS( uint32_t reqPeriodUS, uint8_t group)
+    sets the requested PWM group's period in uS, e.g. 20000 for a standard
+    50Hz servo frame. Fails if the period does not fit the 16 bit counter
+    (26.2mS at the current PWM clock).
+*****************************************************************************/
+
+bool PWM_TIVA_SetPeriodUS( uint32_t reqPeriodUS, uint8_t group)
+{
+  uint32_t Ticks = (uint32_t)(((uint64_t)reqPeriodUS * TicksPerUS_Q16) >>
+                               SCALE_FRAC_BITS);
+  if (Ticks > UINT16_MAX){
+    return false;
+  }
+  return PWM_TIVA_SetPeriod( (uint16_t)Ticks, group);
+}
+
+/*****************************************************************************
+  PWM_TIVA_SetPulseWidthUS( uint16_t NewPWUS, uint8_t channel)
+    sets a channel's pulse width in uS (0.4uS resolution at the current
+    PWM clock)
+*****************************************************************************/
+
+bool PWM_TIVA_SetPulseWidthUS( uint16_t NewPWUS, uint8_t channel)
+{
+  return PWM_TIVA_SetPulseWidth(
+        (uint16_t)(((uint64_t)NewPWUS * TicksPerUS_Q16) >> SCALE_FRAC_BITS),
+        channel);
+}
+
+/*****************************************************************************
+  PWM_TIVA_SetServoRange( uint8_t channel, uint16_t MinPWUS, uint16_t MaxPWUS,
+                          uint16_t RangeTenths)
+    calibrates a servo channel: MinPWUS is the pulse width at 0 degrees,
+    MaxPWUS the width at RangeTenths (in 0.1 degree units). The divide to
+    get the scale is done here, once, so the angle functions only multiply.
+*****************************************************************************/
+
+bool PWM_TIVA_SetServoRange( uint8_t channel, uint16_t MinPWUS,
+                             uint16_t MaxPWUS, uint16_t RangeTenths)
+{
+  uint32_t MinTicks;
+  uint32_t MaxTicks;
+
+  if ((channel > MaxConfiguredChannel) || (MaxPWUS <= MinPWUS) ||
+      (0 == RangeTenths)){
+    return false;
+  }
+  MinTicks = (uint32_t)(((uint64_t)MinPWUS * TicksPerUS_Q16) >>
+                        SCALE_FRAC_BITS);
+  MaxTicks = (uint32_t)(((uint64_t)MaxPWUS * TicksPerUS_Q16) >>
+                        SCALE_FRAC_BITS);
+  ServoBaseTicks[channel] = (uint16_t)MinTicks;
+  ServoTicksPerTenth_Q16[channel] = (uint32_t)(((uint64_t)(MaxTicks - MinTicks)
+                                     << SCALE_FRAC_BITS) / RangeTenths);
   return true;
 }
 
+/*****************************************************************************
+  PWM_TIVA_SetServoAngle( uint16_t AngleTenths, uint8_t channel)
+    positions a servo calibrated with PWM_TIVA_SetServoRange, angle is in
+    0.1 degree units
+*****************************************************************************/
+
+bool PWM_TIVA_SetServoAngle( uint16_t AngleTenths, uint8_t channel)
+{
+  if (channel > MaxConfiguredChannel){
+    return false;
+  }
+  return PWM_TIVA_SetPulseWidth( AngleToTicks(AngleTenths, channel), channel);
+}
+
+/*****************************************************************************
+  PWM_TIVA_StageServoAngle( uint16_t AngleTenths, uint8_t channel)
+    batched version of PWM_TIVA_SetServoAngle, takes effect at the next
+    PWM_TIVA_CommitUpdate
+*****************************************************************************/
+
+bool PWM_TIVA_StageServoAngle( uint16_t AngleTenths, uint8_t channel)
+{
+  if (channel > MaxConfiguredChannel){
+    return false;
+  }
+  StagedPW[channel] = AngleToTicks(AngleTenths, channel);
+  StagedPWChannels |= (1 << channel);
+  StagedChannels &= ~(1 << channel);
+  return true;
+}
+
+/*****************************************************************************
+  AngleToTicks( uint16_t AngleTenths, uint8_t channel)
+    converts a servo angle to a pulse width in PWM ticks with the channel's
+    precomputed calibration
+*****************************************************************************/
+
+static uint16_t AngleToTicks( uint16_t AngleTenths, uint8_t channel)
+{
+  return (uint16_t)(ServoBaseTicks[channel] +
+      (((uint64_t)AngleTenths * ServoTicksPerTenth_Q16[channel]) >>
+       SCALE_FRAC_BITS));
+}
+
+/*****************************************************************************
+  WriteDuty( uint8_t channel)
+    programs the output actions and compare value for a channel from its
+    LocalPW if it is in pulse width mode, otherwise from its LocalDuty & the
+    group period. Returns the number of register writes.
+    Takes effect at the next sync.
+*****************************************************************************/
+
+static uint8_t WriteDuty( uint8_t channel)
+{
+  uint32_t updateVal;
+  uint8_t dutyCycle = LocalDuty[channel];
+
+  // channels set by pulse width just get their stored width, normal actions
+  if (PWModeChannels & (1 << channel)){
+    HWREG( ChannelToPWM_MOD[channel]+ChannelToGENOffset[channel] ) = 
+                                     ChannelToNormDCMode(channel);
+    PWMPulseWidthSet(ChannelToPWM_MOD[channel], 
+                                  ChannelToPWMconst[channel],LocalPW[channel]);
+    return 2;
+  }
+
+  if (0 == dutyCycle){ // don't try to calculate with 0 DC
+    updateVal = 0;
+  }else{ // reasonable duty cycle number, so calculate new pulse width
+    updateVal = (ulPeriod[channel>>1]*dutyCycle)/100;    
+  }
+  // 100% DC needs to be handled differently to work with the PWM hardware
+  if (100 == dutyCycle)
+  {
+  // To program 100% DC, simply set the action on Zero to set the output to ONE
+    HWREG( ChannelToPWM_MOD[channel]+ChannelToGENOffset[channel] ) = 
+                                     ChannelTo100DCMode(channel);
+    return 1;
+  }else{
+    // if not 100%, then program normal DC actions
+    HWREG( ChannelToPWM_MOD[channel]+ChannelToGENOffset[channel] ) = 
+                                     ChannelToNormDCMode(channel);
+    // and set the new pulse width based on requested DC
+    PWMPulseWidthSet(ChannelToPWM_MOD[channel], 
+                                        ChannelToPWMconst[channel],updateVal);
+    return 2;
+  }
+}
+
+/*****************************************************************************
+  SyncGroups( uint8_t GroupMask)
+    requests the global sync for every group in GroupMask (bit n = group n).
+    The two module writes are done back to back with interrupts off so that
+    they land within the same PWM period.
+*****************************************************************************/
+
+static void SyncGroups( uint8_t GroupMask)
+{
+  uint8_t Module0Gens = GroupMask & 0x0F;
+  uint8_t Module1Gens = (GroupMask >> GROUPS_PER_MODULE) & 0x0F;
+  bool WereIntsDisabled;
+
+  // the PWM_GEN_n_BIT values are simply bit n, one per generator
+  WereIntsDisabled = IntMasterDisable();
+  if (Module0Gens != 0){
+    PWMSyncUpdate(Module2Base[0], Module0Gens);
+  }
+  if (Module1Gens != 0){
+    PWMSyncUpdate(Module2Base[1], Module1Gens);
+  }
+  if (false == WereIntsDisabled){
+    IntMasterEnable();
+  }
+}
+
+/*****************************************************************************
+  PeriodFitsPW( uint16_t reqPeriod, uint8_t group, uint16_t ChannelMask)
+    true if every channel of the group that is in ChannelMask (bit n =
+    channel n) has a LocalPW less than reqPeriod, so the period can be
+    shortened without the output going to 100%
+*****************************************************************************/
+
+static bool PeriodFitsPW( uint16_t reqPeriod, uint8_t group,
+                          uint16_t ChannelMask)
+{
+  uint8_t channel;
+
+  for (channel = (group<<1); channel <= ((group<<1)+1); channel++){
+    if ((ChannelMask & (1 << channel)) && (LocalPW[channel] >= reqPeriod)){
+      return false;
+    }
+  }
+  return true;
+}
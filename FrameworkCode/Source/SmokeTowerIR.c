@@ -0,0 +1,584 @@
+/***************************************************************************
+ Module
+   SmokeTowerIR.c
+
+ Revision
+   1.0.1
+
+ Description
+   This service reads the pulses of the smoke tower's IR Morse LED on PA2,
+   tells EnergyProduction when the tower is plugged in & unplugged and
+   keeps the last Morse letter it sent, for QuerySmokeTowerLetter
+
+ Notes
+   The IR receiver pulls PA2 low while it sees the LED, a mark. Both edges
+   of PA2 interrupt, and the interrupt only stamps the edge with the short
+   timer pool's free running count and puts it in a ring, so the pulse
+   widths are as good as the interrupt latency however busy the other
+   services are. The ring is decoded here: a level that lasts less than
+   IR_GLITCH_US is dropped and its two edges with it, marks are sorted into
+   dots & dashes by length, and a space of IR_LETTER_GAP_US ends a letter.
+   Nothing polls the pin. One pool timer stands in for the edge that has
+   not come yet, to settle a level, end a letter or notice the LED is gone.
+   The tower is plugged in from its first mark until there has been no
+   mark for IR_LOST_US, which spans the gaps between Morse words. A tower
+   whose LED is simply on is plugged in too.
+
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/21/26 16:00 ston    the letters are kept for a query instead of posted,
+                        nothing acted on ES_IR_SYMBOL
+ 10/19/26 23:50 ston    First pass, replaces the debounced PA2 level
+
+****************************************************************************/
+//----------------------------- Include Files -----------------------------*/
+// the common headers for C99 types
+#include <stdint.h>
+#include <stdbool.h>
+
+/* include header files for this service
+*/
+#include "SmokeTowerIR.h"
+
+/* include header files for hardware access
+*/
+#include "inc/hw_memmap.h"
+#include "inc/hw_types.h"
+#include "inc/hw_gpio.h"
+#include "inc/hw_ints.h"
+#include "driverlib/interrupt.h"
+#include "BITDEFS.H"
+
+/* include header files for the framework
+*/
+#include "ES_Configure.h"
+#include "ES_Framework.h"
+#include "ES_ShortTimerPool.h"
+
+/* include header files for the other modules that are referenced
+*/
+#include "EnergyProduction.h"
+
+// module level defines
+#define IR_PORT GPIO_PORTA_BASE
+#define IR_PIN BIT2HI
+
+// pulse timing, a Morse unit of about 100mS
+#define IR_GLITCH_US 2000UL
+#define IR_DASH_MIN_US 200000UL     // marks this long or more are dashes
+#define IR_DASH_MAX_US 600000UL     // longer marks are steady light
+#define IR_LETTER_GAP_US 200000UL
+#define IR_LOST_US 1000000UL        // longer than a 7 unit word gap
+#define IR_MAX_ELEMENTS 5           // digits are the longest letters
+
+// the edge ring, its size must be a power of 2
+#define IR_EDGE_RING_SIZE 32
+#define US_TO_CYCLES(US) ((US) * SHORT_TIMER_POOL_CYCLES_PER_US)
+
+// the symbol of a letter with no elements yet, & of one that went wrong
+#define EMPTY_SYMBOL 1
+#define BAD_SYMBOL 0
+
+typedef struct
+{
+  uint32_t Time;    // ES_ShortTimerPoolNow() at the edge
+  bool IsMark;      // the level PA2 went to
+} IR_Edge_t;
+
+// Private functions
+static void TakeEdge(uint32_t Time, bool IsMark);
+static void SettleLevel(uint32_t EndTime);
+static void CheckTimeouts(uint32_t Now);
+static void StartNextTimeout(uint32_t Now);
+static void EndSymbol(void);
+static void PostToEnergy(ES_EventType_t EventType, uint16_t Param);
+
+static uint8_t MyPriority;
+
+// written by the interrupt
+static IR_Edge_t Edges[IR_EDGE_RING_SIZE];
+static volatile uint8_t EdgeHead;
+static volatile uint8_t EdgeOverruns;
+static volatile bool EdgesPosted;
+// written by the service
+static volatile uint8_t EdgeTail;
+static uint8_t LastOverruns;
+
+// the decoded line
+static bool InMark;             // the settled level
+static uint32_t LevelStart;     // when the settled level began
+static bool HavePending;        // an edge away from InMark is not settled
+static uint32_t PendingTime;
+static uint16_t Symbol;         // the letter so far
+static uint16_t LastSymbol = EMPTY_SYMBOL;   // the last good letter
+static bool Plugged;
+
+// Morse letters by symbol, from 2 (E) up to 63 (0)
+static const char MorseChars[] =
+  "ETIANMSURWDKGOHVF?L?PJBXCYZQ??54?3???2???????16???????7???8?90";
+
+/****************************************************************************
+ Function
+     InitSmokeTowerIR
+ Parameters
+     uint8_t Priority, priority of the service
+
+ Returns
+     bool true in case of no errors
+
+ Description
+     Takes PA2's current level as the tower's state, without posting it, and
+     turns on the PA2 edge interrupt
+ Notes
+     PA2 must already be a GPIO input, see PortFunctionInit, and the short
+     timer pool must be running
+ Author
+     Sander Tonkens, 10/19/26, 23:50
+****************************************************************************/
+bool InitSmokeTowerIR(uint8_t Priority)
+{
+  MyPriority = Priority;
+
+  EdgeHead = 0;
+  EdgeTail = 0;
+  EdgeOverruns = 0;
+  LastOverruns = 0;
+  EdgesPosted = false;
+  HavePending = false;
+  Symbol = EMPTY_SYMBOL;
+  InMark = (HWREG(IR_PORT + (GPIO_O_DATA + ALL_BITS)) & IR_PIN) == 0;
+  Plugged = InMark;
+  LevelStart = ES_ShortTimerPoolNow();
+
+  // interrupt on both edges of PA2
+  HWREG(IR_PORT + GPIO_O_DEN) |= IR_PIN;
+  HWREG(IR_PORT + GPIO_O_DIR) &= ~IR_PIN;
+  HWREG(IR_PORT + GPIO_O_IS) &= ~IR_PIN;
+  HWREG(IR_PORT + GPIO_O_IBE) |= IR_PIN;
+  HWREG(IR_PORT + GPIO_O_ICR) = IR_PIN;
+  HWREG(IR_PORT + GPIO_O_IM) |= IR_PIN;
+#ifdef ES_PREEMPT_THRESHOLD
+  // the edges post to us, so they must be held off by EnterCritical
+  IntPrioritySet(INT_GPIOA_TM4C123, ES_KERNEL_IRQ_PRIORITY);
+#endif
+  IntEnable(INT_GPIOA_TM4C123);
+  return true;
+}
+
+/****************************************************************************
+ Function
+     PostSmokeTowerIR
+ Parameters
+     ES_Event ThisEvent ,the event to post to the queue
+
+ Returns
+     bool false if the Enqueue operation failed, true otherwise
+
+ Description
+     Posts an event to this state machine's queue
+ Notes
+
+ Author
+     Sander Tonkens, 10/19/26, 23:50
+****************************************************************************/
+bool PostSmokeTowerIR(ES_Event_t ThisEvent)
+{
+  return ES_PostToService(MyPriority, ThisEvent);
+}
+
+/****************************************************************************
+ Function
+     RunSmokeTowerIR
+
+Parameters
+   ES_Event_t : the event to process
+
+ Returns
+   ES_Event_t, ES_NO_EVENT if no event
+
+ Description
+     ES_IR_EDGES: decodes every edge in the ring
+     ES_SHORT_TIMEOUT: the time since the last edge has run past a level,
+     letter or plugged in limit
+ Notes
+
+ Author
+     Sander Tonkens, 10/19/26, 23:50
+****************************************************************************/
+ES_Event_t RunSmokeTowerIR(ES_Event_t ThisEvent)
+{
+  ES_Event_t ReturnEvent;
+  ReturnEvent.EventType = ES_NO_EVENT;
+
+  if (ThisEvent.EventType == ES_IR_EDGES)
+  {
+    // cleared first, so an edge from here on posts again
+    EdgesPosted = false;
+    while (EdgeTail != EdgeHead)
+    {
+      TakeEdge(Edges[EdgeTail].Time, Edges[EdgeTail].IsMark);
+      EdgeTail = (EdgeTail + 1) & (IR_EDGE_RING_SIZE - 1);
+    }
+    if (EdgeOverruns != LastOverruns)
+    {
+      // edges were lost, so the letter they were part of is no good
+      LastOverruns = EdgeOverruns;
+      Symbol = BAD_SYMBOL;
+    }
+    StartNextTimeout(ES_ShortTimerPoolNow());
+  }
+  else if ((ThisEvent.EventType == ES_SHORT_TIMEOUT) &&
+           (ThisEvent.EventParam == SMOKE_TOWER_IR_TIMER))
+  {
+    uint32_t Now = ES_ShortTimerPoolNow();
+
+    CheckTimeouts(Now);
+    StartNextTimeout(Now);
+  }
+  return ReturnEvent;
+}
+
+/****************************************************************************
+ Function
+     SmokeTowerIRToChar
+ Parameters
+     uint16_t Symbol, a decoded Morse letter, see SmokeTowerIR.h
+
+ Returns
+     char, the letter or digit, '?' if it is not one
+
+ Description
+     Looks the symbol up in the Morse tree
+ Notes
+
+ Author
+     Sander Tonkens, 10/19/26, 23:50
+****************************************************************************/
+char SmokeTowerIRToChar(uint16_t Symbol)
+{
+  if ((Symbol < 2) || (Symbol >= (sizeof(MorseChars) - 1 + 2)))
+  {
+    return '?';
+  }
+  return MorseChars[Symbol - 2];
+}
+
+/****************************************************************************
+ Function
+     QuerySmokeTowerPlugged
+ Parameters
+     Nothing
+
+ Returns
+     bool, true while the tower is plugged in
+
+ Description
+     Query function
+ Notes
+
+ Author
+     Sander Tonkens, 10/19/26, 23:50
+****************************************************************************/
+bool QuerySmokeTowerPlugged(void)
+{
+  return Plugged;
+}
+
+/****************************************************************************
+ Function
+     QuerySmokeTowerLetter
+ Parameters
+     Nothing
+
+ Returns
+     char, the last letter or digit the tower sent, '?' for one not in the
+     Morse tree, '\0' if none has been read yet
+
+ Description
+     Query function
+ Notes
+
+ Author
+     Sander Tonkens, 10/21/26, 16:00
+****************************************************************************/
+char QuerySmokeTowerLetter(void)
+{
+  if (LastSymbol == EMPTY_SYMBOL)
+  {
+    return '\0';
+  }
+  return SmokeTowerIRToChar(LastSymbol);
+}
+
+/****************************************************************************
+ Function
+     SmokeTowerIRHandler
+ Parameters
+     Nothing
+
+ Returns
+     Nothing
+
+ Description
+     GPIO Port A interrupt: stamps the PA2 edge and puts it in the ring,
+     posting ES_IR_EDGES unless one is already on its way
+ Notes
+     A full ring drops the edge and counts it, the service then throws the
+     letter away and picks the level back up from the next edge
+ Author
+     Sander Tonkens, 10/19/26, 23:50
+****************************************************************************/
+void SmokeTowerIRHandler(void)
+{
+  uint32_t Now = ES_ShortTimerPoolNow();
+  uint8_t Next;
+  ES_Event_t ThisEvent;
+
+  // start by clearing the source of the interrupt
+  HWREG(IR_PORT + GPIO_O_ICR) = IR_PIN;
+
+  Next = (EdgeHead + 1) & (IR_EDGE_RING_SIZE - 1);
+  if (Next == EdgeTail)
+  {
+    EdgeOverruns++;
+  }
+  else
+  {
+    Edges[EdgeHead].Time = Now;
+    Edges[EdgeHead].IsMark =
+      (HWREG(IR_PORT + (GPIO_O_DATA + ALL_BITS)) & IR_PIN) == 0;
+    EdgeHead = Next;
+  }
+  if (!EdgesPosted)
+  {
+    ThisEvent.EventType = ES_IR_EDGES;
+    ThisEvent.EventParam = 0;
+    EdgesPosted = ES_PostToService(MyPriority, ThisEvent);
+  }
+}
+
+/***************************************************************************
+ private functions
+ ***************************************************************************/
+
+/****************************************************************************
+ Function
+     TakeEdge
+ Parameters
+     uint32_t Time, when the edge came
+     bool IsMark, the level it went to
+
+ Returns
+     Nothing
+
+ Description
+     The glitch filter. An edge away from the settled level is held as
+     pending until the level has lasted IR_GLITCH_US, if the line comes
+     back before then both edges are dropped
+ Notes
+     An edge back to the settled level with nothing pending, from a pulse
+     too short for the interrupt to read, is dropped with it
+ Author
+     Sander Tonkens, 10/19/26, 23:50
+****************************************************************************/
+static void TakeEdge(uint32_t Time, bool IsMark)
+{
+  CheckTimeouts(Time);
+  if (HavePending)
+  {
+    // the pending level lasted less than IR_GLITCH_US
+    HavePending = false;
+  }
+  if (IsMark != InMark)
+  {
+    HavePending = true;
+    PendingTime = Time;
+  }
+}
+
+/****************************************************************************
+ Function
+     SettleLevel
+ Parameters
+     uint32_t EndTime, when the settled level ended
+
+ Returns
+     Nothing
+
+ Description
+     Ends the settled level at the pending edge. A mark adds its dot or
+     dash to the letter, a long enough space ends the letter. The first
+     mark after the tower was lost plugs it back in
+ Notes
+
+ Author
+     Sander Tonkens, 10/19/26, 23:50
+****************************************************************************/
+static void SettleLevel(uint32_t EndTime)
+{
+  uint32_t Length = EndTime - LevelStart;
+
+  if (InMark)
+  {
+    if ((Length >= US_TO_CYCLES(IR_DASH_MAX_US)) ||
+        (Symbol >= (1 << IR_MAX_ELEMENTS)))
+    {
+      // steady light or too many elements, not Morse
+      Symbol = BAD_SYMBOL;
+    }
+    else if (Symbol != BAD_SYMBOL)
+    {
+      Symbol = (Symbol << 1) | (Length >= US_TO_CYCLES(IR_DASH_MIN_US));
+    }
+  }
+  else if (Length >= US_TO_CYCLES(IR_LETTER_GAP_US))
+  {
+    EndSymbol();
+  }
+  InMark = !InMark;
+  LevelStart = EndTime;
+  HavePending = false;
+  if (InMark && !Plugged)
+  {
+    Plugged = true;
+    PostToEnergy(ES_TOWER_PLUGGED, 0);
+  }
+}
+
+/****************************************************************************
+ Function
+     CheckTimeouts
+ Parameters
+     uint32_t Now, the free running count to check against
+
+ Returns
+     Nothing
+
+ Description
+     Settles a pending edge that has lasted, then ends the letter or
+     unplugs the tower if the space has run on long enough
+ Notes
+     Runs before each edge as well as on the timeout, so the order of the
+     events is the same whichever comes first
+ Author
+     Sander Tonkens, 10/19/26, 23:50
+****************************************************************************/
+static void CheckTimeouts(uint32_t Now)
+{
+  if (HavePending && ((Now - PendingTime) >= US_TO_CYCLES(IR_GLITCH_US)))
+  {
+    SettleLevel(PendingTime);
+  }
+  if (HavePending || InMark)
+  {
+    return;
+  }
+  if ((Now - LevelStart) >= US_TO_CYCLES(IR_LETTER_GAP_US))
+  {
+    EndSymbol();
+  }
+  if (Plugged && ((Now - LevelStart) >= US_TO_CYCLES(IR_LOST_US)))
+  {
+    Plugged = false;
+    PostToEnergy(ES_TOWER_UNPLUGGED, 0);
+  }
+}
+
+/****************************************************************************
+ Function
+     StartNextTimeout
+ Parameters
+     uint32_t Now, the free running count
+
+ Returns
+     Nothing
+
+ Description
+     Starts the pool timer for the next thing that happens if no edge
+     comes first, or stops it if nothing will
+ Notes
+
+ Author
+     Sander Tonkens, 10/19/26, 23:50
+****************************************************************************/
+static void StartNextTimeout(uint32_t Now)
+{
+  uint32_t Due;
+
+  if (HavePending)
+  {
+    Due = PendingTime + US_TO_CYCLES(IR_GLITCH_US);
+  }
+  else if (!InMark && (Symbol != EMPTY_SYMBOL))
+  {
+    Due = LevelStart + US_TO_CYCLES(IR_LETTER_GAP_US);
+  }
+  else if (!InMark && Plugged)
+  {
+    Due = LevelStart + US_TO_CYCLES(IR_LOST_US);
+  }
+  else
+  {
+    ES_ShortTimerPoolStop(SMOKE_TOWER_IR_TIMER);
+    return;
+  }
+  if ((int32_t)(Due - Now) <= 0)
+  {
+    Due = Now;
+  }
+  ES_ShortTimerPoolStart(SMOKE_TOWER_IR_TIMER, MyPriority,
+                         (Due - Now) / SHORT_TIMER_POOL_CYCLES_PER_US);
+}
+
+/****************************************************************************
+ Function
+     EndSymbol
+ Parameters
+     Nothing
+
+ Returns
+     Nothing
+
+ Description
+     Keeps the letter so far, if there is a good one, and starts the next
+ Notes
+     The game has no use for the letters, so they are not posted, only
+     kept for QuerySmokeTowerLetter
+
+ Author
+     Sander Tonkens, 10/19/26, 23:50
+****************************************************************************/
+static void EndSymbol(void)
+{
+  if ((Symbol != BAD_SYMBOL) && (Symbol != EMPTY_SYMBOL))
+  {
+    LastSymbol = Symbol;
+  }
+  Symbol = EMPTY_SYMBOL;
+}
+
+/****************************************************************************
+ Function
+     PostToEnergy
+ Parameters
+     ES_EventType_t EventType, uint16_t Param, the event to post
+
+ Returns
+     Nothing
+
+ Description
+     Posts one of our events to EnergyProduction
+ Notes
+
+ Author
+     Sander Tonkens, 10/19/26, 23:50
+****************************************************************************/
+static void PostToEnergy(ES_EventType_t EventType, uint16_t Param)
+{
+  ES_Event_t ThisEvent;
+
+  ThisEvent.EventType = EventType;
+  ThisEvent.EventParam = Param;
+  PostEnergyProduction(ThisEvent);
+}
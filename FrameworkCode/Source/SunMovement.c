@@ -9,15 +9,27 @@
    This service regulates the movement of the sun using PWM with servo
 
  Notes
+   Moves are not jumps: each new target is reached along a trapezoidal
+   velocity profile (accelerate, cruise, decelerate) that is stepped every
+   PROFILE_TICK_US on short timer A. The profile runs in Q8 fixed point
+   0.1 degree units, so there is no floating point anywhere, and the short
+   timer interrupt only posts the tick, all of the math runs here.
 
  History
  When           Who     What/Why
  -------------- ---     --------
+ 10/21/26 12:00 ston    the stopping distance is worked out in 64 bits, fast
+                        limits overflowed v^2
+ 10/19/26 17:00 ston    module variables moved into a per exhibit struct,
+                        see ES_SERVICE_DATA
+ 10/19/26 11:00 ston    trapezoidal motion profile on the short timer,
+                        QuerySunPosition for the alignment check
+ 10/19/26 09:30 ston    drive the sun servo by angle through the uS PWM API
  10/23/18 11:11 ston    First pass
- 
+
 ****************************************************************************/
 //----------------------------- Include Files -----------------------------*/
-// the common headers for C99 types 
+// the common headers for C99 types
 #include <stdint.h>
 #include <stdbool.h>
 #include <stdlib.h>
@@ -41,14 +53,48 @@
 
 /* include header files for the other modules that are referenced
 */
+#include "PWM16Tiva.h"
 
 // Private functions
-
+static bool StepProfile(void);
+static void StartMove(uint16_t Target);
 
 // module level defines
-static uint8_t sun_position = 0;
+// sun servo is on PB4, PWM channel 2 (group 1)
+#define SUN_SERVO_CHANNEL 2
+#define SUN_SERVO_GROUP (SUN_SERVO_CHANNEL >> 1)
+#define SERVO_PERIOD_US 20000
+// pulse widths at the two ends of the sun's arc
+#define SUN_MIN_PW_US 1000
+#define SUN_MAX_PW_US 2000
+
+// profile tick, one servo frame, and the ticks in a second
+#define PROFILE_TICK_US SERVO_PERIOD_US
+#define TICKS_PER_SEC (1000000UL / PROFILE_TICK_US)
+// fraction bits of the profile's position & velocity
+#define PROFILE_Q 8
+// default limits, 0.1 degree/S and 0.1 degree/S^2
+#define DEFAULT_MAX_VEL 300
+#define DEFAULT_MAX_ACCEL 600
+
 static uint8_t MyPriority;
 
+// everything that belongs to one exhibit, see ES_SERVICE_DATA
+typedef struct
+{
+  uint8_t sun_position; // steps since sunrise
+  // profile state, all Q8 0.1 degree units, velocity & accel are per tick
+  int32_t PositionQ8;
+  int32_t TargetQ8;
+  int32_t VelocityQ8;
+  int32_t MaxVelQ8;
+  int32_t AccelQ8;
+  bool Moving;
+} SunData_t;
+
+static SunData_t MyData;
+#define Me ES_SERVICE_DATA(SunData_t, MyPriority, MyData)
+
 /****************************************************************************
  Function
      InitSunMovement
@@ -69,9 +115,24 @@ static uint8_t MyPriority;
 
 bool InitSunMovement(uint8_t Priority)
 {
-  
+
   MyPriority = Priority;
-  //Define PWM TIVA output to sun as PWM output
+  // 50Hz servo frame on the sun's group, then calibrate the servo so the
+  // rest of the module only deals in angles
+  if (!PWM_TIVA_SetPeriodUS(SERVO_PERIOD_US, SUN_SERVO_GROUP) ||
+      !PWM_TIVA_SetServoRange(SUN_SERVO_CHANNEL, SUN_MIN_PW_US, SUN_MAX_PW_US,
+                              SUN_ARC_TENTHS)){
+    return false;
+  }
+  // profile ticks come back to us on short timer A
+  ES_ShortTimerInit(MyPriority, SHORT_TIMER_UNUSED);
+  SetSunProfileLimits(DEFAULT_MAX_VEL, DEFAULT_MAX_ACCEL);
+  Me->sun_position = 0;
+  Me->PositionQ8 = 0;
+  Me->TargetQ8 = 0;
+  Me->VelocityQ8 = 0;
+  Me->Moving = false;
+  PWM_TIVA_SetServoAngle(0, SUN_SERVO_CHANNEL); // start at sunrise
 
   return true;
 
@@ -102,7 +163,7 @@ bool PostSunMovement(ES_Event_t ThisEvent)
 /****************************************************************************
  Function
      RunSunMovement
- 
+
 Parameters
    ES_Event_t : the event to process
 
@@ -123,21 +184,227 @@ ES_Event_t RunSunMovement(ES_Event_t ThisEvent)
   //Default return event
   ReturnEvent.EventType = ES_NO_EVENT;
 
-  
+
 
   if(ThisEvent.EventType == ES_MOVE_SUN)
   {
     if(ThisEvent.EventParam == 0) //Move every 5 seconds
     {
-      //Move sun by 1/12th of a day //Connie
-      //Update value of sun position
+      //Move sun by 1/12th of a day, stopping at sunset
+      if (Me->sun_position < SUN_STEPS_PER_DAY)
+      {
+        Me->sun_position++;
+      }
+      StartMove(Me->sun_position * SUN_STEP_TENTHS);
     }
     else if(ThisEvent.EventParam == 1) //Reset all games
     {
-      //Return sun to its initial position //Connie
-      //Use current sun position value as the
+      //Return sun to its initial position
+      Me->sun_position = 0;
+      StartMove(0);
+    }
+  }
+  else if((ThisEvent.EventType == ES_SHORT_TIMEOUT) &&
+          (ThisEvent.EventParam == TIMER_A))
+  {
+    // one profile tick: step, then write the new angle with a single commit
+    bool StillMoving = StepProfile();
+    PWM_TIVA_BeginUpdate();
+    PWM_TIVA_StageServoAngle(QuerySunPosition(), SUN_SERVO_CHANNEL);
+    PWM_TIVA_CommitUpdate();
+    if (StillMoving)
+    {
+      ES_ShortTimerStart(TIMER_A, PROFILE_TICK_US);
+    }
+    else
+    {
+      Me->Moving = false;
     }
   }
   return ReturnEvent;
- 
+
+}
+
+/****************************************************************************
+ Function
+     SetSunProfileLimits
+ Parameters
+     uint16_t MaxVel, top speed in 0.1 degree/S
+     uint16_t MaxAccel, acceleration & deceleration in 0.1 degree/S^2
+
+ Returns
+     Nothing
+
+ Description
+     Sets the limits used by every following move. The divides to get to
+     per tick units are done here, so the tick itself only adds & compares.
+ Notes
+     A move already under way picks the new limits up on its next tick
+ Author
+     Sander Tonkens, 10/19/26, 11:00
+****************************************************************************/
+void SetSunProfileLimits(uint16_t MaxVel, uint16_t MaxAccel)
+{
+  Me->MaxVelQ8 = ((int32_t)MaxVel << PROFILE_Q) / TICKS_PER_SEC;
+  Me->AccelQ8 = ((int32_t)MaxAccel << PROFILE_Q) / (TICKS_PER_SEC * TICKS_PER_SEC);
+  // keep the profile able to move at all with very low limits
+  if (Me->MaxVelQ8 < 1)
+  {
+    Me->MaxVelQ8 = 1;
+  }
+  if (Me->AccelQ8 < 1)
+  {
+    Me->AccelQ8 = 1;
+  }
+}
+
+/****************************************************************************
+ Function
+     SetSunTarget
+ Parameters
+     uint16_t Target, angle to move to in 0.1 degree units
+
+ Returns
+     Nothing
+
+ Description
+     Starts a profiled move to any angle in the sun's arc, for callers that
+     want more than the 1/12th of a day steps of ES_MOVE_SUN
+ Notes
+
+ Author
+     Sander Tonkens, 10/19/26, 11:00
+****************************************************************************/
+void SetSunTarget(uint16_t Target)
+{
+  if (Target > SUN_ARC_TENTHS)
+  {
+    Target = SUN_ARC_TENTHS;
+  }
+  StartMove(Target);
+}
+
+/****************************************************************************
+ Function
+     QuerySunPosition
+ Parameters
+     Nothing
+
+ Returns
+     uint16_t where the sun is right now, in 0.1 degree units from sunrise
+
+ Description
+     Returns the commanded position, which follows the profile tick by tick
+     rather than jumping to the target
+ Notes
+
+ Author
+     Sander Tonkens, 10/19/26, 11:00
+****************************************************************************/
+uint16_t QuerySunPosition(void)
+{
+  return (uint16_t)(Me->PositionQ8 >> PROFILE_Q);
+}
+
+/***************************************************************************
+ private functions
+ ***************************************************************************/
+
+/****************************************************************************
+ Function
+     StartMove
+ Parameters
+     uint16_t Target, angle to move to in 0.1 degree units
+
+ Returns
+     Nothing
+
+ Description
+     Sets a new target and starts the profile ticks if they are not already
+     running. A move in progress simply re-plans toward the new target.
+ Notes
+
+ Author
+     Sander Tonkens, 10/19/26, 11:00
+****************************************************************************/
+static void StartMove(uint16_t Target)
+{
+  Me->TargetQ8 = (int32_t)Target << PROFILE_Q;
+  if (!Me->Moving && (Me->TargetQ8 != Me->PositionQ8))
+  {
+    Me->Moving = true;
+    ES_ShortTimerStart(TIMER_A, PROFILE_TICK_US);
+  }
+}
+
+/****************************************************************************
+ Function
+     StepProfile
+ Parameters
+     Nothing
+
+ Returns
+     bool true while the move is still going, false once at the target
+
+ Description
+     Advances the trapezoidal profile by one tick. While heading toward the
+     target it brakes once the remaining distance is inside the stopping
+     distance v^2/2a, otherwise speeds up to the velocity limit. If the
+     target moved behind us it brakes to a stop first and then turns round.
+ Notes
+     v^2 is done in 64 bits: SetSunProfileLimits takes any uint16_t, and
+     above a MaxVelQ8 of about 46000 the square no longer fits in 32
+
+ Author
+     Sander Tonkens, 10/19/26, 11:00
+****************************************************************************/
+static bool StepProfile(void)
+{
+  int32_t Error = Me->TargetQ8 - Me->PositionQ8;
+  int32_t Distance = abs(Error);
+  int32_t Speed = abs(Me->VelocityQ8);
+  bool Approaching = (Me->VelocityQ8 == 0) || ((Me->VelocityQ8 > 0) == (Error > 0));
+
+  if (Approaching)
+  {
+    int64_t StopDistance = ((int64_t)Speed * Speed) / (2 * Me->AccelQ8);
+
+    if (Distance <= StopDistance)
+    {
+      Speed -= Me->AccelQ8;
+    }
+    else if (Speed < Me->MaxVelQ8)
+    {
+      Speed += Me->AccelQ8;
+    }
+    if (Speed > Me->MaxVelQ8)
+    {
+      Speed = Me->MaxVelQ8;
+    }
+    // never stall short of the target
+    if (Speed < Me->AccelQ8)
+    {
+      Speed = Me->AccelQ8;
+    }
+    // close enough to land on the target this tick
+    if (Speed >= Distance)
+    {
+      Me->PositionQ8 = Me->TargetQ8;
+      Me->VelocityQ8 = 0;
+      return false;
+    }
+    Me->VelocityQ8 = (Error > 0) ? Speed : -Speed;
+  }
+  else
+  {
+    // target is behind us, brake before reversing
+    Speed -= Me->AccelQ8;
+    if (Speed < 0)
+    {
+      Speed = 0;
+    }
+    Me->VelocityQ8 = (Me->VelocityQ8 > 0) ? Speed : -Speed;
+  }
+  Me->PositionQ8 += Me->VelocityQ8;
+  return true;
 }
@@ -21,11 +21,18 @@
 
 static uint8_t MyPriority;
 
-static VotingGameState CurrentState = InitVState;
+// everything that belongs to one exhibit, see ES_SERVICE_DATA
+typedef struct {
+    VotingGameState CurrentState;
+} VotingGameData_t;
+
+static VotingGameData_t MyData;
+#define Me ES_SERVICE_DATA(VotingGameData_t, MyPriority, MyData)
 
 
 bool InitVotingGame(uint8_t Priority) {
     MyPriority = Priority;
+    Me->CurrentState = InitVState;
     // make sure motor is off
     HWREG(GPIO_PORTF_BASE + GPIO_O_DEN) |= MOTOR_OFF;
     HWREG(GPIO_PORTF_BASE + GPIO_O_DIR) |= MOTOR_OFF;
@@ -47,11 +54,11 @@ ES_Event_t RunVotingGame(ES_Event_t ThisEvent) {
     ES_Event_t ReturnEvent;
     ReturnEvent.EventType = ES_NO_EVENT;
 
-    switch(CurrentState) {
+    switch(Me->CurrentState) {
         case InitVState:
             if (ThisEvent.EventType == ES_INIT) {
                 puts("Voting game is in standby mode.\r\n");
-                CurrentState = VStandby;
+                Me->CurrentState = VStandby;
             }
             break;
 
@@ -60,7 +67,7 @@ ES_Event_t RunVotingGame(ES_Event_t ThisEvent) {
                 // drive motor
                 puts("Starting voting game; changing question.\r\n");
                 HWREG(GPIO_PORTF_BASE + GPIO_O_DATA + ALL_BITS) &= MOTOR_ON;                 
-                CurrentState = ChangingQuestion;
+                Me->CurrentState = ChangingQuestion;
             }
             break;
 
@@ -68,7 +75,7 @@ ES_Event_t RunVotingGame(ES_Event_t ThisEvent) {
             if (ThisEvent.EventType == SWITCH_HIT) {
                 HWREG(GPIO_PORTF_BASE + GPIO_O_DATA + ALL_BITS) |= MOTOR_OFF;
                 ES_Timer_InitTimer(VOTE_TIMER, 5000);
-                CurrentState = Waiting4Vote;
+                Me->CurrentState = Waiting4Vote;
                 puts("New question is displayed. Waiting for user to vote.\r\n");
             }
             else if ((ThisEvent.EventType == VOTED_YES) || (ThisEvent.EventType == VOTED_NO)) {
@@ -94,7 +101,7 @@ ES_Event_t RunVotingGame(ES_Event_t ThisEvent) {
                 
                 puts("Changing question.\r\n");
                 HWREG(GPIO_PORTF_BASE + GPIO_O_DATA + ALL_BITS) &= MOTOR_ON;
-                CurrentState = ChangingQuestion;
+                Me->CurrentState = ChangingQuestion;
             }
             // else if user voted NO
             else if (ThisEvent.EventType == VOTED_NO) {
@@ -108,7 +115,7 @@ ES_Event_t RunVotingGame(ES_Event_t ThisEvent) {
                 
                 puts("Changing question.\r\n");
                 HWREG(GPIO_PORTF_BASE + GPIO_O_DATA + ALL_BITS) &= MOTOR_ON;
-                CurrentState = ChangingQuestion;
+                Me->CurrentState = ChangingQuestion;
             }
             break;
     }
@@ -8,6 +8,8 @@
  History
  When           Who     What/Why
  -------------- ---     --------
+ 10/19/26 23:59 ston    dump the flight recorder after a reset
+ 10/19/26 23:58 ston    print the liveness monitor's crash record at start up
  08/21/17 12:53 jec     added this header as part of coding standard and added
                         code to enable as GPIO the port poins that come out of
                         reset locked or in an alternate function.
@@ -36,10 +38,12 @@
 #include "ADMulti.h"
 #include "ES_Framework.h"
 #include "ES_Port.h"
+#include "ES_ShortTimerPool.h"
 #include "termio.h"
 #include "EnablePA25_PB23_PD7_PF0.h"
 
 #include "EnergyProduction.h"
+#include "Debounce.h"
 #include "ShiftRegisterWrite.h"
 #include "BITDEFS.H"
 
@@ -50,6 +54,9 @@
 int main(void)
 {
   ES_Return_t ErrorType;
+#ifdef ES_LIVENESS
+  ES_CrashRecord_t Crash;
+#endif
 
   // Set the clock to run at 40MhZ using the PLL and 16MHz external crystal
   SysCtlClockSet(SYSCTL_SYSDIV_5 | SYSCTL_USE_PLL | SYSCTL_OSC_MAIN
@@ -58,6 +65,19 @@ int main(void)
   clrScrn();
 
   puts("\r Running Events and Services Framework \r\n");
+#ifdef ES_LIVENESS
+  // say why, if the watchdog reset us because a service got stuck
+  if (ES_GetCrashRecord(&Crash))
+  {
+    printf("\r Reset: service %u overran, %u ticks on event %u (param %u)\r\n",
+        Crash.Service, Crash.RunTicks, Crash.Event.EventType,
+        Crash.Event.EventParam);
+  }
+#endif
+#ifdef ES_FLIGHT_RECORDER
+  // what was dispatched before the reset, nothing after a power up
+  ES_FlightRecorderDump();
+#endif
 
   // reprogram the ports that are set as alternate functions or
   // locked coming out of reset. (PA2-5, PB2-3, PD7, PF0)
@@ -75,9 +95,11 @@ int main(void)
   HWREG(SYSCTL_RCGCGPIO) |= BIT1HI; // Port B
   while (!(HWREG(SYSCTL_PRGPIO) & BIT1HI));
   ADC_MultiInit(2); //to be placed in main.c
+  ADC_MultiSetHWAverage(ADC_HW_AVG_8X); //average out noise on the solar panel
   PWM_TIVA_Init(3); //3 servos: PB6=0, PB7=1, PB4=2
-  //PWM_TIVA_SetPeriod( 25000, 1); //To be placed in servo module
-  //PWM_TIVA_SetPulseWidth(1875,2); //To be placed in servo module
+  // servo frame & calibration are set up by the services that own them
+  DB_Init(); // debounced digital inputs, ports must be clocked first
+  ES_ShortTimerPoolInit(); // uS timers & time stamps, shared by the services
   // now initialize the Events and Services Framework and start it running
   ErrorType = ES_Initialize(ES_Timer_RATE_1mS);
   if (ErrorType == Success)
@@ -0,0 +1,10 @@
+@echo off
+rem Before Build step of the Keil project. Runs the queue size check in
+rem EventFlow.py when Python 3 is installed, and skips it with a note when
+rem it is not, so the project builds without Python
+python -c "import sys; sys.exit(sys.version_info < (3,))" >nul 2>nul
+if errorlevel 1 (
+  echo EventFlow: Python 3 not found, queue size check skipped
+  exit /b 0
+)
+python "%~dp0EventFlow.py" %*
@@ -0,0 +1,820 @@
+#!/usr/bin/env python3
+"""
+ Module
+   EventFlow.py
+
+ Description
+   Host side check of the services' queue sizes. Reads ES_Configure.h and
+   the source files of the Keil project, builds the graph of who posts to
+   which service, and works out an upper bound on how many events each
+   service's queue can have to hold. Queues whose SERV_n_QUEUE_SIZE is
+   smaller than the bound are reported as warnings in the compiler's
+   file(line) format, so they show up in the build output. With the
+   urgent & background queue levels configured, each level of each service
+   is bounded and checked against its own size.
+
+ Notes
+   Run from the project directory (where the .uvprojx is), which is what the
+   Before Build step does, through Tools\\EventFlow.bat. Python 3 is not
+   needed to build the project: without it the batch file prints a note
+   and the check is skipped. By hand:  python Tools\\EventFlow.py
+   The bound is for a burst: everything that can happen from one pass of
+   the event checkers or one timer tick until ES_Run has emptied every
+   queue again. Within a burst:
+   - an event checker posts at most once per post site, since the checkers
+     only run when every queue is empty
+   - a framework timer times out at most ceil(burst / period) times, where
+     the period is the shortest one it is started with. A timer only ever
+     started with ES_Timer_InitPeriodic has at most one timeout queued
+   - a short timer, or short timer pool timer, times out once
+   - an interrupt handler, or a function passed to ADC_WatchInit for the
+     comparator interrupt to call, posts at most once per post site
+   - each event a service handles can post once per post site in its run
+     function (and the helpers it calls) to each service. A higher priority
+     producer can run for every event that reaches it before the consumer
+     gets to run, so its arrivals multiply. A lower priority producer only
+     runs while the consumer's queue is empty, so it adds its post sites
+   Posts made from the init functions are checked separately, against the
+   queues at start up. A cycle of posts between services is taken to go
+   round once per burst, like a request and its reply; the cycles are
+   listed so that can be checked by hand.
+   Every post site in a run function counts for every event it handles,
+   although only one branch runs per event, so the bounds are upper bounds
+   and the sites are listed to see where they come from.
+   The parsing is regular expressions on comment stripped code, not a C
+   front end. Posts through a function pointer are attributed to the post
+   functions named in the same file (e.g. Debounce's InputTable). A run
+   function that dispatches an ES_STATE_TABLE reaches every guard and action
+   in its transition list.
+   The level a post goes to is worked out from its event type: the last
+   event constant assigned to an EventType before the post, in the same
+   function. A post through a pointer takes the events named on the same
+   line as the post function (a row of Debounce's InputTable), and a post
+   whose event can not be found takes any event named in its file. A post
+   that may be at more than one level counts at each of them.
+
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/21/26 10:00 ston    bound the urgent & background levels of each queue
+ 10/20/26 15:30 ston    run through EventFlow.bat, so Python is optional
+ 10/19/26 23:52 ston    ADC watch functions are interrupt context
+ 10/19/26 23:50 ston    short timer pool timers, by their start calls
+ 10/19/26 23:00 ston    periodic timers count once
+ 10/19/26 22:00 ston    timers name their service number, TIMERn_SERVICE
+ 10/19/26 20:00 ston    follow the guards & actions of ES_STATE_TABLEs
+ 10/19/26 19:00 ston    first pass
+"""
+
+import argparse
+import math
+import os
+import re
+import sys
+
+INF = float("inf")
+
+CALL_RE = re.compile(r"\b([A-Za-z_]\w*)\s*\(")
+FUNC_RE = re.compile(r"\b([A-Za-z_]\w*)\s*\(([^;{}()]*(?:\([^()]*\)[^;{}()]*)*)\)\s*\{")
+EVENT_TYPE_RE = re.compile(r"\bEventType\s*=\s*(\w+)\s*;")
+DEFINE_RE = re.compile(r"^\s*#\s*define\s+(\w+)(?![\w(])[ \t]*(.*)$", re.M)
+KEYWORDS = {"if", "while", "for", "switch", "return", "sizeof", "else"}
+
+
+# ---------------------------------------------------------------- parsing --
+def strip_comments(text):
+    """Removes comments and #if 0 blocks, keeping the line numbers."""
+    def blank(match):
+        return re.sub(r"[^\n]", " ", match.group(0))
+    text = re.sub(r"/\*.*?\*/", blank, text, flags=re.S)
+    text = re.sub(r"//[^\n]*", blank, text)
+    text = re.sub(r'"(\\.|[^"\\\n])*"', '""', text)
+    lines = text.split("\n")
+    depth = 0
+    for i, line in enumerate(lines):
+        stripped = line.strip()
+        if depth == 0:
+            if re.match(r"#\s*if\s+0\b", stripped):
+                depth = 1
+                lines[i] = ""
+        else:
+            if re.match(r"#\s*if", stripped):
+                depth += 1
+            elif re.match(r"#\s*endif", stripped):
+                depth -= 1
+            lines[i] = ""
+    return "\n".join(lines)
+
+
+def preprocess_config(text):
+    """Evaluates the #if's of ES_Configure.h, returns {name: (value, line)}."""
+    defines = {}
+    stack = []   # (taking, any branch taken)
+    taking = True
+
+    def evaluate(expr):
+        expr = re.sub(r"defined\s*\(\s*(\w+)\s*\)",
+                      lambda m: "1" if m.group(1) in defines else "0", expr)
+        expr = re.sub(r"\b[A-Za-z_]\w*\b",
+                      lambda m: str(to_int(defines.get(m.group(0), ("0",))[0],
+                                           defines) or 0), expr)
+        expr = expr.replace("&&", " and ").replace("||", " or ")
+        expr = re.sub(r"!(?!=)", " not ", expr)
+        try:
+            return bool(eval(expr, {"__builtins__": {}}))
+        except Exception:
+            return False
+
+    lines = text.split("\n")
+    i = 0
+    while i < len(lines):
+        line = lines[i]
+        number = i + 1
+        # join continuation lines
+        while line.endswith("\\") and i + 1 < len(lines):
+            i += 1
+            line = line[:-1] + " " + lines[i]
+        i += 1
+        stripped = line.strip()
+        m = re.match(r"#\s*(\w+)\s*(.*)", stripped)
+        if not m:
+            continue
+        directive, rest = m.group(1), m.group(2).strip()
+        if directive in ("if", "ifdef", "ifndef"):
+            if directive == "ifdef":
+                cond = rest in defines
+            elif directive == "ifndef":
+                cond = rest not in defines
+            else:
+                cond = evaluate(rest)
+            stack.append((taking, taking and cond))
+            taking = taking and cond
+        elif directive == "elif":
+            outer, done = stack[-1]
+            cond = outer and not done and evaluate(rest)
+            stack[-1] = (outer, done or cond)
+            taking = cond
+        elif directive == "else":
+            outer, done = stack[-1]
+            taking = outer and not done
+            stack[-1] = (outer, True)
+        elif directive == "endif":
+            taking = stack.pop()[0]
+        elif directive == "define" and taking:
+            dm = re.match(r"(\w+)(?![\w(])\s*(.*)", rest)
+            if dm:
+                defines[dm.group(1)] = (dm.group(2).strip(), number)
+    return defines
+
+
+def to_int(value, defines=None, depth=0):
+    """Numeric value of a define's text, expanding the defines it uses."""
+    if depth > 8:
+        return None
+
+    def expand(m):
+        name = m.group(0)
+        if defines and name in defines:
+            entry = defines[name]
+            text = entry[0] if isinstance(entry, tuple) else entry
+            number = to_int(text, defines, depth + 1)
+            if number is not None:
+                return str(number)
+        return name
+    text = re.sub(r"\b(0x[0-9a-fA-F]+|\d+)[uUlL]+\b", r"\1", value.strip())
+    text = re.sub(r"\b[A-Za-z_]\w*\b", expand, text)
+    if not text or not re.match(r"^[\s\d()x+\-*/%<>|&a-fA-F]+$", text) or \
+            re.search(r"[a-fA-F]", re.sub(r"0x[0-9a-fA-F]+", "", text)):
+        return None
+    try:
+        return int(eval(text.replace("/", "//"), {"__builtins__": {}}))
+    except Exception:
+        return None
+
+
+def find_functions(text):
+    """Returns {name: (body, start line)} for the function definitions."""
+    functions = {}
+    depth = 0
+    i = 0
+    while i < len(text):
+        c = text[i]
+        if c == "{":
+            if depth == 0:
+                head_start = max(text.rfind(";", 0, i), text.rfind("}", 0, i),
+                                 text.rfind("#", 0, i)) + 1
+                head = text[head_start:i + 1]
+                m = None
+                for m in FUNC_RE.finditer(head):
+                    pass
+                if m and m.group(1) not in KEYWORDS and m.end() == len(head):
+                    end = match_brace(text, i)
+                    line = text.count("\n", 0, i) + 1
+                    functions[m.group(1)] = (text[i + 1:end], line)
+                    i = end + 1
+                    continue
+            depth += 1
+        elif c == "}":
+            depth = max(depth - 1, 0)
+        i += 1
+    return functions
+
+
+def match_brace(text, start):
+    depth = 0
+    for i in range(start, len(text)):
+        if text[i] == "{":
+            depth += 1
+        elif text[i] == "}":
+            depth -= 1
+            if depth == 0:
+                return i
+    return len(text) - 1
+
+
+def split_args(text, start):
+    """The comma separated arguments of the call whose '(' is at start."""
+    depth = 0
+    args = []
+    current = ""
+    for c in text[start:]:
+        if c == "(":
+            depth += 1
+            if depth == 1:
+                continue
+        elif c == ")":
+            depth -= 1
+            if depth == 0:
+                args.append(current.strip())
+                return args
+        elif c == "," and depth == 1:
+            args.append(current.strip())
+            current = ""
+            continue
+        current += c
+    return args
+
+
+# ------------------------------------------------------------------ model --
+class Project:
+    def __init__(self, root):
+        self.root = root
+        config_path = os.path.join(root, "Headers", "ES_Configure.h")
+        with open(config_path, errors="replace") as f:
+            config_text = strip_comments(f.read())
+        self.config = preprocess_config(config_text)
+        self.config_path = config_path
+        self.events = self.event_names(config_text)
+        self.levels = self.queue_levels()
+        self.num_services = self.config_int("NUM_SERVICES")
+        self.services = []
+        for n in range(self.num_services):
+            self.services.append({
+                "index": n,
+                "init": self.config_text("SERV_%d_INIT" % n),
+                "run": self.config_text("SERV_%d_RUN" % n),
+                "size": self.config_int("SERV_%d_QUEUE_SIZE" % n),
+                "size_line": self.config.get("SERV_%d_QUEUE_SIZE" % n,
+                                             ("", 0))[1],
+            })
+        self.header_defines = {}
+        header_dir = os.path.join(root, "Headers")
+        for header in sorted(os.listdir(header_dir)):
+            if header.endswith(".h"):
+                with open(os.path.join(header_dir, header),
+                          errors="replace") as f:
+                    for m in DEFINE_RE.finditer(strip_comments(f.read())):
+                        self.header_defines.setdefault(m.group(1),
+                                                       m.group(2).strip())
+        self.files = {}
+        self.functions = {}     # name -> (file, body, line)
+        for path in self.project_sources():
+            with open(path, errors="replace") as f:
+                text = strip_comments(f.read())
+            defines = {}
+            for m in DEFINE_RE.finditer(text):
+                defines[m.group(1)] = m.group(2).strip()
+            functions = find_functions(text)
+            self.files[path] = {"text": text, "defines": defines,
+                                "functions": functions}
+            for name, (body, line) in functions.items():
+                self.functions.setdefault(name, (path, body, line))
+        self.post_funcs = self.find_post_funcs()
+        for service in self.services:
+            service["name"] = self.service_name(service)
+
+    def config_text(self, name):
+        return self.config.get(name, ("",))[0]
+
+    def config_line(self, name):
+        return self.config.get(name, ("", 0))[1]
+
+    @staticmethod
+    def event_names(config_text):
+        m = re.search(r"typedef\s+enum\s*\{([^}]*)\}\s*ES_EventType_t",
+                      config_text)
+        if not m:
+            return []
+        names = re.findall(r"^\s*(\w+)", m.group(1), re.M)
+        return [n for n in names if n not in ("ES_NO_EVENT", "NUM_ES_EVENTS")]
+
+    def queue_levels(self):
+        """{level: (events, size define)}, highest level first, as
+        ES_Framework.c sets them up from ES_URGENT_EVENT_LIST &
+        ES_BACKGROUND_EVENT_LIST."""
+        normal = {"normal": (None, None)}
+        if "ES_URGENT_EVENT_LIST" not in self.config or \
+                "ES_BACKGROUND_EVENT_LIST" not in self.config:
+            return normal
+        levels = {}
+        for level in ("urgent", "normal", "background"):
+            if level == "normal":
+                levels[level] = (None, None)
+                continue
+            name = level.upper()
+            events = [e.strip() for e in
+                      self.config_text("ES_%s_EVENT_LIST" % name).split(",")
+                      if e.strip()]
+            levels[level] = (set(events), "ES_%s_QUEUE_SIZE" % name)
+        return levels
+
+    def level_of(self, event):
+        for level, (events, _) in self.levels.items():
+            if events is not None and event in events:
+                return level
+        return "normal"
+
+    def levels_of(self, events):
+        return {self.level_of(e) for e in events}
+
+    def file_events(self, path, text=None):
+        """The events named in a file, or on one piece of it, all of
+        them if it names none."""
+        if text is None:
+            text = self.files[path]["text"]
+        named = {e for e in self.events
+                 if re.search(r"\b%s\b" % re.escape(e), text)}
+        return named or set(self.events)
+
+    def site_levels(self, path, body, at):
+        """The queue levels the post at body[at] can go to."""
+        m = None
+        for m in EVENT_TYPE_RE.finditer(body, 0, at):
+            pass
+        if m and m.group(1) in self.events:
+            return {self.level_of(m.group(1))}
+        return self.levels_of(self.file_events(path))
+
+    def config_int(self, name):
+        value = to_int(self.config_text(name), self.config)
+        return value if value is not None else 0
+
+    def project_sources(self):
+        projects = [f for f in os.listdir(self.root) if f.endswith(".uvprojx")]
+        sources = []
+        if projects:
+            with open(os.path.join(self.root, projects[0]),
+                      errors="replace") as f:
+                for m in re.finditer(r"<FilePath>([^<]+\.c)</FilePath>",
+                                     f.read()):
+                    path = m.group(1).replace("\\", "/")
+                    sources.append(os.path.normpath(
+                        os.path.join(self.root, path)))
+        else:
+            source_dir = os.path.join(self.root, "Source")
+            sources = [os.path.join(source_dir, f)
+                       for f in sorted(os.listdir(source_dir))
+                       if f.endswith(".c")]
+        return [s for s in sources if os.path.exists(s)]
+
+    def service_of_file(self, path):
+        functions = self.files[path]["functions"]
+        for service in self.services:
+            if service["init"] in functions or service["run"] in functions:
+                return service["index"]
+        return None
+
+    def find_post_funcs(self):
+        """Maps each service's Post function names to its index."""
+        post_funcs = {}
+        for path, info in self.files.items():
+            owner = self.service_of_file(path)
+            if owner is None:
+                continue
+            for name, (body, _) in info["functions"].items():
+                if re.search(r"\bES_PostToService(LIFO)?\s*\(\s*MyPriority\b",
+                             body) and name != self.services[owner]["init"]:
+                    if name != self.services[owner]["run"]:
+                        post_funcs[name] = owner
+        return post_funcs
+
+    def service_name(self, service):
+        run = service["run"]
+        name = re.sub(r"^Run", "", run)
+        return re.sub(r"SM$", "", name) or run
+
+    # ------------------------------------------------------------ posts --
+    def targets_of(self, name):
+        """The services that a post function (or list) name reaches."""
+        if name in self.post_funcs:
+            return [self.post_funcs[name]]
+        if name == "ES_PostAll":
+            return list(range(self.num_services))
+        m = re.match(r"ES_PostList(\d+)$", name)
+        if m:
+            members = self.config_text("DIST_LIST%d" % int(m.group(1)))
+            targets = []
+            for member in members.split(","):
+                targets += self.targets_of(member.strip())
+            return targets
+        return None
+
+    def direct_posts(self, path, name, body):
+        """[(target, site line, levels)] for the posts made straight from a
+        body."""
+        posts = []
+        owner = self.service_of_file(path)
+        referenced = self.referenced_post_funcs(path)
+        _, line0 = self.files[path]["functions"][name]
+        for m in CALL_RE.finditer(body):
+            callee = m.group(1)
+            line = line0 + body.count("\n", 0, m.start())
+            targets = self.targets_of(callee)
+            if targets is not None and callee != name:
+                levels = self.site_levels(path, body, m.start())
+                posts += [(t, line, levels) for t in targets]
+            elif callee in ("ES_PostToService", "ES_PostToServiceLIFO"):
+                args = split_args(body, m.end() - 1)
+                if args and args[0] == "MyPriority" and owner is not None:
+                    posts.append((owner, line,
+                                  self.site_levels(path, body, m.start())))
+            elif re.search(r"(->|\.)\s*$", body[:m.start()]) or \
+                    re.match(r"p?PostFunc", callee):
+                # a post through a pointer: any post function named here
+                if re.search(r"Post", callee):
+                    posts += [(t, line, levels) for t, levels in referenced]
+        return posts
+
+    def referenced_post_funcs(self, path):
+        """[(service, levels)] for the Post functions named, but not called,
+        in a file, with the levels of the events named on the same line."""
+        targets = []
+        text = self.files[path]["text"]
+        for post, service in self.post_funcs.items():
+            for m in re.finditer(r"\b%s\b(?!\s*\()" % re.escape(post), text):
+                if not re.match(r"\s*\(", text[m.end():]):
+                    before = text[:m.start()].rstrip()
+                    if not re.search(r"\b(bool|define)\s*$", before):
+                        line = text[text.rfind("\n", 0, m.start()) + 1:
+                                    m.start()]
+                        targets.append((service, self.levels_of(
+                            self.file_events(path, line))))
+        return targets
+
+    def reachable(self, root):
+        """Functions called, directly or not, from root (root included)."""
+        seen = []
+        todo = [root]
+        while todo:
+            name = todo.pop()
+            if name in seen or name not in self.functions:
+                continue
+            seen.append(name)
+            path, body, _ = self.functions[name]
+            callees = [m.group(1) for m in CALL_RE.finditer(body)]
+            callees += self.table_functions(path, body)
+            for callee in callees:
+                if callee in self.functions and callee not in seen and \
+                        callee not in self.post_funcs and \
+                        callee not in ("ES_PostToService",
+                                       "ES_PostToServiceLIFO", "ES_PostAll"):
+                    todo.append(callee)
+        return seen
+
+    def table_functions(self, path, body):
+        """Guards & actions of the ES_STATE_TABLEs that a body dispatches."""
+        text = self.files[path]["text"]
+        functions = self.files[path]["functions"]
+        names = []
+        for m in re.finditer(r"\bES_STATE_TABLE\s*\(\s*(\w+)\s*,\s*(\w+)",
+                             text):
+            if not re.search(r"\b%s\b" % m.group(1), body):
+                continue
+            rows = re.search(r"^\s*#\s*define\s+%s\s*\([^)]*\)"
+                             r"((?:.*\\\n)*.*)$" % m.group(2), text, re.M)
+            if rows:
+                names += [n for n in re.findall(r"\b\w+\b", rows.group(1))
+                          if n in functions]
+        return names
+
+    def context_posts(self, root):
+        """{target: [(site line, levels)]} for everything reachable from
+        root."""
+        posts = {}
+        for name in self.reachable(root):
+            path, body, _ = self.functions[name]
+            for target, line, levels in self.direct_posts(path, name, body):
+                posts.setdefault(target, []).append(
+                    ("%s(%d)" % (os.path.basename(path), line), levels))
+        return posts
+
+    # ----------------------------------------------------------- timers --
+    def framework_timers(self):
+        """[(timer name, number, service, shortest period, periodic)]"""
+        numbers = {}
+        pool_names = set()
+        for info in self.files.values():
+            for m in re.finditer(r"\bES_ShortTimerPoolStart\s*\(",
+                                 info["text"]):
+                pool_names.update(split_args(info["text"], m.end() - 1)[:1])
+        for name, (value, _) in self.config.items():
+            if name.endswith("_TIMER") and name not in pool_names:
+                number = to_int(value, self.config)
+                if number is not None:
+                    numbers[number] = name
+        periods = {}
+        one_shot = set()
+        for path, info in self.files.items():
+            for m in re.finditer(r"\bES_Timer_Init(Timer|Periodic)\s*\(",
+                                 info["text"]):
+                args = split_args(info["text"], m.end() - 1)
+                if len(args) != 2:
+                    continue
+                number = to_int(args[0], self.config)
+                period = to_int(args[1], dict(self.header_defines,
+                                              **info["defines"]))
+                if number is None:
+                    continue
+                if period is None:
+                    period = 1
+                periods[number] = min(periods.get(number, period), period)
+                if m.group(1) == "Timer":
+                    one_shot.add(number)
+        timers = []
+        for number in range(16):
+            service = to_int(self.config_text("TIMER%d_SERVICE" % number),
+                             self.config)
+            if service is None or service >= self.num_services:
+                continue
+            timers.append((numbers.get(number, "timer %d" % number), number,
+                           service, periods.get(number),
+                           number in periods and number not in one_shot))
+        return timers
+
+    def short_timers(self):
+        """[(short timer name, service)] from the ES_ShortTimerInit and
+        ES_ShortTimerPoolStart calls."""
+        timers = []
+        for path, info in self.files.items():
+            owner = self.service_of_file(path)
+
+            def service_of(arg):
+                if arg == "MyPriority":
+                    return owner
+                number = to_int(arg, self.config)
+                if number is not None and number < self.num_services:
+                    return number
+                return None
+
+            for m in re.finditer(r"\bES_ShortTimerInit\s*\(", info["text"]):
+                args = split_args(info["text"], m.end() - 1)
+                for which, arg in zip(("short timer A", "short timer B"), args):
+                    if service_of(arg) is not None:
+                        timers.append((which, service_of(arg)))
+            for m in re.finditer(r"\bES_ShortTimerPoolStart\s*\(",
+                                 info["text"]):
+                args = split_args(info["text"], m.end() - 1)
+                if len(args) != 3 or service_of(args[1]) is None:
+                    continue
+                timer = ("pool timer %s" % args[0], service_of(args[1]))
+                if timer not in timers:
+                    timers.append(timer)
+        return timers
+
+    def checkers(self):
+        names = [n.strip() for n in
+                 self.config_text("EVENT_CHECK_LIST").split(",") if n.strip()]
+        periods = [to_int(p, self.config) or 0 for p in
+                   self.config_text("EVENT_CHECK_PERIODS").split(",")
+                   if p.strip()]
+        handlers = re.findall(r"\{[^{}]*,\s*(\w+)\s*\}",
+                              self.config_text("INPUT_SCAN_HANDLER_LIST"))
+        result = []
+        for i, name in enumerate(names):
+            result.append((name, periods[i] if i < len(periods) else 0))
+        for name in sorted(set(handlers)):
+            result.append((name, 0))
+        return result
+
+    def interrupt_handlers(self):
+        handlers = []
+        startup = os.path.join(self.root, "StartUp")
+        if not os.path.isdir(startup):
+            return handlers
+        for f in os.listdir(startup):
+            if f.lower().endswith(".s"):
+                with open(os.path.join(startup, f), errors="replace") as s:
+                    for m in re.finditer(r"^\s*DCD\s+(\w+)", s.read(), re.M):
+                        name = m.group(1)
+                        if name in self.functions and name not in handlers:
+                            handlers.append(name)
+        # functions the ADC watch interrupt calls through its pointer
+        for info in self.files.values():
+            for m in re.finditer(r"\bADC_WatchInit\s*\(", info["text"]):
+                args = split_args(info["text"], m.end() - 1)
+                if (len(args) == 3 and args[2] in self.functions and
+                        args[2] not in handlers):
+                    handlers.append(args[2])
+        return handlers
+
+
+# ----------------------------------------------------------------- bounds --
+def compute_bounds(project, burst_ticks):
+    n = project.num_services
+    levels = list(project.levels)
+    # per event handled by service p, posts to each service, then the posts
+    # from the checkers, timers & interrupts per burst, and from the inits.
+    # Every post counts in "all", and at each level it may go to
+    tables = levels + ["all"]
+    sites = {l: [[0] * n for _ in range(n)] for l in tables}
+    external = {l: [0] * n for l in tables}
+    startup = {l: [0] * n for l in tables}
+    edges = []
+
+    def count(rows, target, posts):
+        for _, site_levels in posts:
+            for level in set(site_levels) | {"all"}:
+                rows[level][target] += 1
+
+    def shown(posts):
+        return [where + level_note(project, site_levels)
+                for where, site_levels in posts]
+
+    for p, service in enumerate(project.services):
+        for target, posts in project.context_posts(service["run"]).items():
+            count({l: sites[l][p] for l in tables}, target, posts)
+            edges.append((service["name"], target, len(posts), "run",
+                          shown(posts)))
+
+    for name, period in project.checkers():
+        for target, posts in project.context_posts(name).items():
+            count(external, target, posts)
+            edges.append((name, target, len(posts),
+                          "checker, every %d ticks" % period if period
+                          else "checker, every pass", shown(posts)))
+    timeout_level = {project.level_of("ES_TIMEOUT")}
+    for name, number, target, period, periodic in project.framework_timers():
+        if periodic:
+            # a periodic timer never has more than one timeout queued
+            times = 1
+            kind = "periodic timer, every %s ticks" % period
+        else:
+            times = math.ceil(burst_ticks / period) if period else 1
+            kind = "timer, shortest %s ticks" % (period or "?")
+        count(external, target, [(None, timeout_level)] * times)
+        edges.append((name, target, times,
+                      kind + level_note(project, timeout_level), []))
+    short_level = {project.level_of("ES_SHORT_TIMEOUT")}
+    for name, target in project.short_timers():
+        count(external, target, [(None, short_level)])
+        edges.append((name, target, 1,
+                      "short timer" + level_note(project, short_level), []))
+    for handler in project.interrupt_handlers():
+        for target, posts in project.context_posts(handler).items():
+            count(external, target, posts)
+            edges.append((handler, target, len(posts), "interrupt",
+                          shown(posts)))
+
+    for service in project.services:
+        for target, posts in project.context_posts(service["init"]).items():
+            count(startup, target, posts)
+
+    # arrivals into each service in a burst, whatever their level. Going
+    # round a cycle of posts is taken to happen once per burst, as for a
+    # request & its reply, so the way back into the cycle adds nothing; the
+    # cycles are listed
+    arrivals = {}
+    cycles = []
+
+    def arrivals_of(s, visiting):
+        if s in arrivals:
+            return arrivals[s]
+        if s in visiting:
+            cycle = tuple(sorted(visiting))
+            if cycle not in cycles:
+                cycles.append(cycle)
+            return 0
+        visiting = visiting | {s}
+        total = external["all"][s]
+        for p in range(n):
+            if sites["all"][p][s]:
+                total += sites["all"][p][s] * arrivals_of(p, visiting)
+        arrivals[s] = total
+        return total
+
+    # a producer runs for every event that reaches it, whatever its level,
+    # so its arrivals multiply the posts it makes to one level
+    bounds = {}
+    for level in levels:
+        bounds[level] = []
+        for c in range(n):
+            bound = external[level][c]
+            for p in range(n):
+                if not sites[level][p][c]:
+                    continue
+                if p > c or p == c:
+                    bound += sites[level][p][c] * arrivals_of(
+                        p, frozenset([c]) if p != c else frozenset())
+                else:
+                    bound += sites[level][p][c]
+            bounds[level].append(bound)
+    return bounds, startup, edges, cycles
+
+
+def level_note(project, site_levels):
+    """Names the levels of a post in the listing, unless it is normal."""
+    if len(project.levels) == 1 or set(site_levels) == {"normal"}:
+        return ""
+    return " " + "/".join(l for l in project.levels if l in site_levels)
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="event flow graph & queue bounds for the ES services")
+    parser.add_argument("--root", default=".",
+                        help="project directory, with Headers & Source")
+    parser.add_argument("--burst-ticks", type=int, default=1,
+                        help="how many timer ticks a burst may span")
+    parser.add_argument("--strict", action="store_true",
+                        help="exit with an error if a queue can overflow")
+    args = parser.parse_args()
+
+    project = Project(os.path.abspath(args.root))
+    bounds, startup, edges, cycles = compute_bounds(project,
+                                                    max(args.burst_ticks, 1))
+    names = [s["name"] for s in project.services]
+
+    print("Event flow (producer -> service: posts per burst or per event)")
+    for producer, target, count, kind, where in edges:
+        print("  %-24s -> %-20s x%-3d %s%s" % (
+            producer, names[target], count, kind,
+            ("  [" + ", ".join(where) + "]") if where else ""))
+
+    for cycle in cycles:
+        print("  cycle, counted once per burst: " +
+              " -> ".join(names[c] for c in cycle))
+
+    # the size of each level's queue, and the define that sets it
+    def size_of(service, level):
+        if level == "normal":
+            return (service["size"], "SERV_%d_QUEUE_SIZE" % service["index"],
+                    service["size_line"])
+        define = project.levels[level][1]
+        return (project.config_int(define), define,
+                project.config_line(define))
+
+    others = [l for l in project.levels if l != "normal"]
+    print("")
+    print("Queue bounds" + (", other levels as bound/size" if others else ""))
+    print("  %-4s %-20s %5s %7s %8s" % ("Prio", "Service", "Size", "Bound",
+                                        "Startup") +
+          "".join(" %10s" % l.capitalize() for l in others))
+    overflow = False
+    warnings = []
+    config_name = os.path.relpath(project.config_path, os.getcwd())
+    for service in project.services:
+        c = service["index"]
+        flag = ""
+        for level in project.levels:
+            size, define, line = size_of(service, level)
+            bound = bounds[level][c]
+            start = startup[level][c]
+            which = "" if level == "normal" else level + " "
+            if bound > size:
+                warnings.append(
+                    "%s(%d): warning: %s %squeue can have to hold %s events, "
+                    "%s is %d" % (config_name, line, service["name"], which,
+                                  "unbounded" if bound == INF else int(bound),
+                                  define, size))
+            if start > size:
+                warnings.append(
+                    "%s(%d): warning: the init functions post %d %sevents "
+                    "to %s, %s is %d" % (config_name, line, start, which,
+                                         service["name"], define, size))
+            if bound > size or start > size:
+                flag = "  can overflow"
+                overflow = True
+        print("  %-4d %-20s %5d %7s %8d" % (
+            c, service["name"], service["size"],
+            "unbounded" if bounds["normal"][c] == INF
+            else int(bounds["normal"][c]), startup["normal"][c]) +
+              "".join(" %10s" % ("%s/%d" % (
+                  "inf" if bounds[l][c] == INF else int(bounds[l][c]),
+                  size_of(service, l)[0])) for l in others) + flag)
+    for warning in warnings:
+        print(warning)
+    return 1 if (overflow and args.strict) else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,131 @@
+#!/usr/bin/env python3
+"""
+ Module
+   FlightLog.py
+
+ Description
+   Host side reader for the flight recorder. Takes a capture of the
+   terminal output with an ES_FlightRecorderDump in it, and lists the
+   dispatches of the last dump with the service and event names from
+   ES_Configure.h, the time since the dispatch before it and the state the
+   service was left in.
+
+ Notes
+   Run from the project directory (where the .uvprojx is):
+     python Tools\\FlightLog.py capture.txt
+   or pipe the capture in on stdin. --service limits the list to one
+   service, by number or name. A dump is the lines between "FLIGHT total"
+   and "END", one record per line:  service event param tick state error.
+   The ticks are the 16 bit tick count, so the gaps are taken modulo 65536.
+   States are the numbers of each service's own state enum, a '-' is a
+   service that does not report its state.
+
+ History
+ When           Who     What/Why
+ -------------- ---     --------
+ 10/19/26 23:59 ston    first pass
+"""
+
+import argparse
+import os
+import re
+import sys
+
+from EventFlow import preprocess_config, strip_comments
+
+RECORD_RESET = 0xFF
+NO_STATE = 0xFF
+
+
+def read_names(root):
+    """Service names by number and event names by value, from the config."""
+    with open(os.path.join(root, "Headers", "ES_Configure.h"),
+              errors="replace") as f:
+        raw = f.read()
+    text = strip_comments(raw)
+    # strip_comments blanks the strings, the header names need them
+    config = preprocess_config(re.sub(r"//[^\n]*", "",
+                                      re.sub(r"/\*.*?\*/", "", raw,
+                                             flags=re.S)))
+    services = []
+    for n in range(int(config["NUM_SERVICES"][0])):
+        header = config.get("SERV_%d_HEADER" % n, ('"?"',))[0]
+        services.append(os.path.splitext(header.strip('"'))[0])
+    body = re.search(r"typedef\s+enum\s*\{(.*?)\}\s*ES_EventType_t", text,
+                     re.S).group(1)
+    events = []
+    for entry in body.split(","):
+        name = entry.split("=")[0].strip()
+        if name:
+            events.append(name)
+    return services, events
+
+
+def last_dump(lines):
+    """The records of the last complete dump in the capture."""
+    records = None
+    current = None
+    for line in lines:
+        line = line.strip()
+        if line.startswith("FLIGHT"):
+            current = []
+        elif line == "END" and current is not None:
+            records = current
+            current = None
+        elif current is not None:
+            fields = line.split()
+            if len(fields) == 6 and all(f.isdigit() for f in fields):
+                current.append([int(f) for f in fields])
+    return records
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="list a flight recorder dump with names")
+    parser.add_argument("capture", nargs="?",
+                        help="terminal capture, stdin if left out")
+    parser.add_argument("--root", default=".",
+                        help="project directory, with Headers & Source")
+    parser.add_argument("--service",
+                        help="only this service, by number or name")
+    args = parser.parse_args()
+
+    services, events = read_names(os.path.abspath(args.root))
+    if args.capture:
+        with open(args.capture, errors="replace") as f:
+            records = last_dump(f)
+    else:
+        records = last_dump(sys.stdin)
+    if records is None:
+        print("no flight recorder dump found")
+        return 1
+
+    only = None
+    if args.service is not None:
+        only = (int(args.service) if args.service.isdigit()
+                else services.index(args.service))
+
+    print("%5s %6s  %-20s %-22s %6s %5s" % ("#", "+ticks", "Service",
+                                            "Event", "Param", "State"))
+    last_tick = None
+    for number, (service, event, param, tick, state, error) in \
+            enumerate(records):
+        gap = "" if last_tick is None else str((tick - last_tick) % 65536)
+        last_tick = tick
+        if service == RECORD_RESET:
+            print("%5d %6s  ---- reset ----" % (number, gap))
+            last_tick = None
+            continue
+        if only is not None and service != only:
+            continue
+        print("%5d %6s  %-20s %-22s %6d %5s%s" % (
+            number, gap,
+            services[service] if service < len(services) else str(service),
+            events[event] if event < len(events) else str(event),
+            param, "-" if state == NO_STATE else str(state),
+            "  run function returned an error" if error else ""))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())